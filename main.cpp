@@ -20,10 +20,28 @@
 #include <QString>
 #include <QQuickView>
 #include <QQmlContext>
+#include <QQmlEngine>
 #include "twitchstreamfetcher.h"
 #include "src/auth/twitchauthmanager.h"
 #include "src/api/twitchhelixapi.h"
+#include "src/api/followedlivepoller.h"
+#include "src/api/eventsubclient.h"
+#include "src/api/helixlookupaggregator.h"
+#include "src/api/viewercountrefresher.h"
+#include "src/api/searchcontroller.h"
+#include "src/api/idleprefetcher.h"
 #include "src/network/networkmanager.h"
+#include "src/core/applifecycle.h"
+#include "src/player/vodplayer.h"
+#include "src/player/timeshiftplayer.h"
+#include "src/recording/streamrecorder.h"
+#include "src/models/streamlistmodel.h"
+#include "src/models/categorylistmodel.h"
+#include "src/models/entitystore.h"
+#include "src/models/searchfiltermodel.h"
+#include "src/images/thumbnailcache.h"
+#include "src/images/thumbnailprovider.h"
+#include "src/images/thumbnailscheduler.h"
 #include "src/core/logging.h"
 
 int main(int argc, char *argv[])
@@ -33,9 +51,16 @@ int main(int argc, char *argv[])
 
     LOG_APP("Application starting");
 
+    // Typed API results are passed through QML signal handlers
+    qRegisterMetaType<QVector<StreamInfo>>("QVector<StreamInfo>");
+    qRegisterMetaType<QVector<CategoryInfo>>("QVector<CategoryInfo>");
+
     // Create network manager
     NetworkManager *networkManager = new NetworkManager(app);
 
+    // Track foreground/background for audio-only mode
+    AppLifecycle *appLifecycle = new AppLifecycle(app);
+
     // Create auth manager
     TwitchAuthManager *authManager = new TwitchAuthManager(app);
     authManager->setNetworkManager(networkManager);
@@ -45,38 +70,207 @@ int main(int argc, char *argv[])
     streamFetcher->setAuthManager(authManager);
     streamFetcher->setNetworkManager(networkManager);
 
+    // VOD playback with segment-indexed seeking
+    VodPlayer *vodPlayer = new VodPlayer(app);
+
+    // Live playback with pause/rewind buffer
+    TimeshiftPlayer *timeshiftPlayer = new TimeshiftPlayer(app);
+
+    // Recorder resolves channels through its own fetcher so it doesn't
+    // replace the player's quality list
+    TwitchStreamFetcher *recorderFetcher = new TwitchStreamFetcher(app);
+    recorderFetcher->setAuthManager(authManager);
+    recorderFetcher->setNetworkManager(networkManager);
+
+    QObject::connect(streamFetcher, &TwitchStreamFetcher::graphQLTokenChanged,
+        [streamFetcher, recorderFetcher]() {
+            if (streamFetcher->hasGraphQLToken()) {
+                recorderFetcher->setGraphQLToken(streamFetcher->getGraphQLToken());
+            } else if (recorderFetcher->hasGraphQLToken()) {
+                recorderFetcher->clearGraphQLToken();
+            }
+        });
+
+    StreamRecorder *streamRecorder = new StreamRecorder(app);
+    streamRecorder->setStreamFetcher(recorderFetcher);
+
+    // Single user/stream lookups, sent 100 to a request
+    HelixLookupAggregator *helixLookup = new HelixLookupAggregator(app);
+    helixLookup->setNetworkManager(networkManager);
+
     // Create Helix API
     TwitchHelixAPI *helixApi = new TwitchHelixAPI(app);
     helixApi->setNetworkManager(networkManager);
+    helixApi->setLookupAggregator(helixLookup);
+
+    // Watches followed channels for go-live/offline in the background
+    FollowedLivePoller *livePoller = new FollowedLivePoller(appLifecycle, app);
+    livePoller->setNetworkManager(networkManager);
+
+    // Push notifications for the same channels; the poller is the fallback
+    EventSubClient *eventSub = new EventSubClient(helixLookup, app);
+    QObject::connect(livePoller, &FollowedLivePoller::channelsChanged,
+                     eventSub, &EventSubClient::setChannels);
+    QObject::connect(eventSub, &EventSubClient::activeChanged,
+                     livePoller, &FollowedLivePoller::setPushActive);
+
+    // Channel/category search as you type
+    SearchController *searchController = new SearchController(appLifecycle, app);
+    searchController->setNetworkManager(networkManager);
+
+    // One store behind all browse list models (see below)
+    EntityStore *entityStore = new EntityStore(app);
+
+    // Keeps the viewer counts of the rows on screen current
+    ViewerCountRefresher *viewerCountRefresher = new ViewerCountRefresher(entityStore, appLifecycle, app);
+    viewerCountRefresher->setNetworkManager(networkManager);
+
+    // Stream previews and box art, cached across page visits and restarts
+    ThumbnailCache *thumbnailCache = new ThumbnailCache(app);
+
+    // Holds image loads back while the lists are being flung
+    ThumbnailScheduler *thumbnailScheduler = new ThumbnailScheduler(thumbnailCache, appLifecycle, app);
+
+    // First stream page of the top categories, fetched while the UI is idle
+    IdlePrefetcher *idlePrefetcher = new IdlePrefetcher(appLifecycle, thumbnailScheduler, app);
+    idlePrefetcher->setNetworkManager(networkManager);
 
-    // Sync OAuth token to Helix API
-    QObject::connect(authManager, &TwitchAuthManager::authenticationChanged,
-        [helixApi, authManager](bool authenticated) {
-            if (authenticated) {
-                helixApi->setAuthToken(authManager->accessToken());
-            } else {
-                helixApi->setAuthToken("");
+    // Sync the OAuth token to everything that talks to Helix - on login,
+    // logout and refresh, and once for a session restored at startup
+    auto syncTokens = [helixApi, helixLookup, livePoller, eventSub, viewerCountRefresher,
+                       searchController, idlePrefetcher, authManager]() {
+        QString token = authManager->isAuthenticated() ? authManager->accessToken() : QString();
+        helixApi->setAuthToken(token);
+        helixLookup->setAuthToken(token);
+        livePoller->setAuthToken(token);
+        eventSub->setAuthToken(token);
+        viewerCountRefresher->setAuthToken(token);
+        searchController->setAuthToken(token);
+        idlePrefetcher->setAuthToken(token);
+    };
+    QObject::connect(authManager, &TwitchAuthManager::authenticationChanged, syncTokens);
+    QObject::connect(authManager, &TwitchAuthManager::tokenRefreshed, syncTokens);
+    syncTokens();
+
+    QObject::connect(streamFetcher, &TwitchStreamFetcher::currentUserChanged,
+        [streamFetcher, livePoller]() {
+            livePoller->setUserId(streamFetcher->currentUserId());
+        });
+    livePoller->setUserId(streamFetcher->currentUserId());
+
+    // Browse list models - filled in C++ instead of QML append loops,
+    // all reading from one shared entity store
+    CategoryListModel *categoriesModel = new CategoryListModel(app);
+    categoriesModel->setEntityStore(entityStore);
+
+    StreamListModel *categoryStreamsModel = new StreamListModel(app);
+    categoryStreamsModel->setEntityStore(entityStore);
+
+    StreamListModel *followedStreamsModel = new StreamListModel(app);
+    followedStreamsModel->setEntityStore(entityStore);
+
+    // Local filter-as-you-type over what the browse pages have loaded
+    SearchFilterModel *categoriesFilter = new SearchFilterModel(app);
+    categoriesFilter->setSourceModel(categoriesModel);
+
+    SearchFilterModel *categoryStreamsFilter = new SearchFilterModel(app);
+    categoryStreamsFilter->setSourceModel(categoryStreamsModel);
+
+    // Rows arrive already parsed, in batches while the body downloads
+    // (see StreamingArrayReader)
+    QObject::connect(helixApi, &TwitchHelixAPI::topGamesReceived,
+                     categoriesModel, &CategoryListModel::receiveBatch);
+    QObject::connect(streamFetcher, &TwitchStreamFetcher::topCategoriesReceived,
+                     categoriesModel, &CategoryListModel::receiveBatch);
+
+    // Both stream list paths page by cursor; QML keeps the cursor. Pages
+    // requested for another category or before the last refresh are
+    // dropped (see StreamListModel::beginRequest)
+    auto receiveStreamsPage = [categoryStreamsModel](const QVector<StreamInfo> &streams,
+                                                     const QString &, bool complete,
+                                                     const QString &gameId, int generation) {
+        if (categoryStreamsModel->isCurrentRequest(gameId, generation)) {
+            categoryStreamsModel->receiveBatch(streams, complete);
+        }
+    };
+    QObject::connect(helixApi, &TwitchHelixAPI::streamsPaginationReceived, receiveStreamsPage);
+    QObject::connect(streamFetcher, &TwitchStreamFetcher::streamsForGameReceived, receiveStreamsPage);
+
+    // Followed streams arrive page by page; together they are the full list
+    QObject::connect(helixApi, &TwitchHelixAPI::followedStreamsReceived,
+        [followedStreamsModel](const QVector<StreamInfo> &streams, bool complete) {
+            followedStreamsModel->receiveBatch(streams, complete);
+            if (complete) {
+                followedStreamsModel->beginRefresh();
             }
         });
 
-    // Also sync on token refresh
-    QObject::connect(authManager, &TwitchAuthManager::tokenRefreshed,
-        [helixApi, authManager]() {
-            helixApi->setAuthToken(authManager->accessToken());
+    // Polled deltas go straight into the followed list, like the EventSub
+    // ones below; other changes only touch rows already shown
+    QObject::connect(livePoller, &FollowedLivePoller::wentLive,
+        [followedStreamsModel](const QVector<StreamInfo> &streams) {
+            followedStreamsModel->appendStreams(streams);
+        });
+    QObject::connect(livePoller, &FollowedLivePoller::wentOffline,
+        [followedStreamsModel](const QVector<StreamInfo> &streams) {
+            QVector<QString> keys;
+            keys.reserve(streams.size());
+            for (const StreamInfo &stream : streams) {
+                keys.append(EntityStore::streamKey(stream));
+            }
+            followedStreamsModel->removeStreams(keys);
+        });
+    QObject::connect(livePoller, &FollowedLivePoller::changed,
+        [entityStore](const QVector<StreamInfo> &streams) {
+            QVector<StreamInfo> shown;
+            for (const StreamInfo &stream : streams) {
+                if (entityStore->stream(EntityStore::streamKey(stream))) {
+                    shown.append(stream);
+                }
+            }
+            if (!shown.isEmpty()) {
+                entityStore->putStreams(shown);
+            }
+        });
+
+    // Pushed events go straight into the followed list
+    QObject::connect(eventSub, &EventSubClient::wentLive,
+        [followedStreamsModel](const QVector<StreamInfo> &streams) {
+            followedStreamsModel->appendStreams(streams);
+        });
+    QObject::connect(eventSub, &EventSubClient::wentOffline,
+        [followedStreamsModel](const QStringList &userIds) {
+            followedStreamsModel->removeStreams(userIds.toVector());
         });
 
-    // Set initial token if already authenticated
-    if (authManager->isAuthenticated()) {
-        helixApi->setAuthToken(authManager->accessToken());
-    }
+    // Every new top list restarts the prefetch queue
+    QObject::connect(helixApi, &TwitchHelixAPI::topGamesReceived,
+                     idlePrefetcher, &IdlePrefetcher::onTopCategoriesReceived);
+    QObject::connect(streamFetcher, &TwitchStreamFetcher::topCategoriesReceived,
+                     idlePrefetcher, &IdlePrefetcher::onTopCategoriesReceived);
 
     QQuickView *view = new QQuickView();
+    view->engine()->addImageProvider("thumbs", new ThumbnailProvider(thumbnailCache, thumbnailScheduler));
 
     // Make all available in QML
     view->rootContext()->setContextProperty("networkManager", networkManager);
+    view->rootContext()->setContextProperty("appLifecycle", appLifecycle);
     view->rootContext()->setContextProperty("authManager", authManager);
     view->rootContext()->setContextProperty("twitchFetcher", streamFetcher);
     view->rootContext()->setContextProperty("helixApi", helixApi);
+    view->rootContext()->setContextProperty("helixLookup", helixLookup);
+    view->rootContext()->setContextProperty("viewerCountRefresher", viewerCountRefresher);
+    view->rootContext()->setContextProperty("searchController", searchController);
+    view->rootContext()->setContextProperty("idlePrefetcher", idlePrefetcher);
+    view->rootContext()->setContextProperty("vodPlayer", vodPlayer);
+    view->rootContext()->setContextProperty("timeshiftPlayer", timeshiftPlayer);
+    view->rootContext()->setContextProperty("streamRecorder", streamRecorder);
+    view->rootContext()->setContextProperty("categoriesModel", categoriesModel);
+    view->rootContext()->setContextProperty("categoryStreamsModel", categoryStreamsModel);
+    view->rootContext()->setContextProperty("followedStreamsModel", followedStreamsModel);
+    view->rootContext()->setContextProperty("categoriesFilter", categoriesFilter);
+    view->rootContext()->setContextProperty("categoryStreamsFilter", categoryStreamsFilter);
+    view->rootContext()->setContextProperty("thumbnailScheduler", thumbnailScheduler);
 
     view->setSource(QUrl("qrc:/Main.qml"));
     view->setResizeMode(QQuickView::SizeRootObjectToView);
@@ -18,6 +18,7 @@ import QtQuick 2.15
 import QtQuick.Controls 2.2
 import Lomiri.Components 1.3
 import QtQuick.Layouts 1.3
+import "components"
 
 Page {
     id: categoriesPage
@@ -35,6 +36,9 @@ Page {
 
     // Signal to request stream playback
     signal streamRequested(string channel, string quality)
+    
+    // Signal to request VOD playback (twitch.tv/videos/<id>)
+    signal vodRequested(string vodId, string quality)
 
     header: PageHeader {
         id: pageHeader
@@ -58,12 +62,8 @@ Page {
         ]
     }
     
-    // Categories model
-    ListModel {
-        id: categoryModel
-    }
-    
     Flickable {
+        id: categoriesFlickable
         anchors {
             top: pageHeader.bottom
             left: parent.left
@@ -73,6 +73,16 @@ Page {
         contentHeight: contentColumn.height
         clip: true
 
+        // Thumbnails wait while the grid is being flung
+        onVerticalVelocityChanged: thumbnailScheduler.velocity = verticalVelocity / Math.max(1, height)
+        onMovementEnded: thumbnailScheduler.velocity = 0
+
+        onContentYChanged: {
+            updateNearRows()
+            reportVisibleRows()
+        }
+        onHeightChanged: updateNearRows()
+
         Column {
             id: contentColumn
             anchors {
@@ -100,7 +110,7 @@ Page {
                 TextField {
                     id: channelInput
                     width: parent.width - watchButton.width - units.gu(1)
-                    placeholderText: i18n.tr('Enter channel name (e.g. nasa)')
+                    placeholderText: i18n.tr('Channel name or video link (e.g. nasa)')
                     inputMethodHints: Qt.ImhNoAutoUppercase | Qt.ImhNoPredictiveText | Qt.ImhUrlCharactersOnly
                     
                     onAccepted: {
@@ -119,6 +129,73 @@ Page {
                 }
             }
             
+            // ========================================
+            // SEARCH (Helix, needs login)
+            // ========================================
+            
+            Label {
+                text: i18n.tr('Search')
+                font.bold: true
+                fontSize: "large"
+                width: parent.width - units.gu(4)
+                visible: searchController.available
+            }
+            
+            TextField {
+                id: searchInput
+                width: parent.width - units.gu(4)
+                visible: searchController.available
+                placeholderText: i18n.tr('Channels and categories')
+                inputMethodHints: Qt.ImhNoAutoUppercase | Qt.ImhNoPredictiveText
+                // Debounced and cached in SearchController
+                onTextChanged: searchController.query = text
+                Component.onCompleted: text = searchController.query
+            }
+            
+            ActivityIndicator {
+                anchors.horizontalCenter: parent.horizontalCenter
+                running: searchController.searching && searchInput.visible
+                visible: running
+            }
+            
+            Repeater {
+                model: searchInput.visible && searchInput.text.length > 0 ? searchController.channels : []
+                
+                delegate: ListItem {
+                    width: parent.width - units.gu(4)
+                    height: units.gu(6)
+                    
+                    ListItemLayout {
+                        title.text: modelData.display_name
+                        subtitle.text: modelData.is_live ? i18n.tr('Live') + " · " + modelData.game_name
+                                                         : i18n.tr('Offline')
+                    }
+                    
+                    onClicked: watchStream(modelData.broadcaster_login)
+                }
+            }
+            
+            Repeater {
+                model: searchInput.visible && searchInput.text.length > 0 ? searchController.categories : []
+                
+                delegate: ListItem {
+                    width: parent.width - units.gu(4)
+                    height: units.gu(6)
+                    
+                    ListItemLayout {
+                        title.text: modelData.name
+                        subtitle.text: i18n.tr('Category')
+                    }
+                    
+                    onClicked: {
+                        stackView.push(streamsForCategoryPage, {
+                            categoryId: modelData.id,
+                            categoryName: modelData.name
+                        })
+                    }
+                }
+            }
+            
             // ========================================
             // TOP CATEGORIES
             // ========================================
@@ -140,11 +217,26 @@ Page {
             // Empty state
             Label {
                 anchors.horizontalCenter: parent.horizontalCenter
-                text: categoryModel.count === 0 && !isRefreshing ? i18n.tr('No categories available') : ""
+                text: categoriesModel.count === 0 && !isRefreshing ? i18n.tr('No categories available') : ""
                 visible: text.length > 0
                 color: theme.palette.normal.backgroundSecondaryText
             }
             
+            // Filter over the loaded categories
+            SearchFilterBar {
+                width: parent.width - units.gu(4)
+                filter: categoriesFilter
+                placeholderText: i18n.tr('Filter categories')
+                visible: categoriesModel.count > 0
+            }
+            
+            Label {
+                anchors.horizontalCenter: parent.horizontalCenter
+                text: i18n.tr('No matching categories')
+                visible: categoriesFilter.filtering && categoriesFilter.count === 0
+                color: theme.palette.normal.backgroundSecondaryText
+            }
+            
             // Categories grid
             GridView {
                 id: categoryGrid
@@ -157,7 +249,16 @@ Page {
                 
                 clip: true
                 interactive: false  // Let Flickable handle scrolling
-                model: categoryModel
+                model: categoriesFilter
+                onCountChanged: {
+                    updateNearRows()
+                    reportVisibleRows()
+                }
+                
+                // Rows near the viewport (see updateNearRows())
+                property int nearFirst: 0
+                property int nearLast: -1
+                onColumnsCountChanged: updateNearRows()
                 
                 // Responsive columns
                 property int columnsCount: {
@@ -194,11 +295,11 @@ Page {
                                 radius: units.gu(1)
                                 clip: true
                                 
-                                Image {
+                                Thumbnail {
                                     anchors.fill: parent
-                                    source: model.boxArtUrl
+                                    nearViewport: index >= categoryGrid.nearFirst && index <= categoryGrid.nearLast
+                                    url: model.boxArtUrl
                                     fillMode: Image.PreserveAspectFit
-                                    asynchronous: true
                                 }
                                 
                                 // Viewer count badge (if available)
@@ -263,6 +364,7 @@ Page {
     // Functions
     function refreshCategories() {
         isRefreshing = true
+        categoriesModel.beginRefresh()
         
         if (authManager.isAuthenticated) {
             // Use Helix API (logged in, better performance)
@@ -274,7 +376,41 @@ Page {
     }
     
     function watchStream(channelName) {
-        streamRequested(channelName, "best")
+        var input = channelName.trim()
+        // Only twitch.tv/videos/<id> - "v1234567" is a valid login too
+        var vodMatch = input.match(/(?:^|\/)videos\/(\d+)(?:[\/?#].*)?$/)
+        if (vodMatch) {
+            vodRequested(vodMatch[1], "best")
+            return
+        }
+        streamRequested(input, "best")
+    }
+    
+    // Rows within a screen of the viewport, whose thumbnails may load -
+    // worked out once per frame here rather than in every delegate
+    function updateNearRows() {
+        var top = categoriesFlickable.contentY - categoryGrid.mapToItem(categoriesFlickable.contentItem, 0, 0).y
+        categoryGrid.nearFirst = Math.max(0, Math.floor((top - categoriesFlickable.height) / categoryGrid.cellHeight)) * categoryGrid.columnsCount
+        categoryGrid.nearLast = Math.ceil((top + categoriesFlickable.height * 2) / categoryGrid.cellHeight) * categoryGrid.columnsCount - 1
+    }
+    
+    // Tell the refresher which rows are on screen so their viewer counts stay current
+    function reportVisibleRows() {
+        if (!visible || categoryGrid.count === 0) {
+            viewerCountRefresher.clearVisibleRows(categoriesFilter)
+            return
+        }
+        var top = categoriesFlickable.contentY - categoryGrid.mapToItem(categoriesFlickable.contentItem, 0, 0).y
+        var first = Math.max(0, Math.floor(top / categoryGrid.cellHeight)) * categoryGrid.columnsCount
+        var last = Math.ceil((top + categoriesFlickable.height) / categoryGrid.cellHeight) * categoryGrid.columnsCount - 1
+        viewerCountRefresher.setVisibleRows(categoriesFilter, first, Math.min(last, categoryGrid.count - 1))
+    }
+    
+    onVisibleChanged: reportVisibleRows()
+    Component.onDestruction: {
+        viewerCountRefresher.clearVisibleRows(categoriesFilter)
+        // Popped mid-fling: the flickable won't report the stop anymore
+        thumbnailScheduler.velocity = 0
     }
     
     // Load categories on component completion
@@ -283,30 +419,15 @@ Page {
         refreshCategories()
     }
     
-    // Connections - Helix API (authenticated)
+    // Connections - rows land in categoriesModel (filled in C++),
+    // the grid shows them through categoriesFilter
     Connections {
         target: helixApi
         ignoreUnknownSignals: true
         
         onTopGamesReceived: {
-                categoryModel.clear()
-            
-            for (var i = 0; i < games.length; i++) {
-                var game = games[i]
-                var boxArtUrl = game.box_art_url
-                boxArtUrl = boxArtUrl.replace("{width}", "285")
-                boxArtUrl = boxArtUrl.replace("{height}", "380")
-                
-                categoryModel.append({
-                    id: game.id,
-                    name: game.name,
-                    boxArtUrl: boxArtUrl,
-                    viewersCount: 0  // Helix doesn't provide viewer count
-                })
-            }
-            
             isRefreshing = false
-            }
+        }
     }
     
     // Connections - GraphQL (anonymous)
@@ -315,21 +436,8 @@ Page {
         ignoreUnknownSignals: true
         
         onTopCategoriesReceived: {
-                categoryModel.clear()
-            
-            for (var i = 0; i < categories.length; i++) {
-                var cat = categories[i]
-                
-                categoryModel.append({
-                    id: cat.id,
-                    name: cat.name,
-                    boxArtUrl: cat.boxArtUrl,
-                    viewersCount: cat.viewersCount || 0
-                })
-            }
-            
             isRefreshing = false
-            }
+        }
     }
     
     // Error handling
@@ -59,11 +59,6 @@ Page {
         ]
     }
     
-    // Followed streams model
-    ListModel {
-        id: followedModel
-    }
-    
     // Pull to refresh with proper Flickable structure
     Flickable {
         id: mainFlickable
@@ -76,6 +71,13 @@ Page {
         contentHeight: followedContent.height
         clip: true
 
+        // Thumbnails wait while the grid is being flung
+        onVerticalVelocityChanged: thumbnailScheduler.velocity = verticalVelocity / Math.max(1, height)
+        onMovementEnded: thumbnailScheduler.velocity = 0
+
+        onContentYChanged: updateNearRows()
+        onHeightChanged: updateNearRows()
+
         // Custom Pull to refresh
         CustomPullToRefresh {
             id: pullToRefresh
@@ -104,7 +106,7 @@ Page {
                 Label {
                     anchors.horizontalCenter: parent.horizontalCenter
                     text: i18n.tr('No followed channels live right now')
-                    visible: !isRefreshing && followedModel.count === 0
+                    visible: !isRefreshing && followedStreamsModel.count === 0
                     color: theme.palette.normal.backgroundSecondaryText
                 }
                 
@@ -120,7 +122,13 @@ Page {
                     
                     clip: true
                     interactive: false  // Let Flickable handle scrolling
-                    model: followedModel
+                    model: followedStreamsModel
+                    onCountChanged: updateNearRows()
+                    
+                    // Rows near the viewport (see updateNearRows())
+                    property int nearFirst: 0
+                    property int nearLast: -1
+                    onColumnsCountChanged: updateNearRows()
                     
                     // Responsive columns
                     property int columnsCount: {
@@ -156,11 +164,10 @@ Page {
                                     color: theme.palette.normal.base
                                     clip: true
                                     
-                                    Image {
+                                    Thumbnail {
                                         anchors.fill: parent
-                                        source: model.thumbnailUrl
-                                        fillMode: Image.PreserveAspectCrop
-                                        asynchronous: true
+                                        nearViewport: index >= followedGrid.nearFirst && index <= followedGrid.nearLast
+                                        url: model.thumbnailUrl
                                     }
                                     
                                     // LIVE badge and viewer count
@@ -273,6 +280,14 @@ Page {
         streamRequested(channelName, "best")
     }
     
+    // Rows within a screen of the viewport, whose thumbnails may load -
+    // worked out once per frame here rather than in every delegate
+    function updateNearRows() {
+        var top = mainFlickable.contentY - followedGrid.mapToItem(mainFlickable.contentItem, 0, 0).y
+        followedGrid.nearFirst = Math.max(0, Math.floor((top - mainFlickable.height) / followedGrid.cellHeight)) * followedGrid.columnsCount
+        followedGrid.nearLast = Math.ceil((top + mainFlickable.height * 2) / followedGrid.cellHeight) * followedGrid.columnsCount - 1
+    }
+    
     // Load followed streams on component completion
     Component.onCompleted: {
         console.log("FollowedPage created | width:", width)
@@ -282,39 +297,18 @@ Page {
         }
     }
     
+    // Popped mid-fling: the flickable won't report the stop anymore
+    Component.onDestruction: thumbnailScheduler.velocity = 0
+    
     // Connections
     Connections {
         target: helixApi
         ignoreUnknownSignals: true
         
+        // Rows land in followedStreamsModel (filled in C++)
         onFollowedStreamsReceived: {
-                followedModel.clear()
-            
-            for (var i = 0; i < streams.length; i++) {
-                var stream = streams[i]
-                
-                var thumbnailUrl = stream.thumbnail_url
-                thumbnailUrl = thumbnailUrl.replace("{width}", "440")
-                thumbnailUrl = thumbnailUrl.replace("{height}", "248")
-                
-                var viewerCount = stream.viewer_count
-                var viewerCountFormatted = viewerCount >= 1000 ? 
-                    (viewerCount / 1000).toFixed(1) + "K" : 
-                    viewerCount.toString()
-                
-                followedModel.append({
-                    userLogin: stream.user_login,
-                    userName: stream.user_name,
-                    gameName: stream.game_name,
-                    title: stream.title,
-                    viewerCount: viewerCount,
-                    viewerCountFormatted: viewerCountFormatted,
-                    thumbnailUrl: thumbnailUrl
-                })
-            }
-            
             isRefreshing = false
-            }
+        }
         
         onError: {
                 isRefreshing = false
@@ -341,7 +335,7 @@ Page {
         onAuthenticationChanged: {
             if (!authenticated) {
                 // User logged out, clear the followed streams list
-                followedModel.clear()
+                followedStreamsModel.clear()
                 isRefreshing = false
             }
         }
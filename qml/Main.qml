@@ -116,28 +116,13 @@ MainView {
 
         onConnectionRestored: {
 
-            // Retry failed operations
-
-            // Fetch user info if we have GraphQL token but no user info yet
-            if (typeof twitchFetcher !== 'undefined' && twitchFetcher.hasGraphQLToken && !twitchFetcher.hasUserInfo) {
-                twitchFetcher.fetchCurrentUser()
+            // Don't refresh browse pages nobody is looking at
+            if (typeof appLifecycle !== 'undefined' && !appLifecycle.isForeground) {
+                pendingForegroundRefresh = true
+                return
             }
 
-            // Refresh current page content
-            if (stackView.currentItem) {
-                // If on FollowedPage, refresh followed streams
-                if (stackView.currentItem.objectName === "followedPage") {
-                    if (authManager.isAuthenticated && twitchFetcher.hasUserInfo) {
-                        helixApi.getFollowedStreams(twitchFetcher.currentUserId, 100)
-                    }
-                }
-                // If on CategoriesPage, refresh categories
-                else if (stackView.currentItem.objectName === "categoriesPage") {
-                    if (typeof stackView.currentItem.refreshCategories === 'function') {
-                        stackView.currentItem.refreshCategories()
-                    }
-                }
-            }
+            refreshAfterReconnect()
 
             // Optional: Show success notification
             Qt.createQmlObject(
@@ -154,6 +139,50 @@ MainView {
         }
     }
 
+    // ========================================
+    // BACKGROUND MODE
+    // ========================================
+
+    // Set when a refresh was skipped while in the background
+    property bool pendingForegroundRefresh: false
+
+    Connections {
+        target: appLifecycle
+        ignoreUnknownSignals: true
+
+        onForegroundChanged: {
+            if (foreground && pendingForegroundRefresh) {
+                pendingForegroundRefresh = false
+                refreshAfterReconnect()
+            }
+        }
+    }
+
+    function refreshAfterReconnect() {
+        // Retry failed operations
+
+        // Fetch user info if we have GraphQL token but no user info yet
+        if (typeof twitchFetcher !== 'undefined' && twitchFetcher.hasGraphQLToken && !twitchFetcher.hasUserInfo) {
+            twitchFetcher.fetchCurrentUser()
+        }
+
+        // Refresh current page content
+        if (stackView.currentItem) {
+            // If on FollowedPage, refresh followed streams
+            if (stackView.currentItem.objectName === "followedPage") {
+                if (authManager.isAuthenticated && twitchFetcher.hasUserInfo) {
+                    helixApi.getFollowedStreams(twitchFetcher.currentUserId, 100)
+                }
+            }
+            // If on CategoriesPage, refresh categories
+            else if (stackView.currentItem.objectName === "categoriesPage") {
+                if (typeof stackView.currentItem.refreshCategories === 'function') {
+                    stackView.currentItem.refreshCategories()
+                }
+            }
+        }
+    }
+
     // ========================================
     // RESPONSIVE SIDEBAR/DRAWER
     // ========================================
@@ -863,6 +892,10 @@ MainView {
         onStreamRequested: {
                 player.startStream(channel, quality)
         }
+        
+        onVodRequested: {
+            player.startVod(vodId, quality)
+        }
     }
     
     // ========================================
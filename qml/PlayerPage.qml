@@ -15,6 +15,7 @@
  */
 
 import QtQuick 2.15
+import QtQuick.Window 2.2
 import QtMultimedia 5.15
 import QtQuick.Controls 2.2
 import Lomiri.Components 1.3
@@ -29,6 +30,19 @@ Item {
     property string currentStreamUrl: ""
     property string currentQuality: "Best"
     
+    // VOD playback goes through vodPlayer instead of the Video element
+    property bool isVod: false
+    property string vodId: ""
+    
+    // Live playback goes through timeshiftPlayer (pause/rewind), with the
+    // Video element as fallback if it can't play
+    property bool isTimeshift: false
+    
+    readonly property bool usesSegmentPlayer: isVod || isTimeshift
+    readonly property bool isPlaying: isVod ? vodPlayer.isPlaying
+                                            : isTimeshift ? timeshiftPlayer.isPlaying
+                                                          : videoPlayer.playbackState === MediaPlayer.PlayingState
+    
     // Control visibility
     property bool isActive: false  // Set to true when player should be shown
     
@@ -39,6 +53,15 @@ Item {
     property real miniWidth: units.gu(40)
     property real miniHeight: units.gu(22.5) // 16:9 aspect ratio
     
+    // Mini player bandwidth saver: quality to restore on maximize
+    property string savedQuality: ""
+    property string savedStreamUrl: ""
+    
+    // Background listening: quality to restore when returning to foreground
+    property bool isAudioOnlyMode: false
+    property string backgroundSavedQuality: ""
+    property string backgroundSavedUrl: ""
+    
     // Animation state
     property bool isTransitioning: false
     
@@ -143,12 +166,16 @@ Item {
                     }
                 }
                 PropertyAction { target: playerPage; property: "isTransitioning"; value: false }
+                // Drop to a small variant once the surface is actually small
+                ScriptAction { script: applyMiniQuality() }
             }
         },
         Transition {
             from: "mini"
             to: "fullscreen"
             SequentialAnimation {
+                // Restore first so the full variant loads while we animate
+                ScriptAction { script: restoreSavedQuality() }
                 PropertyAction { target: playerPage; property: "isTransitioning"; value: true }
                 PropertyAction { target: playerContainer; property: "y"; value: 0 }
                 ParallelAnimation {
@@ -199,6 +226,8 @@ Item {
             id: videoPlayer
             anchors.fill: parent
             autoPlay: false
+            // Nothing to render while only the audio rendition is playing
+            visible: !usesSegmentPlayer && !isAudioOnlyMode
             
             Component.onDestruction: {
                 if (playbackState === MediaPlayer.PlayingState) {
@@ -238,6 +267,22 @@ Item {
             }
         }
         
+        // VOD output - frames come from vodPlayer's media object
+        VideoOutput {
+            id: vodOutput
+            anchors.fill: parent
+            source: vodPlayer
+            visible: isVod && !isAudioOnlyMode
+        }
+        
+        // Live output with timeshift
+        VideoOutput {
+            id: timeshiftOutput
+            anchors.fill: parent
+            source: timeshiftPlayer
+            visible: isTimeshift && !isAudioOnlyMode
+        }
+        
         // Status overlay (loading, errors)
         Rectangle {
             id: statusOverlay
@@ -256,6 +301,8 @@ Item {
                     anchors.horizontalCenter: parent.horizontalCenter
                     running: videoPlayer.status === MediaPlayer.Loading || 
                             videoPlayer.status === MediaPlayer.Buffering ||
+                            (isVod && vodPlayer.isBuffering) ||
+                            (isTimeshift && timeshiftPlayer.isBuffering) ||
                             statusLabel.text.indexOf("Fetching") >= 0
                     visible: running
                 }
@@ -520,6 +567,61 @@ Item {
                 }
             }
             
+            // Top bar - Record button (left of exit) - live only
+            Rectangle {
+                id: recordButton
+                anchors {
+                    top: parent.top
+                    right: exitButton.left
+                    topMargin: units.gu(2)
+                    rightMargin: units.gu(1)
+                }
+                width: recordRow.width + units.gu(2)
+                height: units.gu(5)
+                color: Qt.rgba(0, 0, 0, 0.7)
+                radius: units.gu(0.5)
+                border.color: isRecordingThis ? "#e91916" : "white"
+                border.width: units.dp(1)
+                visible: !isVod && channelName !== ""
+                
+                property bool isRecordingThis: streamRecorder.isRecording &&
+                                               streamRecorder.recordingChannel === channelName
+                
+                Row {
+                    id: recordRow
+                    anchors.centerIn: parent
+                    spacing: units.gu(0.5)
+                    
+                    Rectangle {
+                        anchors.verticalCenter: parent.verticalCenter
+                        width: units.gu(1.5)
+                        height: width
+                        radius: recordButton.isRecordingThis ? units.gu(0.2) : width / 2
+                        color: "#e91916"
+                    }
+                    
+                    Label {
+                        anchors.verticalCenter: parent.verticalCenter
+                        text: recordButton.isRecordingThis ? formatTime(streamRecorder.recordedMs)
+                                                           : i18n.tr("REC")
+                        color: "white"
+                        font.bold: true
+                    }
+                }
+                
+                MouseArea {
+                    anchors.fill: parent
+                    onClicked: {
+                        if (recordButton.isRecordingThis) {
+                            streamRecorder.stopRecording()
+                        } else {
+                            streamRecorder.startRecording(channelName, requestedQuality)
+                        }
+                        showControlsTemporarily()
+                    }
+                }
+            }
+            
             // Center play/pause button
             Rectangle {
                 anchors.centerIn: parent
@@ -527,11 +629,11 @@ Item {
                 height: units.gu(8)
                 color: Qt.rgba(0, 0, 0, 0.7)
                 radius: width / 2
-                visible: videoPlayer.playbackState !== MediaPlayer.PlayingState || controlsOverlay.opacity > 0.5
+                visible: !isPlaying || controlsOverlay.opacity > 0.5
                 
                 Icon {
                     anchors.centerIn: parent
-                    name: videoPlayer.playbackState === MediaPlayer.PlayingState ? 
+                    name: isPlaying ? 
                           "media-playback-pause" : "media-playback-start"
                     width: units.gu(4)
                     height: units.gu(4)
@@ -541,16 +643,114 @@ Item {
                 MouseArea {
                     anchors.fill: parent
                     onClicked: {
-                                if (videoPlayer.playbackState === MediaPlayer.PlayingState) {
-                            videoPlayer.pause()
+                                if (isPlaying) {
+                            pauseMedia()
                         } else {
-                            videoPlayer.play()
+                            playMedia()
                         }
                         showControlsTemporarily()
                     }
                 }
             }
             
+            // Bottom bar - VOD seek bar (left of quality selector)
+            Slider {
+                id: seekSlider
+                anchors {
+                    bottom: parent.bottom
+                    left: parent.left
+                    right: qualityButton.visible ? qualityButton.left : parent.right
+                    margins: units.gu(2)
+                }
+                visible: isVod && vodPlayer.duration > 0
+                minimumValue: 0
+                maximumValue: Math.max(1, vodPlayer.duration)
+                live: false
+                
+                function formatValue(v) {
+                    return formatTime(v)
+                }
+                
+                onPressedChanged: {
+                    if (pressed) {
+                        hideControlsTimer.stop()
+                    } else {
+                        vodPlayer.seek(value)
+                        showControlsTemporarily()
+                    }
+                }
+                
+                Connections {
+                    target: vodPlayer
+                    ignoreUnknownSignals: true
+                    
+                    onPositionChanged: {
+                        if (!seekSlider.pressed) {
+                            seekSlider.value = vodPlayer.position
+                        }
+                    }
+                }
+            }
+            
+            // Bottom bar - Timeshift controls (left)
+            Row {
+                id: timeshiftControls
+                anchors {
+                    bottom: parent.bottom
+                    left: parent.left
+                    margins: units.gu(2)
+                }
+                spacing: units.gu(1)
+                visible: isTimeshift
+                
+                Rectangle {
+                    width: units.gu(7)
+                    height: units.gu(5)
+                    color: Qt.rgba(0, 0, 0, 0.7)
+                    radius: units.gu(0.5)
+                    
+                    Label {
+                        anchors.centerIn: parent
+                        text: "-30s"
+                        color: "white"
+                        font.bold: true
+                    }
+                    
+                    MouseArea {
+                        anchors.fill: parent
+                        onClicked: {
+                            timeshiftPlayer.rewind(30)
+                            showControlsTemporarily()
+                        }
+                    }
+                }
+                
+                Rectangle {
+                    width: liveLabel.width + units.gu(2)
+                    height: units.gu(5)
+                    color: timeshiftPlayer.isAtLive ? "#e91916" : Qt.rgba(0, 0, 0, 0.7)
+                    radius: units.gu(0.5)
+                    
+                    Label {
+                        id: liveLabel
+                        anchors.centerIn: parent
+                        text: timeshiftPlayer.isAtLive ? i18n.tr("LIVE")
+                                                       : "-" + formatTime(timeshiftPlayer.behindLiveMs)
+                        color: "white"
+                        font.bold: true
+                    }
+                    
+                    MouseArea {
+                        anchors.fill: parent
+                        enabled: !timeshiftPlayer.isAtLive
+                        onClicked: {
+                            timeshiftPlayer.jumpToLive()
+                            showControlsTemporarily()
+                        }
+                    }
+                }
+            }
+            
             // Bottom bar - Quality selector (right)
             Rectangle {
                 id: qualityButton
@@ -742,7 +942,8 @@ Item {
                 height: units.gu(3)
                 color: Qt.rgba(0, 0, 0, 0.8)
                 radius: units.gu(0.5)
-                visible: videoPlayer.playbackState === MediaPlayer.PausedState
+                visible: usesSegmentPlayer ? (!isPlaying && currentStreamUrl !== "")
+                                           : videoPlayer.playbackState === MediaPlayer.PausedState
                 
                 Icon {
                     anchors.centerIn: parent
@@ -865,6 +1066,8 @@ Item {
         if (videoPlayer.playbackState === MediaPlayer.PlayingState) {
             videoPlayer.stop()
         }
+        vodPlayer.stop()
+        timeshiftPlayer.stop()
         
         // Reset positions
         playerContainer.y = 0
@@ -872,8 +1075,16 @@ Item {
         // Reset state
         isActive = false
         channelName = ""
+        isVod = false
+        vodId = ""
+        isTimeshift = false
         currentStreamUrl = ""
         currentQuality = "Best"
+        savedQuality = ""
+        savedStreamUrl = ""
+        isAudioOnlyMode = false
+        backgroundSavedQuality = ""
+        backgroundSavedUrl = ""
         availableQualities.clear()
         
         // Notify Main.qml
@@ -949,7 +1160,14 @@ Item {
     }
     
     
+    // Quality picked by hand - it wins over the one saved for mini mode
     function switchQuality(qualityName) {
+        savedQuality = ""
+        savedStreamUrl = ""
+        applyQuality(qualityName)
+    }
+    
+    function applyQuality(qualityName) {
         
         var qualityUrl = twitchFetcher.getQualityUrl(qualityName)
         
@@ -958,22 +1176,169 @@ Item {
         }
         
         
-        var wasPlaying = videoPlayer.playbackState === MediaPlayer.PlayingState
+        var wasPlaying = isPlaying
         
-        videoPlayer.source = qualityUrl
+        loadSource(qualityUrl)
         currentStreamUrl = qualityUrl
         currentQuality = qualityName
         
         if (wasPlaying) {
+            playMedia()
+        }
+    }
+    
+    // Switch to the smallest variant covering the mini surface
+    function applyMiniQuality() {
+        if (!isMiniMode || currentStreamUrl === "" || savedStreamUrl !== "") {
+            return
+        }
+        
+        var targetQuality = twitchFetcher.getQualityForSize(
+            Math.round(miniWidth * Screen.devicePixelRatio),
+            Math.round(miniHeight * Screen.devicePixelRatio))
+        
+        if (targetQuality === "" || targetQuality === currentQuality) {
+            return
+        }
+        
+        var targetUrl = twitchFetcher.getQualityUrl(targetQuality)
+        if (targetUrl === "" || targetUrl === currentStreamUrl) {
+            return
+        }
+        
+        savedQuality = currentQuality
+        savedStreamUrl = currentStreamUrl
+        applyQuality(targetQuality)
+    }
+    
+    // Restore whatever the user was watching before minimizing
+    function restoreSavedQuality() {
+        if (savedStreamUrl === "") {
+            return
+        }
+        
+        var wasPlaying = isPlaying
+        
+        loadSource(savedStreamUrl)
+        currentStreamUrl = savedStreamUrl
+        currentQuality = savedQuality
+        savedQuality = ""
+        savedStreamUrl = ""
+        
+        if (wasPlaying) {
+            playMedia()
+        }
+    }
+    
+    // Switch to the audio-only rendition while the app is in the background.
+    // Paused too: the timeshift player keeps downloading while paused.
+    function enterAudioOnlyMode() {
+        if (isAudioOnlyMode || !isActive || currentStreamUrl === "") {
+            return
+        }
+        
+        var audioUrl = twitchFetcher.getQualityUrl("Audio Only")
+        if (audioUrl === "") {
+            return
+        }
+        
+        var wasPlaying = isPlaying
+        
+        backgroundSavedQuality = currentQuality
+        backgroundSavedUrl = currentStreamUrl
+        isAudioOnlyMode = true
+        
+        loadSource(audioUrl, true)
+        currentStreamUrl = audioUrl
+        currentQuality = "Audio Only"
+        
+        if (wasPlaying) {
+            playMedia()
+        }
+    }
+    
+    // Restore video at the quality used before going to the background
+    function leaveAudioOnlyMode() {
+        if (!isAudioOnlyMode) {
+            return
+        }
+        
+        var wasPlaying = isPlaying
+        
+        isAudioOnlyMode = false
+        loadSource(backgroundSavedUrl, true)
+        currentStreamUrl = backgroundSavedUrl
+        currentQuality = backgroundSavedQuality
+        backgroundSavedQuality = ""
+        backgroundSavedUrl = ""
+        
+        if (wasPlaying) {
+            playMedia()
+        }
+    }
+    
+    // Load a variant URL into whichever player is active. VODs keep
+    // their position across the switch; timeshift splices the new variant
+    // into its buffer. 'restart' is for switches to or from audio only,
+    // which the decoder can't follow mid-stream.
+    function loadSource(url, restart) {
+        if (isVod) {
+            vodPlayer.load(url, vodPlayer.position)
+        } else if (isTimeshift) {
+            timeshiftPlayer.switchVariant(url, restart === true)
+        } else {
+            videoPlayer.source = url
+        }
+    }
+    
+    function playMedia() {
+        if (isVod) {
+            vodPlayer.play()
+        } else if (isTimeshift) {
+            timeshiftPlayer.play()
+        } else {
             videoPlayer.play()
         }
     }
     
+    function pauseMedia() {
+        if (isVod) {
+            vodPlayer.pause()
+        } else if (isTimeshift) {
+            timeshiftPlayer.pause()
+        } else {
+            videoPlayer.pause()
+        }
+    }
+    
+    // Milliseconds -> h:mm:ss / m:ss
+    function formatTime(ms) {
+        var total = Math.floor(ms / 1000)
+        var h = Math.floor(total / 3600)
+        var m = Math.floor((total % 3600) / 60)
+        var sec = total % 60
+        var mm = (h > 0 && m < 10) ? "0" + m : "" + m
+        var ss = sec < 10 ? "0" + sec : "" + sec
+        return h > 0 ? h + ":" + mm + ":" + ss : mm + ":" + ss
+    }
+    
     // Public function to start a stream
     function startStream(channel, quality) {
         
+        if (isVod) {
+            vodPlayer.stop()
+        }
+        timeshiftPlayer.stop()
+        isVod = false
+        vodId = ""
+        isTimeshift = false
         channelName = channel
         requestedQuality = quality
+        savedQuality = ""
+        savedStreamUrl = ""
+        isAudioOnlyMode = false
+        backgroundSavedQuality = ""
+        backgroundSavedUrl = ""
         isActive = true
         state = "fullscreen"
         
@@ -983,11 +1348,55 @@ Item {
         twitchFetcher.fetchStreamUrl(channel, quality)
     }
     
+    // Public function to start a VOD (past broadcast)
+    function startVod(videoId, quality) {
+        
+        if (videoPlayer.playbackState !== MediaPlayer.StoppedState) {
+            videoPlayer.stop()
+        }
+        videoPlayer.source = ""
+        vodPlayer.stop()
+        timeshiftPlayer.stop()
+        
+        isVod = true
+        isTimeshift = false
+        vodId = videoId
+        channelName = i18n.tr("Video %1").arg(videoId)
+        requestedQuality = quality
+        currentStreamUrl = ""
+        savedQuality = ""
+        savedStreamUrl = ""
+        isAudioOnlyMode = false
+        backgroundSavedQuality = ""
+        backgroundSavedUrl = ""
+        isActive = true
+        state = "fullscreen"
+        
+        statusLabel.text = "Fetching video..."
+        statusOverlay.visible = true
+        
+        twitchFetcher.fetchVodUrl(videoId, quality)
+    }
+    
     // Signals for Main.qml
     signal playerMinimized()
     signal playerMaximized()
     signal playerClosed()
     
+    // Audio-only background mode
+    Connections {
+        target: appLifecycle
+        ignoreUnknownSignals: true
+        
+        onForegroundChanged: {
+            if (foreground) {
+                leaveAudioOnlyMode()
+            } else {
+                enterAudioOnlyMode()
+            }
+        }
+    }
+    
     // Connections to TwitchStreamFetcher
     Connections {
         target: twitchFetcher
@@ -997,8 +1406,9 @@ Item {
             if (channelName === playerPage.channelName) {
                 currentStreamUrl = url
                 statusLabel.text = "Starting playback..."
-                videoPlayer.source = url
-                videoPlayer.play()
+                isTimeshift = true
+                timeshiftPlayer.load(url)
+                timeshiftPlayer.play()
 
                 // Find and set the current quality based on the URL
                 for (var i = 0; i < availableQualities.count; i++) {
@@ -1016,6 +1426,27 @@ Item {
             }
         }
         
+        onVodUrlReady: {
+            if (isVod && vodId === playerPage.vodId) {
+                currentStreamUrl = url
+                statusLabel.text = "Starting playback..."
+                vodPlayer.load(url, 0)
+                vodPlayer.play()
+                
+                for (var i = 0; i < availableQualities.count; i++) {
+                    var qualityName = availableQualities.get(i).name
+                    if (twitchFetcher.getQualityUrl(qualityName) === url) {
+                        currentQuality = qualityName
+                        break
+                    }
+                }
+                
+                if (!isMiniMode) {
+                    showControlsTemporarily()
+                }
+            }
+        }
+        
         onAvailableQualitiesChanged: {
             availableQualities.clear()
 
@@ -1025,6 +1456,12 @@ Item {
                 return match ? parseInt(match[1]) : 0
             }
 
+            // Frame rate after the resolution (e.g., "720p60 (High)" -> 60)
+            function getFrameRate(qualityName) {
+                var match = qualityName.match(/\d+p(\d+)/)
+                return match ? parseInt(match[1]) : 0
+            }
+
             // Sort qualities by resolution (highest first)
             var sortedQualities = qualities.slice().sort(function(a, b) {
                 var resA = getResolution(a)
@@ -1035,13 +1472,8 @@ Item {
                     return resB - resA
                 }
 
-                // If same resolution, prefer non-60fps version
-                var aHas60 = a.indexOf("60") >= 0
-                var bHas60 = b.indexOf("60") >= 0
-                if (aHas60 && !bHas60) return 1
-                if (!aHas60 && bHas60) return -1
-
-                return 0
+                // If same resolution, prefer the lower frame rate
+                return getFrameRate(a) - getFrameRate(b)
             })
 
             for (var i = 0; i < sortedQualities.length; i++) {
@@ -1061,4 +1493,59 @@ Item {
             statusOverlay.visible = true
         }
     }
+    
+    // VOD player status
+    Connections {
+        target: vodPlayer
+        ignoreUnknownSignals: true
+        
+        onBufferingChanged: {
+            if (!isVod) {
+                return
+            }
+            if (vodPlayer.isBuffering) {
+                statusLabel.text = i18n.tr('Buffering...')
+                statusOverlay.visible = true
+            } else {
+                statusOverlay.visible = false
+            }
+        }
+        
+        onError: {
+            if (isVod) {
+                statusLabel.text = "Error: " + message
+                statusOverlay.visible = true
+            }
+        }
+    }
+    
+    // Timeshift player status
+    Connections {
+        target: timeshiftPlayer
+        ignoreUnknownSignals: true
+        
+        onBufferingChanged: {
+            if (!isTimeshift) {
+                return
+            }
+            if (timeshiftPlayer.isBuffering) {
+                statusLabel.text = i18n.tr('Buffering...')
+                statusOverlay.visible = true
+            } else {
+                statusOverlay.visible = false
+            }
+        }
+        
+        onError: {
+            if (!isTimeshift || currentStreamUrl === "") {
+                return
+            }
+            // Fall back to plain HLS playback without pause/rewind
+            console.log("Timeshift unavailable, falling back to direct playback:", message)
+            timeshiftPlayer.stop()
+            isTimeshift = false
+            videoPlayer.source = currentStreamUrl
+            videoPlayer.play()
+        }
+    }
 }
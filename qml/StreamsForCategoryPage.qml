@@ -57,11 +57,6 @@ Page {
         ]
     }
     
-    // Streams model
-    ListModel {
-        id: streamsModel
-    }
-    
     // Pull to refresh with proper Flickable structure
     Flickable {
         id: mainFlickable
@@ -74,6 +69,20 @@ Page {
         contentHeight: streamsContent.height
         clip: true
 
+        // Thumbnails wait while the grid is being flung
+        onVerticalVelocityChanged: thumbnailScheduler.velocity = verticalVelocity / Math.max(1, height)
+        onMovementEnded: thumbnailScheduler.velocity = 0
+
+        // Fetch the next page while there's still this much to scroll
+        onContentYChanged: {
+            if (contentHeight - (contentY + height) < height * 1.5) {
+                loadMoreStreams()
+            }
+            updateNearRows()
+            reportVisibleRows()
+        }
+        onHeightChanged: updateNearRows()
+
         // Custom Pull to refresh
         CustomPullToRefresh {
             id: pullToRefresh
@@ -99,7 +108,23 @@ Page {
                 Label {
                     anchors.horizontalCenter: parent.horizontalCenter
                     text: i18n.tr('No streams online for this category')
-                    visible: !isRefreshing && streamsModel.count === 0
+                    visible: !isRefreshing && categoryStreamsModel.count === 0
+                    color: theme.palette.normal.backgroundSecondaryText
+                }
+                
+                // Filter over the streams loaded so far
+                SearchFilterBar {
+                    anchors.horizontalCenter: parent.horizontalCenter
+                    width: parent.width - units.gu(4)
+                    filter: categoryStreamsFilter
+                    placeholderText: i18n.tr('Filter by title, channel or tag')
+                    visible: categoryStreamsModel.count > 0
+                }
+                
+                Label {
+                    anchors.horizontalCenter: parent.horizontalCenter
+                    text: i18n.tr('No matching streams')
+                    visible: categoryStreamsFilter.filtering && categoryStreamsFilter.count === 0
                     color: theme.palette.normal.backgroundSecondaryText
                 }
                 
@@ -115,7 +140,16 @@ Page {
                     
                     clip: true
                     interactive: false  // Let Flickable handle scrolling
-                    model: streamsModel
+                    model: categoryStreamsFilter
+                    onCountChanged: {
+                        updateNearRows()
+                        reportVisibleRows()
+                    }
+                    
+                    // Rows near the viewport (see updateNearRows())
+                    property int nearFirst: 0
+                    property int nearLast: -1
+                    onColumnsCountChanged: updateNearRows()
                     
                     // Responsive columns
                     property int columnsCount: {
@@ -151,11 +185,10 @@ Page {
                                     color: theme.palette.normal.base
                                     clip: true
                                     
-                                    Image {
+                                    Thumbnail {
                                         anchors.fill: parent
-                                        source: model.thumbnailUrl
-                                        fillMode: Image.PreserveAspectCrop
-                                        asynchronous: true
+                                        nearViewport: index >= streamsGrid.nearFirst && index <= streamsGrid.nearLast
+                                        url: model.thumbnailUrl
                                     }
                                     
                                     // LIVE badge and viewer count
@@ -243,7 +276,7 @@ Page {
                 Button {
                     anchors.horizontalCenter: parent.horizontalCenter
                     text: i18n.tr('Load More')
-                    visible: hasMorePages && !isLoadingMore && streamsModel.count > 0
+                    visible: hasMorePages && !isLoadingMore && categoryStreamsModel.count > 0
                     onClicked: loadMoreStreams()
                 }
                 
@@ -260,111 +293,97 @@ Page {
     function refreshStreams() {
         isRefreshing = true
         paginationCursor = ""
+        hasMorePages = false
+        categoryStreamsModel.beginRefresh()
+        var generation = categoryStreamsModel.beginRequest(categoryId)
 
         // Use GraphQL for anonymous requests (no auth required)
-        // Use Helix API for authenticated requests (better pagination)
+        // Use Helix API for authenticated requests
+        // Both page by cursor
         if (authManager.isAuthenticated) {
-            helixApi.getStreamsForGame(categoryId, 20)
+            helixApi.getStreamsForGameWithCursor(categoryId, 20, "", generation)
         } else {
-            twitchFetcher.fetchStreamsForGameGraphQL(categoryId, 20)
+            twitchFetcher.fetchStreamsForGameGraphQL(categoryId, 20, generation)
         }
     }
     
     function loadMoreStreams() {
-        if (!hasMorePages || isLoadingMore) return
+        if (!hasMorePages || isLoadingMore || isRefreshing) return
         
         isLoadingMore = true
+        var generation = categoryStreamsModel.requestGeneration()
         
-        helixApi.getStreamsForGameWithCursor(categoryId, 20, paginationCursor)
+        if (authManager.isAuthenticated) {
+            helixApi.getStreamsForGameWithCursor(categoryId, 20, paginationCursor, generation)
+        } else {
+            twitchFetcher.fetchStreamsForGameGraphQLWithCursor(categoryId, 20, paginationCursor, generation)
+        }
     }
     
     function watchStream(channelName) {
         streamRequested(channelName, "best")
     }
     
+    // Rows within a screen of the viewport, whose thumbnails may load -
+    // worked out once per frame here rather than in every delegate
+    function updateNearRows() {
+        var top = mainFlickable.contentY - streamsGrid.mapToItem(mainFlickable.contentItem, 0, 0).y
+        streamsGrid.nearFirst = Math.max(0, Math.floor((top - mainFlickable.height) / streamsGrid.cellHeight)) * streamsGrid.columnsCount
+        streamsGrid.nearLast = Math.ceil((top + mainFlickable.height * 2) / streamsGrid.cellHeight) * streamsGrid.columnsCount - 1
+    }
+    
+    // Tell the refresher which rows are on screen so their viewer counts stay current
+    function reportVisibleRows() {
+        if (!visible || streamsGrid.count === 0) {
+            viewerCountRefresher.clearVisibleRows(categoryStreamsFilter)
+            return
+        }
+        var top = mainFlickable.contentY - streamsGrid.mapToItem(mainFlickable.contentItem, 0, 0).y
+        var first = Math.max(0, Math.floor(top / streamsGrid.cellHeight)) * streamsGrid.columnsCount
+        var last = Math.ceil((top + mainFlickable.height) / streamsGrid.cellHeight) * streamsGrid.columnsCount - 1
+        viewerCountRefresher.setVisibleRows(categoryStreamsFilter, first, Math.min(last, streamsGrid.count - 1))
+    }
+    
+    onVisibleChanged: reportVisibleRows()
+    Component.onDestruction: {
+        viewerCountRefresher.clearVisibleRows(categoryStreamsFilter)
+        // Popped mid-fling: the flickable won't report the stop anymore
+        thumbnailScheduler.velocity = 0
+    }
+    
     // Load streams on component completion
     Component.onCompleted: {
+        // Shared model - don't show the previous category's streams
+        categoryStreamsModel.clear()
+        categoryStreamsFilter.query = ""
+        categoryStreamsFilter.tags = []
         if (categoryId.length > 0) {
+            // Top categories may already be prefetched: show those rows now,
+            // the refresh below updates them in place
+            idlePrefetcher.restore(categoryId, categoryStreamsModel)
             refreshStreams()
         }
     }
     
-    // Connections
+    // Connections - rows land in categoryStreamsModel (filled in C++),
+    // only the page state is tracked here
     Connections {
         target: helixApi
         ignoreUnknownSignals: true
         
-        onStreamsReceived: {
-                
-            // If refreshing, clear model. If loading more, append
-            if (isRefreshing) {
-                streamsModel.clear()
-            }
-            
-            for (var i = 0; i < streams.length; i++) {
-                var stream = streams[i]
-                
-                var thumbnailUrl = stream.thumbnail_url
-                thumbnailUrl = thumbnailUrl.replace("{width}", "440")
-                thumbnailUrl = thumbnailUrl.replace("{height}", "248")
-                
-                var viewerCount = stream.viewer_count
-                var viewerCountFormatted = viewerCount >= 1000 ? 
-                    (viewerCount / 1000).toFixed(1) + "K" : 
-                    viewerCount.toString()
-                
-                streamsModel.append({
-                    userLogin: stream.user_login,
-                    userName: stream.user_name,
-                    title: stream.title,
-                    viewerCount: viewerCount,
-                    viewerCountFormatted: viewerCountFormatted,
-                    thumbnailUrl: thumbnailUrl
-                })
-            }
-            
-            isRefreshing = false
-            isLoadingMore = false
-            
-            }
-        
         onStreamsPaginationReceived: {
-                    
-            // If refreshing, clear model. If loading more, append
-            if (isRefreshing) {
-                streamsModel.clear()
-            }
+            // Another category's page, or one from before the last refresh
+            if (gameId !== categoryId || generation !== categoryStreamsModel.requestGeneration()) return
             
-            for (var i = 0; i < streams.length; i++) {
-                var stream = streams[i]
-                
-                var thumbnailUrl = stream.thumbnail_url
-                thumbnailUrl = thumbnailUrl.replace("{width}", "440")
-                thumbnailUrl = thumbnailUrl.replace("{height}", "248")
-                
-                var viewerCount = stream.viewer_count
-                var viewerCountFormatted = viewerCount >= 1000 ? 
-                    (viewerCount / 1000).toFixed(1) + "K" : 
-                    viewerCount.toString()
-                
-                streamsModel.append({
-                    userLogin: stream.user_login,
-                    userName: stream.user_name,
-                    title: stream.title,
-                    viewerCount: viewerCount,
-                    viewerCountFormatted: viewerCountFormatted,
-                    thumbnailUrl: thumbnailUrl
-                })
-            }
+            isRefreshing = false
+            if (!complete) return
             
             // Update pagination state
             paginationCursor = cursor
             hasMorePages = cursor.length > 0
             
-            isRefreshing = false
             isLoadingMore = false
-            
-                }
+        }
         
         onError: {
             isRefreshing = false
@@ -378,39 +397,21 @@ Page {
         ignoreUnknownSignals: true
 
         onStreamsForGameReceived: {
+            if (gameId !== categoryId || generation !== categoryStreamsModel.requestGeneration()) return
 
-            // Clear model for refresh
-            if (isRefreshing) {
-                streamsModel.clear()
-            }
-
-            for (var i = 0; i < streams.length; i++) {
-                var stream = streams[i]
-
-                var thumbnailUrl = stream.thumbnail_url
-                // GraphQL already returns full URL, no need to replace placeholders
+            isRefreshing = false
+            if (!complete) return
 
-                var viewerCount = stream.viewer_count
-                var viewerCountFormatted = viewerCount >= 1000 ?
-                    (viewerCount / 1000).toFixed(1) + "K" :
-                    viewerCount.toString()
+            // Update pagination state
+            paginationCursor = cursor
+            hasMorePages = cursor.length > 0
 
-                streamsModel.append({
-                    userLogin: stream.user_login,
-                    userName: stream.user_name,
-                    title: stream.title,
-                    viewerCount: viewerCount,
-                    viewerCountFormatted: viewerCountFormatted,
-                    thumbnailUrl: thumbnailUrl
-                })
-            }
+            isLoadingMore = false
+        }
 
+        onError: {
             isRefreshing = false
             isLoadingMore = false
-
-            // GraphQL doesn't support pagination in this simple query
-            // so disable "Load More" button
-            hasMorePages = false
         }
     }
 }
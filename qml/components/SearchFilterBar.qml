@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+import QtQuick 2.15
+import Lomiri.Components 1.3
+
+/**
+ * Filter field and tag chips for a SearchFilterModel
+ *
+ * Filters on every keystroke - the index lives in C++ and answers
+ * within a frame, so there's no delay. Chips show the most common tags
+ * of the rows on screen; tapping one toggles it.
+ */
+Column {
+    id: root
+
+    // SearchFilterModel from main.cpp
+    property var filter: null
+    property alias placeholderText: queryField.placeholderText
+
+    spacing: units.gu(1)
+
+    TextField {
+        id: queryField
+        width: parent.width
+        inputMethodHints: Qt.ImhNoAutoUppercase | Qt.ImhNoPredictiveText
+        onTextChanged: if (root.filter) root.filter.query = text
+        Component.onCompleted: if (root.filter) text = root.filter.query
+    }
+
+    Flow {
+        width: parent.width
+        spacing: units.gu(1)
+        visible: root.filter !== null && root.filter.availableTags.length > 0
+
+        Repeater {
+            model: root.filter ? root.filter.availableTags : []
+
+            delegate: Rectangle {
+                readonly property bool selected: root.filter.tags.indexOf(modelData) >= 0
+
+                width: tagLabel.width + units.gu(2)
+                height: units.gu(3.5)
+                radius: height / 2
+                color: selected ? theme.palette.normal.focus : theme.palette.normal.base
+
+                Label {
+                    id: tagLabel
+                    anchors.centerIn: parent
+                    text: modelData
+                    fontSize: "small"
+                    color: parent.selected ? theme.palette.normal.focusText : theme.palette.normal.baseText
+                }
+
+                MouseArea {
+                    anchors.fill: parent
+                    onClicked: root.filter.toggleTag(modelData)
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+import QtQuick 2.15
+
+/**
+ * Stream preview / box art through the "thumbs" image provider
+ *
+ * Asks for a rendition matching the drawn size instead of the fixed
+ * 440px one. A tiny version shows first and the sized one fades in over
+ * it once decoded.
+ *
+ * Nothing is requested while 'nearViewport' is false, and it turning
+ * false cancels a pending load (the grids are full height, so delegates
+ * are never recycled). Pages bind it to a row window they update once
+ * per frame, see updateNearRows().
+ */
+Item {
+    id: root
+
+    // Plain CDN url from the model
+    property string url: ""
+    property int fillMode: Image.PreserveAspectCrop
+    property bool nearViewport: true
+
+    readonly property string providerSource: url && nearViewport ? "image://thumbs/" + url : ""
+    readonly property bool ready: full.status === Image.Ready
+
+    Image {
+        id: preview
+        anchors.fill: parent
+        // Dropped once the full image is there
+        source: root.ready ? "" : root.providerSource
+        sourceSize.width: 40
+        fillMode: root.fillMode
+        asynchronous: true
+        smooth: true
+    }
+
+    Image {
+        id: full
+        anchors.fill: parent
+        source: root.width > 0 && root.height > 0 ? root.providerSource : ""
+        sourceSize.width: Math.ceil(root.width)
+        sourceSize.height: Math.ceil(root.height)
+        fillMode: root.fillMode
+        asynchronous: true
+        opacity: root.ready ? 1 : 0
+
+        Behavior on opacity {
+            NumberAnimation { duration: 150 }
+        }
+    }
+}
@@ -0,0 +1,444 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "eventsubclient.h"
+#include "helixlookupaggregator.h"
+#include "../core/config.h"
+#include "../core/logging.h"
+#include <QJsonDocument>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QUrlQuery>
+
+const int EventSubClient::KEEPALIVE_SECONDS;
+const int EventSubClient::KEEPALIVE_SLACK_MS;
+const int EventSubClient::MAX_RECONNECT_DELAY_MS;
+const int EventSubClient::RECENT_MESSAGE_IDS;
+const int EventSubClient::LOOKUP_RETRY_MS;
+const int EventSubClient::MAX_LOOKUP_ATTEMPTS;
+
+EventSubClient::EventSubClient(HelixLookupAggregator *lookup, QObject *parent)
+    : QObject(parent)
+    , m_socket(nullptr)
+    , m_nextSocket(nullptr)
+    , m_http(new QNetworkAccessManager(this))
+    , m_lookup(lookup)
+    , m_keepaliveTimer(new QTimer(this))
+    , m_reconnectTimer(new QTimer(this))
+    , m_active(false)
+    , m_failures(0)
+    , m_subscribing(false)
+    , m_limitReached(false)
+{
+    m_keepaliveTimer->setSingleShot(true);
+    m_keepaliveTimer->setInterval(KEEPALIVE_SECONDS * 1000 + KEEPALIVE_SLACK_MS);
+    connect(m_keepaliveTimer, &QTimer::timeout, this, &EventSubClient::onKeepaliveTimeout);
+
+    m_reconnectTimer->setSingleShot(true);
+    connect(m_reconnectTimer, &QTimer::timeout, this, &EventSubClient::openSocket);
+}
+
+EventSubClient::~EventSubClient()
+{
+    closeSocket();
+}
+
+void EventSubClient::setAuthToken(const QString &token)
+{
+    if (token == m_authToken) {
+        return;
+    }
+    m_authToken = token;
+
+    if (token.isEmpty()) {
+        m_reconnectTimer->stop();
+        closeSocket();
+        setActive(false);
+    } else if (!m_socket && !m_reconnectTimer->isActive()) {
+        openSocket();
+    } else {
+        // A refreshed token keeps the session; subscriptions belong to it.
+        // Channels the old token wasn't authorized for get another try
+        subscribeMissing();
+    }
+}
+
+void EventSubClient::setChannels(const QStringList &userIds)
+{
+    m_channels = userIds;
+
+    if (!m_socket && !m_reconnectTimer->isActive()) {
+        openSocket();
+    } else {
+        subscribeMissing();
+    }
+}
+
+void EventSubClient::setActive(bool active)
+{
+    if (m_active == active) {
+        return;
+    }
+    m_active = active;
+    emit activeChanged(active);
+}
+
+// ========================================
+// SOCKET
+// ========================================
+
+QUrl EventSubClient::socketUrl()
+{
+    QString override = qEnvironmentVariable("TWITCHVIEWER_EVENTSUB_WS");
+    QUrl url(override.isEmpty() ? QStringLiteral("wss://eventsub.wss.twitch.tv/ws") : override);
+
+    // Fewer keepalives than the default 10s, still well below a TCP timeout
+    QUrlQuery query(url);
+    query.addQueryItem("keepalive_timeout_seconds", QString::number(KEEPALIVE_SECONDS));
+    url.setQuery(query);
+    return url;
+}
+
+QUrl EventSubClient::subscriptionsUrl()
+{
+    QString override = qEnvironmentVariable("TWITCHVIEWER_EVENTSUB_API");
+    return QUrl(override.isEmpty() ? QStringLiteral("https://api.twitch.tv/helix/eventsub/subscriptions")
+                                   : override);
+}
+
+void EventSubClient::openSocket()
+{
+    if (m_authToken.isEmpty() || m_channels.isEmpty()) {
+        return;
+    }
+
+    closeSocket();
+    LOG_API("EventSub connecting");
+    m_socket = createSocket(socketUrl());
+
+    // The welcome message has to arrive within one keepalive period too
+    m_keepaliveTimer->start();
+}
+
+QWebSocket *EventSubClient::createSocket(const QUrl &url)
+{
+    QWebSocket *socket = new QWebSocket(QString(), QWebSocketProtocol::VersionLatest, this);
+    connect(socket, &QWebSocket::textMessageReceived, this, &EventSubClient::onTextMessageReceived);
+    connect(socket, &QWebSocket::disconnected, this, &EventSubClient::onDisconnected);
+    socket->open(url);
+    return socket;
+}
+
+void EventSubClient::closeSocket()
+{
+    for (QWebSocket *socket : {m_socket, m_nextSocket}) {
+        if (socket) {
+            disconnect(socket, nullptr, this, nullptr);
+            socket->abort();
+            socket->deleteLater();
+        }
+    }
+    m_socket = nullptr;
+    m_nextSocket = nullptr;
+
+    m_keepaliveTimer->stop();
+    m_sessionId.clear();
+    m_subscribeQueue.clear();
+    m_subscribed.clear();
+    m_subscribing = false;
+    m_limitReached = false;
+}
+
+void EventSubClient::scheduleReconnect()
+{
+    if (m_authToken.isEmpty()) {
+        return;
+    }
+
+    m_failures++;
+    int delay = qMin(1000 << qMin(m_failures, 9), MAX_RECONNECT_DELAY_MS);
+    WARN_API("EventSub reconnect in" << delay << "ms (attempt" << m_failures << ")");
+    m_reconnectTimer->start(delay);
+}
+
+void EventSubClient::onDisconnected()
+{
+    QWebSocket *socket = qobject_cast<QWebSocket*>(sender());
+
+    // A failed reconnect target; the old socket keeps serving
+    if (socket && socket == m_nextSocket) {
+        m_nextSocket->deleteLater();
+        m_nextSocket = nullptr;
+        return;
+    }
+    if (!socket || socket != m_socket) {
+        return;
+    }
+
+    WARN_API("EventSub socket closed:" << socket->closeCode() << socket->closeReason());
+    closeSocket();
+    setActive(false);
+    scheduleReconnect();
+}
+
+void EventSubClient::onKeepaliveTimeout()
+{
+    WARN_API("EventSub keepalive missed");
+    closeSocket();
+    setActive(false);
+    scheduleReconnect();
+}
+
+// ========================================
+// MESSAGES
+// ========================================
+
+void EventSubClient::onTextMessageReceived(const QString &message)
+{
+    QWebSocket *socket = qobject_cast<QWebSocket*>(sender());
+
+    QJsonObject root = QJsonDocument::fromJson(message.toUtf8()).object();
+    QJsonObject metadata = root["metadata"].toObject();
+    QJsonObject payload = root["payload"].toObject();
+    QString type = metadata["message_type"].toString();
+
+    // Any message proves the socket alive
+    if (socket == m_socket) {
+        m_keepaliveTimer->start();
+    }
+
+    // Delivery is at-least-once
+    QString messageId = metadata["message_id"].toString();
+    if (!messageId.isEmpty()) {
+        if (m_recentMessageIds.contains(messageId)) {
+            return;
+        }
+        m_recentMessageIds.append(messageId);
+        if (m_recentMessageIds.size() > RECENT_MESSAGE_IDS) {
+            m_recentMessageIds.removeFirst();
+        }
+    }
+
+    if (type == "session_welcome") {
+        handleWelcome(socket, payload["session"].toObject());
+    } else if (type == "notification") {
+        handleNotification(metadata["subscription_type"].toString(), payload["event"].toObject());
+    } else if (type == "session_reconnect") {
+        QUrl url(payload["session"].toObject()["reconnect_url"].toString());
+        LOG_API("EventSub reconnect requested");
+        if (m_nextSocket) {
+            disconnect(m_nextSocket, nullptr, this, nullptr);
+            m_nextSocket->abort();
+            m_nextSocket->deleteLater();
+        }
+        m_nextSocket = createSocket(url);
+    } else if (type == "revocation") {
+        QJsonObject subscription = payload["subscription"].toObject();
+        QString userId = subscription["condition"].toObject()["broadcaster_user_id"].toString();
+        WARN_API("EventSub subscription revoked:" << subscription["type"].toString()
+                 << userId << subscription["status"].toString());
+        m_subscribed.remove(userId);
+    }
+}
+
+void EventSubClient::handleWelcome(QWebSocket *socket, const QJsonObject &session)
+{
+    QString sessionId = session["id"].toString();
+
+    if (socket && socket == m_nextSocket) {
+        // Subscriptions moved over with the session; drop the old socket
+        QWebSocket *old = m_socket;
+        if (old) {
+            disconnect(old, nullptr, this, nullptr);
+            old->close();
+            old->deleteLater();
+        }
+        m_socket = m_nextSocket;
+        m_nextSocket = nullptr;
+        m_sessionId = sessionId;
+        m_keepaliveTimer->start();
+        LOG_API("EventSub reconnected");
+        return;
+    }
+    if (socket != m_socket) {
+        return;
+    }
+
+    int keepalive = session["keepalive_timeout_seconds"].toInt(KEEPALIVE_SECONDS);
+    m_keepaliveTimer->setInterval(keepalive * 1000 + KEEPALIVE_SLACK_MS);
+    m_keepaliveTimer->start();
+
+    m_sessionId = sessionId;
+    m_failures = 0;
+    m_subscribed.clear();
+    m_limitReached = false;
+    LOG_API("EventSub session" << m_sessionId << "keepalive" << keepalive << "s");
+
+    setActive(true);
+    subscribeMissing();
+}
+
+void EventSubClient::handleNotification(const QString &type, const QJsonObject &event)
+{
+    QString userId = event["broadcaster_user_id"].toString();
+    if (userId.isEmpty()) {
+        return;
+    }
+
+    if (type == "stream.online") {
+        LOG_API("EventSub:" << event["broadcaster_user_login"].toString() << "went live");
+        m_lookupAttempts[userId] = 0;
+        lookup(userId);
+    } else if (type == "stream.offline") {
+        LOG_API("EventSub:" << event["broadcaster_user_login"].toString() << "went offline");
+        m_lookupAttempts.remove(userId);
+        emit wentOffline(QStringList{userId});
+    }
+}
+
+// ========================================
+// SUBSCRIPTIONS
+// ========================================
+
+void EventSubClient::subscribeMissing()
+{
+    if (m_sessionId.isEmpty() || m_limitReached) {
+        return;
+    }
+
+    for (const QString &userId : qAsConst(m_channels)) {
+        if (m_subscribed.contains(userId)) {
+            continue;
+        }
+        m_subscribed.insert(userId);
+        m_subscribeQueue.append(Subscription{QStringLiteral("stream.online"), userId});
+        m_subscribeQueue.append(Subscription{QStringLiteral("stream.offline"), userId});
+    }
+
+    subscribeNext();
+}
+
+void EventSubClient::subscribeNext()
+{
+    if (m_subscribing || m_subscribeQueue.isEmpty() || m_sessionId.isEmpty()) {
+        return;
+    }
+
+    Subscription subscription = m_subscribeQueue.takeFirst();
+
+    QJsonObject body;
+    body["type"] = subscription.type;
+    body["version"] = "1";
+    body["condition"] = QJsonObject{{"broadcaster_user_id", subscription.userId}};
+    body["transport"] = QJsonObject{{"method", "websocket"}, {"session_id", m_sessionId}};
+
+    // Same Client-ID the token was issued for (see TwitchHelixAPI::createRequest)
+    QNetworkRequest request(subscriptionsUrl());
+    request.setRawHeader("Client-ID", Config::TWITCH_CLIENT_ID.toUtf8());
+    request.setRawHeader("Authorization", QString("Bearer %1").arg(m_authToken).toUtf8());
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+
+    QNetworkReply *reply = m_http->post(request, QJsonDocument(body).toJson(QJsonDocument::Compact));
+    reply->setProperty("sessionId", m_sessionId);
+    reply->setProperty("userId", subscription.userId);
+    m_subscribing = true;
+    connect(reply, &QNetworkReply::finished, this, &EventSubClient::onSubscriptionFinished);
+}
+
+void EventSubClient::onSubscriptionFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    reply->deleteLater();
+
+    // Session replaced while this was in flight
+    if (reply->property("sessionId").toString() != m_sessionId) {
+        return;
+    }
+    m_subscribing = false;
+
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    QString userId = reply->property("userId").toString();
+
+    if (status == 202 || status == 409) {
+        // Created, or already there
+    } else if (status == 429) {
+        // Cost limit of this session; the poller keeps covering the rest
+        m_limitReached = true;
+        for (const Subscription &pending : qAsConst(m_subscribeQueue)) {
+            m_subscribed.remove(pending.userId);
+        }
+        m_subscribeQueue.clear();
+        LOG_API("EventSub subscription limit reached," << m_subscribed.size()
+                << "of" << m_channels.size() << "channels pushed");
+        return;
+    } else if (status == 401 || status == 403) {
+        // Nothing else goes through with this token; setAuthToken() retries
+        WARN_API("EventSub subscription not authorized:" << reply->readAll());
+        m_subscribed.remove(userId);
+        for (const Subscription &pending : qAsConst(m_subscribeQueue)) {
+            m_subscribed.remove(pending.userId);
+        }
+        m_subscribeQueue.clear();
+        return;
+    } else {
+        WARN_API("EventSub subscription failed for" << userId << "HTTP" << status
+                 << reply->errorString());
+        m_subscribed.remove(userId);
+    }
+
+    subscribeNext();
+}
+
+// ========================================
+// STREAM LOOKUP
+// ========================================
+
+void EventSubClient::lookup(const QString &userId)
+{
+    m_lookupAttempts[userId]++;
+    m_lookup->lookup(HelixLookupAggregator::StreamById, userId, this,
+        [this, userId](const QJsonObject &stream) {
+            onStreamLookedUp(userId, stream);
+        });
+}
+
+void EventSubClient::onStreamLookedUp(const QString &userId, const QJsonObject &stream)
+{
+    if (!stream.isEmpty()) {
+        m_lookupAttempts.remove(userId);
+        emit wentLive(QVector<StreamInfo>{StreamInfo::fromJson(stream)});
+        return;
+    }
+
+    // Went offline again in the meantime
+    if (!m_lookupAttempts.contains(userId)) {
+        return;
+    }
+
+    // stream.online can beat the stream into /streams by a few seconds
+    if (m_lookupAttempts.value(userId) >= MAX_LOOKUP_ATTEMPTS) {
+        WARN_API("EventSub: no stream listed for" << userId << "after going live");
+        m_lookupAttempts.remove(userId);
+        return;
+    }
+    QTimer::singleShot(LOOKUP_RETRY_MS, this, [this, userId]() {
+        if (m_lookupAttempts.contains(userId)) {
+            lookup(userId);
+        }
+    });
+}
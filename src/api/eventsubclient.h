@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EVENTSUBCLIENT_H
+#define EVENTSUBCLIENT_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QUrl>
+#include <QVector>
+#include <QNetworkAccessManager>
+#include <QWebSocket>
+#include "../models/streaminfo.h"
+
+class HelixLookupAggregator;
+
+/**
+ * EventSubClient - Push notifications for followed channels going live
+ *
+ * Purpose: Learn about stream.online / stream.offline as they happen
+ * instead of waiting for the next FollowedLivePoller round.
+ *
+ * Features:
+ * - One EventSub WebSocket session; subscriptions are created over Helix
+ *   with the user's OAuth token once the welcome message names the session
+ * - Keepalive watchdog: no message within the negotiated timeout counts
+ *   as a dead socket
+ * - session_reconnect is followed without a gap: the new socket takes
+ *   over (with its subscriptions) once it has been welcomed
+ * - Reconnects with backoff; 'active' is false while the socket is down,
+ *   so the poller goes back to its normal interval
+ * - Twitch caps what a WebSocket session may subscribe to; channels past
+ *   the cap stay with the poller
+ * - Stream rows for stream.online go through the shared
+ *   HelixLookupAggregator, so channels going live together cost one
+ *   /streams request
+ *
+ * For testing, TWITCHVIEWER_EVENTSUB_WS and TWITCHVIEWER_EVENTSUB_API
+ * point the socket and the subscription endpoint at a local stand-in
+ * (e.g. "twitch event websocket start-server" replaying recorded events).
+ * tests/tst_eventsubclient does that with a recorded session.
+ */
+class EventSubClient : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool active READ isActive NOTIFY activeChanged)
+
+public:
+    explicit EventSubClient(HelixLookupAggregator *lookup, QObject *parent = nullptr);
+    ~EventSubClient();
+
+    void setAuthToken(const QString &token);
+
+    // Channels to subscribe to (followed channel IDs)
+    void setChannels(const QStringList &userIds);
+
+    bool isActive() const { return m_active; }
+
+signals:
+    void activeChanged(bool active);
+
+    // Full stream rows, looked up once Helix lists the new broadcast
+    void wentLive(const QVector<StreamInfo> &streams);
+    void wentOffline(const QStringList &userIds);
+
+private slots:
+    void onTextMessageReceived(const QString &message);
+    void onDisconnected();
+    void onKeepaliveTimeout();
+    void onSubscriptionFinished();
+    void openSocket();
+
+private:
+    QWebSocket *m_socket;
+    QWebSocket *m_nextSocket;       // session_reconnect target until welcomed
+    QNetworkAccessManager *m_http;
+    HelixLookupAggregator *m_lookup;
+    QTimer *m_keepaliveTimer;
+    QTimer *m_reconnectTimer;
+
+    QString m_authToken;
+    QStringList m_channels;
+    QString m_sessionId;
+    bool m_active;
+    int m_failures;
+
+    // Subscriptions of the current session, created one at a time
+    struct Subscription {
+        QString type;
+        QString userId;
+    };
+    QVector<Subscription> m_subscribeQueue;
+    QSet<QString> m_subscribed;     // channels queued or subscribed
+    bool m_subscribing;
+    bool m_limitReached;
+
+    QStringList m_recentMessageIds;
+    QHash<QString, int> m_lookupAttempts;   // user id -> lookups so far
+
+    static const int KEEPALIVE_SECONDS = 30;
+    static const int KEEPALIVE_SLACK_MS = 5000;
+    static const int MAX_RECONNECT_DELAY_MS = 300000;
+    static const int RECENT_MESSAGE_IDS = 64;
+    static const int LOOKUP_RETRY_MS = 5000;
+    static const int MAX_LOOKUP_ATTEMPTS = 3;
+
+    static QUrl socketUrl();
+    static QUrl subscriptionsUrl();
+
+    QWebSocket *createSocket(const QUrl &url);
+    void closeSocket();
+    void scheduleReconnect();
+    void setActive(bool active);
+
+    void handleWelcome(QWebSocket *socket, const QJsonObject &session);
+    void handleNotification(const QString &type, const QJsonObject &event);
+    void subscribeMissing();
+    void subscribeNext();
+    void lookup(const QString &userId);
+    void onStreamLookedUp(const QString &userId, const QJsonObject &stream);
+};
+
+#endif // EVENTSUBCLIENT_H
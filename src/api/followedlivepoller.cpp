@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "followedlivepoller.h"
+#include "twitchhelixapi.h"
+#include "../core/applifecycle.h"
+#include "../core/logging.h"
+#include <QSet>
+
+const int FollowedLivePoller::IDS_PER_REQUEST;
+const int FollowedLivePoller::POLL_INTERVAL_MS;
+const int FollowedLivePoller::MAX_IDLE_INTERVAL_MS;
+const int FollowedLivePoller::QUIET_ROUNDS_PER_STEP;
+const int FollowedLivePoller::BACKGROUND_INTERVAL_MS;
+const int FollowedLivePoller::CHANNELS_REFRESH_MS;
+
+FollowedLivePoller::FollowedLivePoller(AppLifecycle *lifecycle, QObject *parent)
+    : QObject(parent)
+    , m_api(new TwitchHelixAPI(this))
+    , m_lifecycle(lifecycle)
+    , m_timer(new QTimer(this))
+    , m_loadingChannels(false)
+    , m_hasBaseline(false)
+    , m_pendingRequests(0)
+    , m_roundFailed(false)
+    , m_quietRounds(0)
+    , m_pushActive(false)
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &FollowedLivePoller::poll);
+
+    connect(m_api, &TwitchHelixAPI::followedChannelsReceived,
+            this, &FollowedLivePoller::onFollowedChannelsReceived);
+    connect(m_api, &TwitchHelixAPI::streamsForUsersReceived,
+            this, &FollowedLivePoller::onStreamsForUsersReceived);
+    connect(m_api, &TwitchHelixAPI::error, this, &FollowedLivePoller::onApiError);
+
+    if (m_lifecycle) {
+        connect(m_lifecycle, &AppLifecycle::foregroundChanged,
+                this, &FollowedLivePoller::onForegroundChanged);
+    }
+}
+
+void FollowedLivePoller::setNetworkManager(NetworkManager *networkManager)
+{
+    m_api->setNetworkManager(networkManager);
+}
+
+void FollowedLivePoller::setAuthToken(const QString &token)
+{
+    m_api->setAuthToken(token);
+    m_authToken = token;
+
+    if (token.isEmpty()) {
+        m_timer->stop();
+    } else if (!m_userId.isEmpty() && !m_timer->isActive()) {
+        poll();
+    }
+}
+
+void FollowedLivePoller::setUserId(const QString &userId)
+{
+    if (userId == m_userId) {
+        return;
+    }
+
+    reset();
+    m_userId = userId;
+    if (!m_userId.isEmpty()) {
+        poll();
+    }
+}
+
+void FollowedLivePoller::setPushActive(bool active)
+{
+    if (m_pushActive == active) {
+        return;
+    }
+    m_pushActive = active;
+
+    // Push went away: don't sit out a long reconcile interval
+    if (!active && m_timer->isActive() && m_timer->remainingTime() > interval()) {
+        m_timer->start(interval());
+    }
+}
+
+void FollowedLivePoller::reset()
+{
+    m_timer->stop();
+    m_channelIds.clear();
+    m_channelsAge.invalidate();
+    m_loadingChannels = false;
+    m_live.clear();
+    m_hasBaseline = false;
+    m_roundLive.clear();
+    m_pendingRequests = 0;
+    m_roundFailed = false;
+    m_lastPoll.invalidate();
+    m_quietRounds = 0;
+}
+
+// ========================================
+// ROUNDS
+// ========================================
+
+void FollowedLivePoller::poll()
+{
+    if (m_userId.isEmpty() || m_authToken.isEmpty()) {
+        return;
+    }
+
+    // A round whose replies never came back must not stop polling
+    bool busy = m_loadingChannels || m_pendingRequests > 0;
+    if (busy && m_lastPoll.isValid() && m_lastPoll.elapsed() < POLL_INTERVAL_MS) {
+        scheduleNext();
+        return;
+    }
+
+    if (!m_channelsAge.isValid() || m_channelsAge.elapsed() > CHANNELS_REFRESH_MS) {
+        m_loadingChannels = true;
+        m_pendingRequests = 0;
+        m_lastPoll.start();
+        m_api->getFollowedChannels(m_userId);
+        return;
+    }
+
+    m_lastPoll.start();
+    m_roundLive.clear();
+    m_roundFailed = false;
+    m_pendingRequests = 0;
+
+    if (m_channelIds.isEmpty()) {
+        finishRound();
+        return;
+    }
+
+    // Count first: a reply may in theory be delivered before the loop ends
+    int requests = (m_channelIds.size() + IDS_PER_REQUEST - 1) / IDS_PER_REQUEST;
+    m_pendingRequests = requests;
+    for (int i = 0; i < requests; ++i) {
+        m_api->getStreamsForUsers(m_channelIds.mid(i * IDS_PER_REQUEST, IDS_PER_REQUEST));
+    }
+}
+
+void FollowedLivePoller::onFollowedChannelsReceived(const QStringList &userIds)
+{
+    if (!m_loadingChannels) {
+        return;
+    }
+    m_loadingChannels = false;
+    m_channelIds = userIds;
+    m_channelsAge.start();
+
+    // Unfollowed channels just disappear, they didn't go offline
+    QSet<QString> followed(userIds.cbegin(), userIds.cend());
+    for (auto it = m_live.begin(); it != m_live.end(); ) {
+        if (followed.contains(it.key())) {
+            ++it;
+        } else {
+            it = m_live.erase(it);
+        }
+    }
+
+    emit channelsChanged(m_channelIds);
+
+    m_lastPoll.invalidate();
+    poll();
+}
+
+void FollowedLivePoller::onStreamsForUsersReceived(const QStringList &userIds,
+                                                   const QVector<StreamInfo> &streams)
+{
+    Q_UNUSED(userIds);
+
+    if (m_pendingRequests == 0) {
+        return;
+    }
+
+    for (const StreamInfo &stream : streams) {
+        m_roundLive.insert(stream.userId, stream);
+    }
+
+    if (--m_pendingRequests == 0) {
+        finishRound();
+    }
+}
+
+void FollowedLivePoller::onApiError(const QString &message)
+{
+    if (m_loadingChannels) {
+        WARN_API("Followed channel list failed:" << message);
+        m_loadingChannels = false;
+        scheduleNext();
+        return;
+    }
+
+    if (m_pendingRequests == 0) {
+        return;
+    }
+
+    m_roundFailed = true;
+    if (--m_pendingRequests == 0) {
+        finishRound();
+    }
+}
+
+void FollowedLivePoller::finishRound()
+{
+    QHash<QString, StreamInfo> current;
+    current.swap(m_roundLive);
+
+    // Missing rows would look like channels going offline
+    if (m_roundFailed) {
+        WARN_API("Live status round incomplete, keeping previous state");
+        m_roundFailed = false;
+        scheduleNext();
+        return;
+    }
+
+    if (!m_hasBaseline) {
+        m_live = current;
+        m_hasBaseline = true;
+        LOG_API("Followed live status:" << m_live.size() << "of" << m_channelIds.size() << "live");
+        scheduleNext();
+        return;
+    }
+
+    QVector<StreamInfo> live;
+    QVector<StreamInfo> offline;
+    QVector<StreamInfo> updated;
+
+    for (auto it = current.cbegin(); it != current.cend(); ++it) {
+        auto old = m_live.constFind(it.key());
+        if (old == m_live.constEnd()) {
+            live.append(it.value());
+        } else if (old->id != it->id || old->title != it->title || old->gameId != it->gameId
+                   || old->viewerCount != it->viewerCount) {
+            updated.append(it.value());
+        }
+    }
+    for (auto it = m_live.cbegin(); it != m_live.cend(); ++it) {
+        if (!current.contains(it.key())) {
+            offline.append(it.value());
+        }
+    }
+
+    m_live = current;
+
+    // Viewer counts always drift; only live/offline counts as activity
+    if (live.isEmpty() && offline.isEmpty()) {
+        m_quietRounds++;
+    } else {
+        m_quietRounds = 0;
+        LOG_API("Followed live status:" << live.size() << "went live," << offline.size() << "went offline");
+    }
+
+    if (!live.isEmpty()) {
+        emit wentLive(live);
+    }
+    if (!offline.isEmpty()) {
+        emit wentOffline(offline);
+    }
+    if (!updated.isEmpty()) {
+        emit changed(updated);
+    }
+
+    scheduleNext();
+}
+
+// ========================================
+// BACKOFF
+// ========================================
+
+int FollowedLivePoller::interval() const
+{
+    if (m_lifecycle && !m_lifecycle->isForeground()) {
+        return BACKGROUND_INTERVAL_MS;
+    }
+    if (m_pushActive) {
+        return MAX_IDLE_INTERVAL_MS;
+    }
+
+    // Doubles every QUIET_ROUNDS_PER_STEP rounds without a live/offline change
+    int steps = qMin(m_quietRounds / QUIET_ROUNDS_PER_STEP, 3);
+    return qMin(POLL_INTERVAL_MS << steps, MAX_IDLE_INTERVAL_MS);
+}
+
+void FollowedLivePoller::scheduleNext()
+{
+    if (m_userId.isEmpty() || m_authToken.isEmpty()) {
+        return;
+    }
+    m_timer->start(interval());
+}
+
+void FollowedLivePoller::onForegroundChanged(bool foreground)
+{
+    if (m_userId.isEmpty() || m_authToken.isEmpty()) {
+        return;
+    }
+
+    if (!foreground) {
+        if (m_timer->isActive()) {
+            m_timer->start(BACKGROUND_INTERVAL_MS);
+        }
+        return;
+    }
+
+    // Back in front: catch up right away if a round is due
+    m_quietRounds = 0;
+    if (!m_lastPoll.isValid() || m_lastPoll.elapsed() >= POLL_INTERVAL_MS) {
+        poll();
+    } else if (m_timer->isActive()) {
+        m_timer->start(POLL_INTERVAL_MS - int(m_lastPoll.elapsed()));
+    }
+}
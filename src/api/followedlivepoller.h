@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FOLLOWEDLIVEPOLLER_H
+#define FOLLOWEDLIVEPOLLER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include "../models/streaminfo.h"
+
+class TwitchHelixAPI;
+class AppLifecycle;
+class NetworkManager;
+
+/**
+ * FollowedLivePoller - Notices followed channels going live or offline
+ *
+ * Purpose: The followed list only refreshed when the user asked for it,
+ * so a channel going live went unnoticed until the next pull-to-refresh.
+ *
+ * Features:
+ * - Polls /streams?user_id= for the followed channels, 100 IDs per
+ *   request, so a round costs followed/100 requests
+ * - The followed channel list itself is re-read every 30 minutes
+ * - Only deltas are reported: wentLive, wentOffline and changed (title,
+ *   category or viewer count); the first round just sets the baseline
+ * - Backs off while nothing goes live or offline, and polls rarely
+ *   while the app is in the background or EventSub pushes are active
+ *
+ * Uses its own TwitchHelixAPI so its replies don't reach the page
+ * handlers listening on the shared one.
+ */
+class FollowedLivePoller : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FollowedLivePoller(AppLifecycle *lifecycle, QObject *parent = nullptr);
+
+    void setNetworkManager(NetworkManager *networkManager);
+    void setAuthToken(const QString &token);
+
+    // Starts polling for this user; empty stops it
+    void setUserId(const QString &userId);
+
+    // EventSub is delivering go-live pushes: only reconcile now and then
+    void setPushActive(bool active);
+
+signals:
+    // Followed channel IDs, whenever the list was (re)read
+    void channelsChanged(const QStringList &userIds);
+
+    void wentLive(const QVector<StreamInfo> &streams);
+    void wentOffline(const QVector<StreamInfo> &streams);   // last known info
+    void changed(const QVector<StreamInfo> &streams);
+
+private slots:
+    void poll();
+    void onFollowedChannelsReceived(const QStringList &userIds);
+    void onStreamsForUsersReceived(const QStringList &userIds, const QVector<StreamInfo> &streams);
+    void onApiError(const QString &message);
+    void onForegroundChanged(bool foreground);
+
+private:
+    TwitchHelixAPI *m_api;
+    AppLifecycle *m_lifecycle;
+    QTimer *m_timer;
+
+    QString m_userId;
+    QString m_authToken;
+
+    // Followed channels, re-read every CHANNELS_REFRESH_MS
+    QStringList m_channelIds;
+    QElapsedTimer m_channelsAge;
+    bool m_loadingChannels;
+
+    // Last complete round, user id -> stream
+    QHash<QString, StreamInfo> m_live;
+    bool m_hasBaseline;
+
+    // Round in progress
+    QHash<QString, StreamInfo> m_roundLive;
+    int m_pendingRequests;
+    bool m_roundFailed;
+
+    QElapsedTimer m_lastPoll;
+    int m_quietRounds;
+    bool m_pushActive;
+
+    static const int IDS_PER_REQUEST = 100;
+    static const int POLL_INTERVAL_MS = 60000;
+    static const int MAX_IDLE_INTERVAL_MS = 300000;
+    static const int QUIET_ROUNDS_PER_STEP = 5;
+    static const int BACKGROUND_INTERVAL_MS = 600000;
+    static const int CHANNELS_REFRESH_MS = 1800000;
+
+    void reset();
+    void finishRound();
+    void scheduleNext();
+    int interval() const;
+};
+
+#endif // FOLLOWEDLIVEPOLLER_H
@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "gqloperations.h"
+#include "../core/config.h"
+#include <QUrl>
+#include <QVector>
+
+namespace {
+
+struct OperationDef
+{
+    const char *name;
+    const char *hash;       // persisted query, or nullptr to send 'query'
+    const char *query;      // only for operations without a hash
+    const char *variables;  // compact JSON with %1..%9 slots
+};
+
+// Indexed by GqlOperations::Operation
+const OperationDef OPERATIONS[GqlOperations::OperationCount] = {
+    {
+        "PlaybackAccessToken",
+        "0828119ded1c13477966434e15800ff57ddacf13ba1911c129dc2200705b0712",
+        nullptr,
+        R"({"isLive":%1,"login":%2,"isVod":%3,"vodID":%4,"playerType":"site"})"
+    },
+    {
+        "UserMenuCurrentUser",
+        "3cff634f43c5c78830907a662b315b1847cfc0dce32e6a9752e7f5d70b37f8c0",
+        nullptr,
+        R"({})"
+    },
+    {
+        "BrowsePage_AllDirectories",
+        "2f67f71ba89f3c0ed26a141ec00da1defecb2303595f5cda4298169549783d9e",
+        nullptr,
+        R"({"limit":%1,"options":{"recommendationsContext":{"platform":"web"},)"
+        R"("requestID":"JIRA-VXP-2397","sort":"RELEVANCE","tags":[]}})"
+    },
+    {
+        // Twitch's own DirectoryPage_Game is keyed by slug, not game id
+        "GameStreams",
+        nullptr,
+        "query GameStreams($id:ID!,$first:Int,$after:Cursor){game(id:$id){id name "
+        "streams(first:$first,after:$after){edges{cursor node{id title viewersCount "
+        "previewImageURL(width:440,height:248) "
+        "broadcaster{id login displayName}}}pageInfo{hasNextPage}}}}",
+        R"({"id":%1,"first":%2,"after":%3})"
+    },
+    {
+        // Viewer count refresh; sent batched, one per visible category
+        "GameViewers",
+        nullptr,
+        "query GameViewers($id:ID!){game(id:$id){id viewersCount}}",
+        R"({"id":%1})"
+    },
+    {
+        // Same for streams when there's no OAuth token for Helix
+        "StreamViewers",
+        nullptr,
+        "query StreamViewers($id:ID!){user(id:$id){id stream{viewersCount}}}",
+        R"({"id":%1})"
+    }
+};
+
+// Template split at its slots: parts[0] %slots[0] parts[1] ... parts[n]
+struct CompiledOperation
+{
+    QVector<QByteArray> parts;
+    QVector<int> slots;     // 0-based index into the values
+    int fixedSize = 0;
+};
+
+CompiledOperation compile(const OperationDef &def)
+{
+    QByteArray head = QByteArray("{\"operationName\":\"") + def.name + "\",";
+    if (!def.hash) {
+        head += "\"query\":" + GqlOperations::string(QString::fromLatin1(def.query)) + ",";
+    }
+    head += "\"variables\":";
+
+    QByteArray tail = "}";
+    if (def.hash) {
+        tail = QByteArray(",\"extensions\":{\"persistedQuery\":{\"version\":1,\"sha256Hash\":\"")
+               + def.hash + "\"}}}";
+    }
+
+    CompiledOperation compiled;
+    QByteArray current = head;
+    const char *p = def.variables;
+    for (; *p; ++p) {
+        if (*p == '%' && p[1] >= '1' && p[1] <= '9') {
+            compiled.parts.append(current);
+            compiled.slots.append(p[1] - '1');
+            current.clear();
+            ++p;
+        } else {
+            current.append(*p);
+        }
+    }
+    compiled.parts.append(current + tail);
+
+    for (const QByteArray &part : compiled.parts) {
+        compiled.fixedSize += part.size();
+    }
+    return compiled;
+}
+
+const QVector<CompiledOperation> &compiledOperations()
+{
+    static const QVector<CompiledOperation> compiled = [] {
+        QVector<CompiledOperation> result;
+        for (const OperationDef &def : OPERATIONS) {
+            result.append(compile(def));
+        }
+        return result;
+    }();
+    return compiled;
+}
+
+} // namespace
+
+const char *GqlOperations::name(Operation op)
+{
+    return OPERATIONS[op].name;
+}
+
+QByteArray GqlOperations::payload(Operation op, std::initializer_list<QByteArray> values)
+{
+    const CompiledOperation &compiled = compiledOperations()[op];
+    const QByteArray *args = values.begin();
+    const int argCount = int(values.size());
+
+    int size = compiled.fixedSize;
+    for (int slot : compiled.slots) {
+        size += slot < argCount ? args[slot].size() : 4;
+    }
+
+    QByteArray data;
+    data.reserve(size);
+    for (int i = 0; i < compiled.slots.size(); ++i) {
+        data += compiled.parts[i];
+        int slot = compiled.slots[i];
+        data += slot < argCount ? args[slot] : QByteArray("null");
+    }
+    data += compiled.parts.last();
+    return data;
+}
+
+QByteArray GqlOperations::batch(const QVector<QByteArray> &payloads)
+{
+    int size = payloads.size() + 1;
+    for (const QByteArray &payload : payloads) {
+        size += payload.size();
+    }
+
+    QByteArray data;
+    data.reserve(size);
+    data += '[';
+    for (int i = 0; i < payloads.size(); ++i) {
+        if (i > 0) {
+            data += ',';
+        }
+        data += payloads[i];
+    }
+    data += ']';
+    return data;
+}
+
+// ========================================
+// JSON LITERALS
+// ========================================
+
+QByteArray GqlOperations::string(const QString &value)
+{
+    QByteArray utf8 = value.toUtf8();
+    QByteArray result;
+    result.reserve(utf8.size() + 2);
+    result += '"';
+    for (char c : utf8) {
+        switch (c) {
+        case '"':  result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': result += "\\r"; break;
+        case '\t': result += "\\t"; break;
+        default:
+            if (uchar(c) < 0x20) {
+                result += "\\u00";
+                result += QByteArray::number(uchar(c), 16).rightJustified(2, '0');
+            } else {
+                result += c;
+            }
+        }
+    }
+    result += '"';
+    return result;
+}
+
+QByteArray GqlOperations::optionalString(const QString &value)
+{
+    return value.isEmpty() ? QByteArrayLiteral("null") : string(value);
+}
+
+QByteArray GqlOperations::number(int value)
+{
+    return QByteArray::number(value);
+}
+
+QByteArray GqlOperations::boolean(bool value)
+{
+    return value ? QByteArrayLiteral("true") : QByteArrayLiteral("false");
+}
+
+QNetworkRequest GqlOperations::anonymousRequest()
+{
+    QNetworkRequest request(QUrl(QStringLiteral("https://gql.twitch.tv/gql")));
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    request.setRawHeader("Client-ID", Config::TWITCH_PUBLIC_CLIENT_ID.toUtf8());
+    return request;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef GQLOPERATIONS_H
+#define GQLOPERATIONS_H
+
+#include <QByteArray>
+#include <QNetworkRequest>
+#include <QString>
+#include <QVector>
+#include <initializer_list>
+
+/**
+ * GqlOperations - Registry of the GraphQL operations we send
+ *
+ * Purpose: Every request used to build nested QJsonObjects (variables,
+ * persistedQuery, extensions) and serialize them again. The payloads
+ * are fixed apart from a few values, so each operation is kept as a
+ * pre-serialized template and a request is a splice of JSON literals.
+ *
+ * Features:
+ * - Table of name, persisted-query hash and variables template
+ * - Templates are split at their %1..%9 slots once, on first use
+ * - Operations without a hash send their query document instead
+ *   (kept as a constant with GraphQL variables, never re-formatted)
+ *
+ * Usage:
+ *   GqlOperations::payload(GqlOperations::BrowsePageAllDirectories,
+ *                          {GqlOperations::number(limit)});
+ */
+namespace GqlOperations
+{
+    enum Operation {
+        PlaybackAccessToken,
+        UserMenuCurrentUser,
+        BrowsePageAllDirectories,
+        GameStreams,
+        GameViewers,
+        StreamViewers,
+        OperationCount
+    };
+
+    const char *name(Operation op);
+
+    // Request body; 'values' fill %1, %2, ... and must be JSON literals
+    QByteArray payload(Operation op, std::initializer_list<QByteArray> values = {});
+
+    // Several payloads in one request; the response is an array in order
+    QByteArray batch(const QVector<QByteArray> &payloads);
+
+    // POST target for payloads: public Client-ID, no auth token
+    QNetworkRequest anonymousRequest();
+
+    // JSON literals for the slots
+    QByteArray string(const QString &value);
+    QByteArray optionalString(const QString &value);    // null if empty
+    QByteArray number(int value);
+    QByteArray boolean(bool value);
+}
+
+#endif // GQLOPERATIONS_H
@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "helixlookupaggregator.h"
+#include "twitchhelixapi.h"
+#include "../core/logging.h"
+
+const int HelixLookupAggregator::BATCH_WINDOW_MS;
+const int HelixLookupAggregator::MAX_PER_REQUEST;
+
+HelixLookupAggregator::HelixLookupAggregator(QObject *parent)
+    : QObject(parent)
+    , m_api(new TwitchHelixAPI(this))
+    , m_window(new QTimer(this))
+    , m_lookupsInWindow(0)
+{
+    m_window->setSingleShot(true);
+    m_window->setInterval(BATCH_WINDOW_MS);
+    connect(m_window, &QTimer::timeout, this, &HelixLookupAggregator::flush);
+
+    connect(m_api, &TwitchHelixAPI::lookupReceived, this, &HelixLookupAggregator::onLookupReceived);
+    connect(m_api, &TwitchHelixAPI::lookupFailed, this, &HelixLookupAggregator::onLookupFailed);
+}
+
+void HelixLookupAggregator::setNetworkManager(NetworkManager *networkManager)
+{
+    m_api->setNetworkManager(networkManager);
+}
+
+void HelixLookupAggregator::setAuthToken(const QString &token)
+{
+    m_api->setAuthToken(token);
+}
+
+// ========================================
+// KINDS
+// ========================================
+
+QString HelixLookupAggregator::endpoint(Kind kind)
+{
+    return (kind == UserByLogin || kind == UserById) ? QStringLiteral("/users")
+                                                     : QStringLiteral("/streams");
+}
+
+QString HelixLookupAggregator::param(Kind kind)
+{
+    switch (kind) {
+    case UserByLogin:   return QStringLiteral("login");
+    case UserById:      return QStringLiteral("id");
+    case StreamByLogin: return QStringLiteral("user_login");
+    case StreamById:    return QStringLiteral("user_id");
+    default:            return QString();
+    }
+}
+
+bool HelixLookupAggregator::kindForParam(const QString &name, Kind *kind)
+{
+    for (int k = 0; k < KindCount; ++k) {
+        if (param(Kind(k)) == name) {
+            *kind = Kind(k);
+            return true;
+        }
+    }
+    return false;
+}
+
+QString HelixLookupAggregator::resultKey(Kind kind, const QJsonObject &result)
+{
+    switch (kind) {
+    case UserByLogin:   return result["login"].toString();
+    case UserById:      return result["id"].toString();
+    case StreamByLogin: return result["user_login"].toString();
+    case StreamById:    return result["user_id"].toString();
+    default:            return QString();
+    }
+}
+
+QString HelixLookupAggregator::normalize(Kind kind, const QString &key)
+{
+    // Logins are case-insensitive, Helix answers in lower case
+    if (kind == UserByLogin || kind == StreamByLogin) {
+        return key.trimmed().toLower();
+    }
+    return key.trimmed();
+}
+
+// ========================================
+// COLLECTING
+// ========================================
+
+void HelixLookupAggregator::lookup(Kind kind, const QString &key, QObject *context, Callback done)
+{
+    QString k = normalize(kind, key);
+    if (k.isEmpty()) {
+        done(QJsonObject());
+        return;
+    }
+
+    QVector<Waiter> &waiters = m_waiting[kind][k];
+    bool pending = !waiters.isEmpty();
+    waiters.append(Waiter{QPointer<QObject>(context ? context : this), done});
+    m_lookupsInWindow++;
+
+    // Already queued or in flight: the answer covers this caller too
+    if (pending) {
+        return;
+    }
+
+    m_queued[kind].append(k);
+    if (m_queued[kind].size() >= MAX_PER_REQUEST) {
+        send(kind, m_queued[kind]);
+        m_queued[kind].clear();
+    } else if (!m_window->isActive()) {
+        m_window->start();
+    }
+}
+
+void HelixLookupAggregator::requestUser(const QString &login)
+{
+    lookup(UserByLogin, login, this, [this, login](const QJsonObject &user) {
+        emit userResolved(login, user);
+    });
+}
+
+void HelixLookupAggregator::requestStream(const QString &login)
+{
+    lookup(StreamByLogin, login, this, [this, login](const QJsonObject &stream) {
+        emit streamResolved(login, stream);
+    });
+}
+
+void HelixLookupAggregator::flush()
+{
+    int requests = 0;
+    for (int k = 0; k < KindCount; ++k) {
+        const QStringList &queued = m_queued[k];
+        for (int i = 0; i < queued.size(); i += MAX_PER_REQUEST) {
+            send(Kind(k), queued.mid(i, MAX_PER_REQUEST));
+            requests++;
+        }
+        m_queued[k].clear();
+    }
+
+    if (m_lookupsInWindow > 1) {
+        LOG_API("Batched" << m_lookupsInWindow << "lookups into" << requests << "requests");
+    }
+    m_lookupsInWindow = 0;
+}
+
+void HelixLookupAggregator::send(Kind kind, const QStringList &keys)
+{
+    m_api->lookup(endpoint(kind), param(kind), keys);
+}
+
+// ========================================
+// RESOLVING
+// ========================================
+
+void HelixLookupAggregator::onLookupReceived(const QString &name, const QStringList &values,
+                                             const QJsonArray &data)
+{
+    Kind kind;
+    if (kindForParam(name, &kind)) {
+        resolve(kind, values, data);
+    }
+}
+
+void HelixLookupAggregator::onLookupFailed(const QString &name, const QStringList &values)
+{
+    Kind kind;
+    if (kindForParam(name, &kind)) {
+        resolve(kind, values, QJsonArray());
+    }
+}
+
+void HelixLookupAggregator::resolve(Kind kind, const QStringList &keys, const QJsonArray &results)
+{
+    QHash<QString, QJsonObject> byKey;
+    for (const QJsonValue &value : results) {
+        QJsonObject result = value.toObject();
+        byKey.insert(normalize(kind, resultKey(kind, result)), result);
+    }
+
+    for (const QString &key : keys) {
+        // Callbacks may queue new lookups for the same key; take ours first
+        QVector<Waiter> waiters = m_waiting[kind].take(key);
+        QJsonObject result = byKey.value(key);
+        for (const Waiter &waiter : waiters) {
+            if (waiter.context) {
+                waiter.done(result);
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HELIXLOOKUPAGGREGATOR_H
+#define HELIXLOOKUPAGGREGATOR_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QPointer>
+#include <QSet>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include <functional>
+
+class TwitchHelixAPI;
+class NetworkManager;
+
+/**
+ * HelixLookupAggregator - Batches single user/stream lookups
+ *
+ * Purpose: Single user/stream lookups cost one request per channel,
+ * while Helix takes up to 100 logins or IDs per request. One instance is
+ * shared by TwitchHelixAPI::getUserInfo() / getStreamForUser(),
+ * EventSubClient and QML.
+ *
+ * Features:
+ * - Lookups issued within BATCH_WINDOW_MS are collected and sent as one
+ *   /users or /streams request per kind and 100 keys
+ * - Each caller is resolved on its own, with an empty object when the
+ *   user is unknown, the channel offline or the request failed
+ * - The same key asked for twice (or while in flight) is fetched once
+ * - C++ callers pass a context object; QML uses requestUser() /
+ *   requestStream() and the *Resolved signals
+ */
+class HelixLookupAggregator : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Kind {
+        UserByLogin,
+        UserById,
+        StreamByLogin,
+        StreamById,
+        KindCount
+    };
+
+    using Callback = std::function<void(const QJsonObject &result)>;
+
+    explicit HelixLookupAggregator(QObject *parent = nullptr);
+
+    void setNetworkManager(NetworkManager *networkManager);
+    void setAuthToken(const QString &token);
+
+    // 'done' runs once, unless 'context' (if given) is destroyed before
+    void lookup(Kind kind, const QString &key, QObject *context, Callback done);
+
+    Q_INVOKABLE void requestUser(const QString &login);
+    Q_INVOKABLE void requestStream(const QString &login);
+
+signals:
+    void userResolved(const QString &login, const QJsonObject &user);
+    // Empty 'stream' when the channel is offline
+    void streamResolved(const QString &login, const QJsonObject &stream);
+
+private slots:
+    void flush();
+    void onLookupReceived(const QString &param, const QStringList &values, const QJsonArray &data);
+    void onLookupFailed(const QString &param, const QStringList &values);
+
+private:
+    struct Waiter {
+        QPointer<QObject> context;
+        Callback done;
+    };
+
+    TwitchHelixAPI *m_api;
+    QTimer *m_window;
+
+    QHash<QString, QVector<Waiter>> m_waiting[KindCount];
+    QStringList m_queued[KindCount];
+    int m_lookupsInWindow;
+
+    static const int BATCH_WINDOW_MS = 30;
+    static const int MAX_PER_REQUEST = 100;
+
+    static QString endpoint(Kind kind);
+    static QString param(Kind kind);
+    static bool kindForParam(const QString &param, Kind *kind);
+    static QString resultKey(Kind kind, const QJsonObject &result);
+    static QString normalize(Kind kind, const QString &key);
+
+    void send(Kind kind, const QStringList &keys);
+    void resolve(Kind kind, const QStringList &keys, const QJsonArray &results);
+};
+
+#endif // HELIXLOOKUPAGGREGATOR_H
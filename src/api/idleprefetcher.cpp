@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "idleprefetcher.h"
+#include "responseparser.h"
+#include "gqloperations.h"
+#include "twitchhelixapi.h"
+#include "../core/applifecycle.h"
+#include "../core/logging.h"
+#include "../core/parseworker.h"
+#include "../images/thumbnailscheduler.h"
+#include "../models/streamlistmodel.h"
+#include "../network/networkmanager.h"
+#include <QNetworkReply>
+#include <QNetworkRequest>
+
+const int IdlePrefetcher::PREFETCH_CATEGORIES;
+const int IdlePrefetcher::PAGE_SIZE;
+const qint64 IdlePrefetcher::BYTE_BUDGET;
+const int IdlePrefetcher::IDLE_DELAY_MS;
+const int IdlePrefetcher::MAX_AGE_MS;
+
+IdlePrefetcher::IdlePrefetcher(AppLifecycle *lifecycle, ThumbnailScheduler *scheduler, QObject *parent)
+    : QObject(parent)
+    , m_lifecycle(lifecycle)
+    , m_scheduler(scheduler)
+    , m_netStatusManager(nullptr)
+    , m_http(new QNetworkAccessManager(this))
+    , m_api(new TwitchHelixAPI(this))
+    , m_idleTimer(new QTimer(this))
+    , m_generation(0)
+    , m_helixBytes(0)
+    , m_bytesUsed(0)
+{
+    // Two rounds of top categories
+    m_pages.setMaxCost(PREFETCH_CATEGORIES * 2);
+
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(IDLE_DELAY_MS);
+    connect(m_idleTimer, &QTimer::timeout, this, &IdlePrefetcher::step);
+
+    // No NetworkManager for m_api: a failed prefetch isn't an app error
+    m_api->setLowPriority(true);
+    connect(m_api, &TwitchHelixAPI::streamsPaginationReceived, this, &IdlePrefetcher::onHelixStreamsReceived);
+    connect(m_api, &TwitchHelixAPI::error, this, &IdlePrefetcher::onHelixError);
+}
+
+void IdlePrefetcher::setNetworkManager(NetworkManager *networkManager)
+{
+    m_netStatusManager = networkManager;
+}
+
+void IdlePrefetcher::setAuthToken(const QString &token)
+{
+    m_authToken = token;
+    m_api->setAuthToken(token);
+}
+
+// ========================================
+// QUEUE
+// ========================================
+
+void IdlePrefetcher::onTopCategoriesReceived(const QVector<CategoryInfo> &categories, bool complete)
+{
+    for (const CategoryInfo &category : categories) {
+        m_incoming.append(category.id);
+    }
+    if (!complete) {
+        return;
+    }
+
+    // A new list, a new budget; the old queue is outdated
+    m_queue.clear();
+    for (const QString &id : m_incoming) {
+        if (m_queue.size() >= PREFETCH_CATEGORIES) {
+            break;
+        }
+        if (!id.isEmpty() && !isFresh(id)) {
+            m_queue.append(id);
+        }
+    }
+    m_incoming.clear();
+    m_bytesUsed = 0;
+
+    // The list was just loaded - let its box art go first
+    if (!m_queue.isEmpty() && m_inFlight.isEmpty()) {
+        m_idleTimer->start();
+    }
+}
+
+bool IdlePrefetcher::isIdle() const
+{
+    if (m_lifecycle && !m_lifecycle->isForeground()) {
+        return false;
+    }
+    if (m_scheduler && !qFuzzyIsNull(m_scheduler->velocity())) {
+        return false;
+    }
+    return !m_netStatusManager
+        || (m_netStatusManager->isOnline() && !m_netStatusManager->hasActiveError());
+}
+
+bool IdlePrefetcher::isFresh(const QString &gameId)
+{
+    Page *page = m_pages.object(gameId);
+    return page && page->age.elapsed() < MAX_AGE_MS;
+}
+
+// ========================================
+// FETCHING
+// ========================================
+
+void IdlePrefetcher::step()
+{
+    if (!m_inFlight.isEmpty() || m_queue.isEmpty()) {
+        return;
+    }
+    if (m_bytesUsed >= BYTE_BUDGET) {
+        LOG_API("Prefetch budget used up," << m_queue.size() << "categories left");
+        m_queue.clear();
+        return;
+    }
+    if (!isIdle()) {
+        m_idleTimer->start();
+        return;
+    }
+
+    QString gameId = m_queue.takeFirst();
+    m_inFlight = gameId;
+
+    if (!m_authToken.isEmpty()) {
+        m_helixRows.clear();
+        m_api->getStreamsForGameWithCursor(gameId, PAGE_SIZE, QString(), ++m_generation);
+        return;
+    }
+
+    // Anonymous, same query as TwitchStreamFetcher::requestStreamsForGame()
+    QNetworkRequest request = GqlOperations::anonymousRequest();
+    request.setPriority(QNetworkRequest::LowPriority);
+    QNetworkReply *reply = m_http->post(request, GqlOperations::payload(GqlOperations::GameStreams, {
+        GqlOperations::string(gameId),
+        GqlOperations::number(PAGE_SIZE),
+        GqlOperations::optionalString(QString())
+    }));
+    reply->setProperty("gameId", gameId);
+    connect(reply, &QNetworkReply::finished, this, &IdlePrefetcher::onGqlPageReceived);
+}
+
+void IdlePrefetcher::onGqlPageReceived()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    reply->deleteLater();
+
+    // Nothing here is needed yet - on errors leave the rest for the next list
+    if (reply->error() != QNetworkReply::NoError) {
+        WARN_API("Prefetch failed:" << reply->errorString());
+        m_queue.clear();
+        finished();
+        return;
+    }
+
+    QByteArray responseData = reply->readAll();
+    QString gameId = reply->property("gameId").toString();
+    m_bytesUsed += responseData.size();
+
+    ParseWorker::run(this,
+        [responseData]() { return ResponseParser::gqlGameStreams(responseData); },
+        [this, gameId](const StreamsResult &result) {
+            if (result.error.isEmpty()) {
+                store(gameId, result.streams);
+            }
+            finished();
+        });
+}
+
+void IdlePrefetcher::onHelixStreamsReceived(const QVector<StreamInfo> &streams, const QString &,
+                                            bool complete, const QString &gameId, int generation)
+{
+    if (generation != m_generation || gameId != m_inFlight) {
+        return;
+    }
+
+    m_helixRows += streams;
+    if (complete) {
+        store(gameId, m_helixRows);
+        m_helixRows.clear();
+        finished();
+    }
+}
+
+void IdlePrefetcher::onHelixError(const QString &message)
+{
+    if (m_inFlight.isEmpty()) {
+        return;
+    }
+
+    WARN_API("Prefetch failed:" << message);
+    m_queue.clear();
+    m_helixRows.clear();
+    ++m_generation;
+    finished();
+}
+
+void IdlePrefetcher::store(const QString &gameId, const QVector<StreamInfo> &streams)
+{
+    Page *page = new Page{streams, QElapsedTimer()};
+    page->age.start();
+    m_pages.insert(gameId, page, 1);
+    LOG_API("Prefetched" << streams.size() << "streams for game" << gameId);
+}
+
+void IdlePrefetcher::finished()
+{
+    // GraphQL bodies are counted as read, Helix ones by m_api
+    m_bytesUsed += m_api->bytesReceived() - m_helixBytes;
+    m_helixBytes = m_api->bytesReceived();
+    m_inFlight.clear();
+
+    if (!m_queue.isEmpty()) {
+        m_idleTimer->start();
+    }
+}
+
+// ========================================
+// RESTORE
+// ========================================
+
+bool IdlePrefetcher::restore(const QString &gameId, QObject *model)
+{
+    StreamListModel *streams = qobject_cast<StreamListModel*>(model);
+    if (!streams || !isFresh(gameId)) {
+        return false;
+    }
+
+    const Page *page = m_pages.object(gameId);
+    if (page->streams.isEmpty()) {
+        return false;
+    }
+    streams->setStreams(page->streams);
+    return true;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IDLEPREFETCHER_H
+#define IDLEPREFETCHER_H
+
+#include <QObject>
+#include <QCache>
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <QPointer>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include "../models/streaminfo.h"
+
+class AppLifecycle;
+class NetworkManager;
+class ThumbnailScheduler;
+class TwitchHelixAPI;
+
+/**
+ * IdlePrefetcher - First stream page of the top categories, ahead of time
+ *
+ * Purpose: Opening a category from the top list always started with a
+ * cold /streams round trip.
+ *
+ * Features:
+ * - After a top categories list arrived, the first page of streams for
+ *   the top PREFETCH_CATEGORIES is fetched one request at a time
+ * - Only while idle: app in the foreground, no grid being scrolled,
+ *   network online without an active error
+ * - Low network priority, and at most BYTE_BUDGET bytes per top list
+ * - Helix when logged in (a private low-priority TwitchHelixAPI),
+ *   anonymous GraphQL otherwise (like the page)
+ *
+ * StreamsForCategoryPage shows a prefetched page right away (restore())
+ * and still refreshes it in the background; refreshes are diffed, so
+ * the rows stay put.
+ */
+class IdlePrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    IdlePrefetcher(AppLifecycle *lifecycle, ThumbnailScheduler *scheduler, QObject *parent = nullptr);
+
+    void setNetworkManager(NetworkManager *networkManager);
+    void setAuthToken(const QString &token);
+
+    // Fills 'model' (a StreamListModel) from a fresh prefetched page
+    Q_INVOKABLE bool restore(const QString &gameId, QObject *model);
+
+public slots:
+    // Connected to topGamesReceived / topCategoriesReceived
+    void onTopCategoriesReceived(const QVector<CategoryInfo> &categories, bool complete);
+
+private slots:
+    void step();
+    void onGqlPageReceived();
+    void onHelixStreamsReceived(const QVector<StreamInfo> &streams, const QString &cursor, bool complete,
+                                const QString &gameId, int generation);
+    void onHelixError(const QString &message);
+
+private:
+    struct Page {
+        QVector<StreamInfo> streams;
+        QElapsedTimer age;
+    };
+
+    AppLifecycle *m_lifecycle;
+    QPointer<ThumbnailScheduler> m_scheduler;
+    NetworkManager *m_netStatusManager;
+    QNetworkAccessManager *m_http;
+    TwitchHelixAPI *m_api;
+    QTimer *m_idleTimer;
+    QString m_authToken;
+
+    QStringList m_incoming;         // top list still arriving in batches
+    QStringList m_queue;
+    QString m_inFlight;             // game id, empty when nothing is loading
+    int m_generation;               // tells a Helix page from an abandoned one
+    QVector<StreamInfo> m_helixRows;
+    qint64 m_helixBytes;            // m_api->bytesReceived() already counted
+    qint64 m_bytesUsed;
+    QCache<QString, Page> m_pages;
+
+    static const int PREFETCH_CATEGORIES = 6;
+    static const int PAGE_SIZE = 20;                // what the page asks for
+    static const qint64 BYTE_BUDGET = 512 * 1024;
+    static const int IDLE_DELAY_MS = 2000;
+    static const int MAX_AGE_MS = 3 * 60 * 1000;
+
+    bool isIdle() const;
+    bool isFresh(const QString &gameId);
+    void store(const QString &gameId, const QVector<StreamInfo> &streams);
+    void finished();
+};
+
+#endif // IDLEPREFETCHER_H
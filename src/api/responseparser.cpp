@@ -0,0 +1,300 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "responseparser.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+
+static bool parseObject(const QByteArray &body, QJsonObject *root)
+{
+    QJsonDocument doc = QJsonDocument::fromJson(body);
+    if (doc.isNull() || !doc.isObject()) {
+        return false;
+    }
+    *root = doc.object();
+    return true;
+}
+
+static QString graphQLError(const QJsonObject &root)
+{
+    QJsonArray errors = root["errors"].toArray();
+    if (errors.isEmpty()) {
+        return QString();
+    }
+    return errors[0].toObject()["message"].toString();
+}
+
+// ========================================
+// HELIX
+// ========================================
+
+StreamsResult ResponseParser::helixStreams(const QByteArray &body)
+{
+    StreamsResult result;
+    QJsonObject root;
+    if (!parseObject(body, &root)) {
+        result.error = "Invalid JSON response";
+        return result;
+    }
+
+    QJsonArray streams = root["data"].toArray();
+    result.streams = StreamInfo::fromJsonArray(streams);
+    if (streams.size() == 1) {
+        result.single = streams[0].toObject();
+    }
+    result.cursor = root["pagination"].toObject()["cursor"].toString();
+    return result;
+}
+
+LookupResult ResponseParser::helixLookup(const QByteArray &body, bool streamRows)
+{
+    LookupResult result;
+    QJsonObject root;
+    if (!parseObject(body, &root)) {
+        result.error = "Invalid JSON response";
+        return result;
+    }
+
+    result.data = root["data"].toArray();
+    if (streamRows) {
+        result.streams = StreamInfo::fromJsonArray(result.data);
+    }
+    return result;
+}
+
+StreamsResult ResponseParser::gqlGameStreams(const QByteArray &body)
+{
+    StreamsResult result;
+    QJsonObject root;
+    if (!parseObject(body, &root)) {
+        result.error = "Invalid JSON response for streams";
+        return result;
+    }
+    result.error = gqlGameStreamsError(root);
+    if (!result.error.isEmpty()) {
+        return result;
+    }
+
+    QJsonObject streams = root["data"].toObject()["game"].toObject()["streams"].toObject();
+
+    QString lastCursor;
+    for (const QJsonValue &value : streams["edges"].toArray()) {
+        QJsonObject edge = value.toObject();
+        result.streams.append(gqlStreamNode(edge["node"].toObject()));
+        lastCursor = edge["cursor"].toString();
+    }
+    if (streams["pageInfo"].toObject()["hasNextPage"].toBool()) {
+        result.cursor = lastCursor;
+    }
+    return result;
+}
+
+ChannelIdsResult ResponseParser::helixFollowedChannels(const QByteArray &body)
+{
+    ChannelIdsResult result;
+    QJsonObject root;
+    if (!parseObject(body, &root)) {
+        result.error = "Invalid JSON response for followed channels";
+        return result;
+    }
+
+    for (const QJsonValue &value : root["data"].toArray()) {
+        QString id = value.toObject()["broadcaster_id"].toString();
+        if (!id.isEmpty()) {
+            result.ids.append(id);
+        }
+    }
+    result.cursor = root["pagination"].toObject()["cursor"].toString();
+    return result;
+}
+
+// ========================================
+// GRAPHQL
+// ========================================
+
+CategoryInfo ResponseParser::gqlDirectoryNode(const QJsonObject &node)
+{
+    CategoryInfo info;
+    info.id = node["id"].toString();
+    info.name = node["displayName"].toString();
+    info.boxArtUrl = node["avatarURL"].toString();
+    info.viewersCount = node["viewersCount"].toInt();
+
+    for (const QJsonValue &tagValue : node["tags"].toArray()) {
+        QJsonObject tag = tagValue.toObject();
+        if (!tag["isLanguageTag"].toBool()) {
+            info.tags.append(tag["localizedName"].toString());
+        }
+    }
+    return info;
+}
+
+StreamInfo ResponseParser::gqlStreamNode(const QJsonObject &node)
+{
+    QJsonObject broadcaster = node["broadcaster"].toObject();
+
+    StreamInfo info;
+    info.id = node["id"].toString();
+    info.userId = broadcaster["id"].toString();
+    info.userLogin = broadcaster["login"].toString();
+    info.userName = broadcaster["displayName"].toString();
+    info.title = node["title"].toString();
+    info.viewerCount = node["viewersCount"].toInt();
+    info.thumbnailUrl = node["previewImageURL"].toString();
+    return info;
+}
+
+// ========================================
+// INCREMENTAL (see StreamingArrayReader)
+// ========================================
+
+static QJsonObject elementObject(const QByteArray &element)
+{
+    return QJsonDocument::fromJson(element).object();
+}
+
+QVector<StreamInfo> ResponseParser::helixStreamElements(const QVector<QByteArray> &elements)
+{
+    QVector<StreamInfo> result;
+    result.reserve(elements.size());
+    for (const QByteArray &element : elements) {
+        result.append(StreamInfo::fromJson(elementObject(element)));
+    }
+    return result;
+}
+
+QVector<CategoryInfo> ResponseParser::helixGameElements(const QVector<QByteArray> &elements)
+{
+    QVector<CategoryInfo> result;
+    result.reserve(elements.size());
+    for (const QByteArray &element : elements) {
+        result.append(CategoryInfo::fromHelix(elementObject(element)));
+    }
+    return result;
+}
+
+QVector<StreamInfo> ResponseParser::gqlStreamEdges(const QVector<QByteArray> &elements,
+                                                   QString *lastCursor)
+{
+    QVector<StreamInfo> result;
+    result.reserve(elements.size());
+    for (const QByteArray &element : elements) {
+        QJsonObject edge = elementObject(element);
+        result.append(gqlStreamNode(edge["node"].toObject()));
+        if (lastCursor) {
+            *lastCursor = edge["cursor"].toString();
+        }
+    }
+    return result;
+}
+
+QVector<CategoryInfo> ResponseParser::gqlDirectoryEdges(const QVector<QByteArray> &elements)
+{
+    QVector<CategoryInfo> result;
+    result.reserve(elements.size());
+    for (const QByteArray &element : elements) {
+        QJsonObject node = elementObject(element)["node"].toObject();
+        if (!node.isEmpty()) {
+            result.append(gqlDirectoryNode(node));
+        }
+    }
+    return result;
+}
+
+QString ResponseParser::helixSkeletonError(const QByteArray &skeleton)
+{
+    QJsonObject root;
+    return parseObject(skeleton, &root) ? QString() : QString("Invalid JSON response");
+}
+
+QString ResponseParser::helixCursor(const QByteArray &skeleton)
+{
+    QJsonObject root;
+    parseObject(skeleton, &root);
+    return root["pagination"].toObject()["cursor"].toString();
+}
+
+QString ResponseParser::gqlDirectoriesSkeletonError(const QByteArray &skeleton)
+{
+    QJsonObject root;
+    if (!parseObject(skeleton, &root)) {
+        return "Invalid JSON response for categories";
+    }
+
+    QString gqlError = graphQLError(root);
+    return gqlError.isEmpty() ? QString() : "Categories error: " + gqlError;
+}
+
+QString ResponseParser::gqlGameStreamsSkeletonError(const QByteArray &skeleton)
+{
+    QJsonObject root;
+    if (!parseObject(skeleton, &root)) {
+        return "Invalid JSON response for streams";
+    }
+    return gqlGameStreamsError(root);
+}
+
+QString ResponseParser::gqlGameStreamsError(const QJsonObject &root)
+{
+    QString gqlError = graphQLError(root);
+    if (!gqlError.isEmpty()) {
+        return "Failed to fetch streams: " + gqlError;
+    }
+    if (root["data"].toObject()["game"].toObject().isEmpty()) {
+        return "Game not found";
+    }
+    return QString();
+}
+
+bool ResponseParser::gqlGameStreamsHasNextPage(const QByteArray &skeleton)
+{
+    QJsonObject root;
+    if (!parseObject(skeleton, &root)) {
+        return false;
+    }
+    QJsonObject streams = root["data"].toObject()["game"].toObject()["streams"].toObject();
+    return streams["pageInfo"].toObject()["hasNextPage"].toBool();
+}
+
+QHash<QString, int> ResponseParser::gqlGameViewers(const QByteArray &body)
+{
+    QHash<QString, int> viewers;
+
+    // One result per batched operation; failed ones are simply missing
+    for (const QJsonValue &value : QJsonDocument::fromJson(body).array()) {
+        QJsonObject game = value.toObject()["data"].toObject()["game"].toObject();
+        QString id = game["id"].toString();
+        if (!id.isEmpty() && game.contains("viewersCount")) {
+            viewers.insert(id, game["viewersCount"].toInt());
+        }
+    }
+    return viewers;
+}
+
+QHash<QString, int> ResponseParser::gqlStreamViewers(const QByteArray &body)
+{
+    QHash<QString, int> viewers;
+
+    for (const QJsonValue &value : QJsonDocument::fromJson(body).array()) {
+        QJsonObject user = value.toObject()["data"].toObject()["user"].toObject();
+        QJsonObject stream = user["stream"].toObject();
+        QString id = user["id"].toString();
+        if (!id.isEmpty() && stream.contains("viewersCount")) {
+            viewers.insert(id, stream["viewersCount"].toInt());
+        }
+    }
+    return viewers;
+}
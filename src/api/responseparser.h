@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESPONSEPARSER_H
+#define RESPONSEPARSER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QStringList>
+#include "../models/streaminfo.h"
+
+struct StreamsResult
+{
+    QVector<StreamInfo> streams;
+    QJsonObject single;     // set when exactly one stream came back
+    QString cursor;
+    QString error;
+};
+
+struct LookupResult
+{
+    QJsonArray data;
+    QVector<StreamInfo> streams;    // only when asked for stream rows
+    QString error;
+};
+
+struct ChannelIdsResult
+{
+    QStringList ids;
+    QString cursor;
+    QString error;
+};
+
+/**
+ * ResponseParser - Response body -> typed rows
+ *
+ * Pure functions without QObject state, so they can run on the
+ * ParseWorker pool. 'error' is set instead of emitting anything.
+ */
+namespace ResponseParser
+{
+    // Helix /streams (whole body, single-user lookups)
+    StreamsResult helixStreams(const QByteArray &body);
+
+    // Helix batched lookup (/users or /streams); 'streamRows' also
+    // decodes data[] into StreamInfo
+    LookupResult helixLookup(const QByteArray &body, bool streamRows);
+
+    // GraphQL GameStreams (whole body; cursor only if there's a next page)
+    StreamsResult gqlGameStreams(const QByteArray &body);
+    // Its errors, from an already parsed body or skeleton
+    QString gqlGameStreamsError(const QJsonObject &root);
+
+    // Helix /channels/followed (broadcaster ids of one page)
+    ChannelIdsResult helixFollowedChannels(const QByteArray &body);
+
+    // Edge nodes: BrowsePage_AllDirectories / game streams
+    CategoryInfo gqlDirectoryNode(const QJsonObject &node);
+    StreamInfo gqlStreamNode(const QJsonObject &node);
+
+    // Raw array elements cut out by JsonArrayScanner
+    QVector<StreamInfo> helixStreamElements(const QVector<QByteArray> &elements);
+    QVector<CategoryInfo> helixGameElements(const QVector<QByteArray> &elements);
+    // 'lastCursor' (optional) gets the cursor of the last edge
+    QVector<StreamInfo> gqlStreamEdges(const QVector<QByteArray> &elements,
+                                       QString *lastCursor = nullptr);
+    QVector<CategoryInfo> gqlDirectoryEdges(const QVector<QByteArray> &elements);
+
+    // Scanner skeletons (the body minus the array elements)
+    QString helixSkeletonError(const QByteArray &skeleton);
+    QString helixCursor(const QByteArray &skeleton);
+    QString gqlDirectoriesSkeletonError(const QByteArray &skeleton);
+    QString gqlGameStreamsSkeletonError(const QByteArray &skeleton);
+    bool gqlGameStreamsHasNextPage(const QByteArray &skeleton);
+
+    // Batched GameViewers responses: game id -> viewers
+    QHash<QString, int> gqlGameViewers(const QByteArray &body);
+    // Batched StreamViewers responses: user id -> viewers (live ones only)
+    QHash<QString, int> gqlStreamViewers(const QByteArray &body);
+}
+
+#endif // RESPONSEPARSER_H
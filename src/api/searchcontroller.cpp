@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "searchcontroller.h"
+#include "twitchhelixapi.h"
+#include "../core/applifecycle.h"
+#include "../core/logging.h"
+#include <QJsonObject>
+
+const int SearchController::DEBOUNCE_MS;
+const int SearchController::RESULT_LIMIT;
+const int SearchController::CACHE_SIZE;
+
+SearchController::SearchController(AppLifecycle *lifecycle, QObject *parent)
+    : QObject(parent)
+    , m_lifecycle(lifecycle)
+    , m_api(new TwitchHelixAPI(this))
+    , m_debounce(new QTimer(this))
+    , m_searching(false)
+{
+    for (int k = 0; k < KindCount; ++k) {
+        m_cache[k].setMaxCost(CACHE_SIZE);
+        m_needed[k] = false;
+    }
+
+    m_debounce->setSingleShot(true);
+    m_debounce->setInterval(DEBOUNCE_MS);
+    connect(m_debounce, &QTimer::timeout, this, &SearchController::search);
+
+    connect(m_api, &TwitchHelixAPI::channelSearchReceived, this, &SearchController::onChannelSearchReceived);
+    connect(m_api, &TwitchHelixAPI::categorySearchReceived, this, &SearchController::onCategorySearchReceived);
+    connect(m_api, &TwitchHelixAPI::searchFailed, this, &SearchController::onSearchFailed);
+
+    if (m_lifecycle) {
+        connect(m_lifecycle, &AppLifecycle::foregroundChanged,
+                this, &SearchController::onForegroundChanged);
+    }
+}
+
+void SearchController::setNetworkManager(NetworkManager *networkManager)
+{
+    m_api->setNetworkManager(networkManager);
+}
+
+void SearchController::setAuthToken(const QString &token)
+{
+    bool wasAvailable = available();
+    m_api->setAuthToken(token);
+    m_authToken = token;
+    if (available() != wasAvailable) {
+        emit availableChanged();
+    }
+}
+
+QString SearchController::normalize(const QString &query)
+{
+    return query.simplified().toLower();
+}
+
+// ========================================
+// TYPING
+// ========================================
+
+void SearchController::setQuery(const QString &query)
+{
+    if (query == m_query) {
+        return;
+    }
+    m_query = query;
+    emit queryChanged();
+
+    // Whatever is in flight was asked for an older query
+    m_api->cancelSearches();
+
+    QString key = normalize(query);
+    if (key.isEmpty()) {
+        m_debounce->stop();
+        for (int k = 0; k < KindCount; ++k) {
+            m_results[k] = QJsonArray();
+            m_needed[k] = false;
+        }
+        emit resultsChanged();
+        setSearching(false);
+        return;
+    }
+
+    bool needed = false;
+    for (int k = 0; k < KindCount; ++k) {
+        m_needed[k] = !answerFromCache(Kind(k), key);
+        needed = needed || m_needed[k];
+    }
+    emit resultsChanged();
+
+    // Restarted on every keystroke: one request once typing pauses
+    if (needed && available()) {
+        m_debounce->start();
+        setSearching(true);
+    } else {
+        m_debounce->stop();
+        setSearching(false);
+    }
+}
+
+bool SearchController::answerFromCache(Kind kind, const QString &key)
+{
+    if (Cached *hit = m_cache[kind].object(key)) {
+        m_results[kind] = hit->results;
+        return true;
+    }
+
+    // Everything "abcd" matches, "abc" matched too - the longest cached
+    // prefix is the smallest superset
+    for (int length = key.size() - 1; length > 0; --length) {
+        if (Cached *prefix = m_cache[kind].object(key.left(length))) {
+            m_results[kind] = narrow(kind, prefix->results, key);
+            return prefix->complete;
+        }
+    }
+
+    // No superset known; keep what's shown as far as it still matches
+    m_results[kind] = narrow(kind, m_results[kind], key);
+    return false;
+}
+
+QJsonArray SearchController::narrow(Kind kind, const QJsonArray &results, const QString &key)
+{
+    QJsonArray narrowed;
+    for (const QJsonValue &value : results) {
+        QJsonObject result = value.toObject();
+        bool matches = kind == Channels
+            ? result["broadcaster_login"].toString().contains(key)
+              || result["display_name"].toString().toLower().contains(key)
+            : result["name"].toString().toLower().contains(key);
+        if (matches) {
+            narrowed.append(result);
+        }
+    }
+    return narrowed;
+}
+
+// ========================================
+// REQUESTS
+// ========================================
+
+void SearchController::search()
+{
+    QString key = normalize(m_query);
+    if (key.isEmpty() || !available()) {
+        setSearching(false);
+        return;
+    }
+    if (m_lifecycle && !m_lifecycle->isForeground()) {
+        return;     // still 'searching'; sent from onForegroundChanged()
+    }
+
+    if (m_needed[Channels]) {
+        m_api->searchChannels(key, RESULT_LIMIT);
+    }
+    if (m_needed[Categories]) {
+        m_api->searchCategories(key, RESULT_LIMIT);
+    }
+}
+
+void SearchController::onChannelSearchReceived(const QString &query, const QJsonArray &channels)
+{
+    received(Channels, query, channels);
+}
+
+void SearchController::onCategorySearchReceived(const QString &query, const QJsonArray &categories)
+{
+    received(Categories, query, categories);
+}
+
+void SearchController::received(Kind kind, const QString &query, const QJsonArray &results)
+{
+    m_cache[kind].insert(query, new Cached{results, results.size() < RESULT_LIMIT}, 1);
+
+    if (query != normalize(m_query)) {
+        return;
+    }
+
+    m_results[kind] = results;
+    m_needed[kind] = false;
+    emit resultsChanged();
+
+    if (!m_needed[Channels] && !m_needed[Categories]) {
+        setSearching(false);
+    }
+}
+
+void SearchController::onSearchFailed(const QString &query)
+{
+    if (query != normalize(m_query)) {
+        return;
+    }
+
+    // Cached and narrowed results stay; the next keystroke tries again
+    WARN_API("Search failed for" << query);
+    for (int k = 0; k < KindCount; ++k) {
+        m_needed[k] = false;
+    }
+    setSearching(false);
+}
+
+void SearchController::onForegroundChanged(bool foreground)
+{
+    if (!foreground) {
+        m_debounce->stop();
+        m_api->cancelSearches();
+    } else if (m_searching) {
+        m_debounce->start();
+    }
+}
+
+void SearchController::setSearching(bool searching)
+{
+    if (searching != m_searching) {
+        m_searching = searching;
+        emit searchingChanged();
+    }
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEARCHCONTROLLER_H
+#define SEARCHCONTROLLER_H
+
+#include <QObject>
+#include <QCache>
+#include <QJsonArray>
+#include <QString>
+#include <QTimer>
+#include <QVariantList>
+
+class AppLifecycle;
+class TwitchHelixAPI;
+class NetworkManager;
+
+/**
+ * SearchController - Channel and category search while typing
+ *
+ * Purpose: Helix search behind a text field without sending a request
+ * for every keystroke.
+ *
+ * Features:
+ * - Requests go out DEBOUNCE_MS after the last keystroke; a newer query
+ *   cancels the search still in flight
+ * - Results are kept per query in an LRU cache (CACHE_SIZE per kind)
+ * - A longer query is first answered from the longest cached prefix,
+ *   filtered locally. If that prefix got fewer than RESULT_LIMIT
+ *   results, it was complete and no request is sent at all
+ * - Helix search needs an OAuth token; without one only cached results
+ *   are shown (see 'available')
+ * - No requests while the app is in the background; a pending search
+ *   goes out once it's back in the foreground
+ */
+class SearchController : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+    // Helix data[] objects (broadcaster_login, display_name, is_live, ... /
+    // id, name, box_art_url)
+    Q_PROPERTY(QVariantList channels READ channels NOTIFY resultsChanged)
+    Q_PROPERTY(QVariantList categories READ categories NOTIFY resultsChanged)
+    Q_PROPERTY(bool searching READ searching NOTIFY searchingChanged)
+    Q_PROPERTY(bool available READ available NOTIFY availableChanged)
+
+public:
+    explicit SearchController(AppLifecycle *lifecycle, QObject *parent = nullptr);
+
+    void setNetworkManager(NetworkManager *networkManager);
+    void setAuthToken(const QString &token);
+
+    QString query() const { return m_query; }
+    void setQuery(const QString &query);
+
+    QVariantList channels() const { return m_results[Channels].toVariantList(); }
+    QVariantList categories() const { return m_results[Categories].toVariantList(); }
+    bool searching() const { return m_searching; }
+    bool available() const { return !m_authToken.isEmpty(); }
+
+signals:
+    void queryChanged();
+    void resultsChanged();
+    void searchingChanged();
+    void availableChanged();
+
+private slots:
+    void search();
+    void onChannelSearchReceived(const QString &query, const QJsonArray &channels);
+    void onCategorySearchReceived(const QString &query, const QJsonArray &categories);
+    void onSearchFailed(const QString &query);
+    void onForegroundChanged(bool foreground);
+
+private:
+    enum Kind {
+        Channels,
+        Categories,
+        KindCount
+    };
+
+    struct Cached {
+        QJsonArray results;
+        bool complete;      // fewer than RESULT_LIMIT: nothing was cut off
+    };
+
+    AppLifecycle *m_lifecycle;
+    TwitchHelixAPI *m_api;
+    QTimer *m_debounce;
+    QString m_authToken;
+
+    QString m_query;
+    QJsonArray m_results[KindCount];
+    bool m_needed[KindCount];       // not answerable from the cache
+    QCache<QString, Cached> m_cache[KindCount];
+    bool m_searching;
+
+    static const int DEBOUNCE_MS = 300;
+    static const int RESULT_LIMIT = 20;
+    static const int CACHE_SIZE = 50;
+
+    static QString normalize(const QString &query);
+    static QJsonArray narrow(Kind kind, const QJsonArray &results, const QString &key);
+
+    bool answerFromCache(Kind kind, const QString &key);
+    void received(Kind kind, const QString &query, const QJsonArray &results);
+    void setSearching(bool searching);
+};
+
+#endif // SEARCHCONTROLLER_H
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "streamingjson.h"
+#include "../core/parseworker.h"
+
+const int StreamingArrayReader::MIN_BATCH;
+
+// ========================================
+// SCANNER
+// ========================================
+
+JsonArrayScanner::JsonArrayScanner(const QList<QByteArray> &path)
+    : m_path(path)
+    , m_pos(0)
+    , m_copyFrom(0)
+    , m_keyStart(-1)
+    , m_elementStart(-1)
+    , m_targetDepth(-1)
+    , m_inString(false)
+    , m_escape(false)
+    , m_targetDone(false)
+{
+}
+
+bool JsonArrayScanner::atTargetPath() const
+{
+    if (m_targetDone || m_stack.size() != m_path.size()) {
+        return false;
+    }
+    for (int i = 0; i < m_stack.size(); ++i) {
+        if (m_stack[i].type != '{' || m_stack[i].key != m_path[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QVector<QByteArray> JsonArrayScanner::feed(const QByteArray &chunk)
+{
+    QVector<QByteArray> elements;
+    m_buffer.append(chunk);
+
+    const char *data = m_buffer.constData();
+    const int size = m_buffer.size();
+
+    for (; m_pos < size; ++m_pos) {
+        char c = data[m_pos];
+
+        if (m_inString) {
+            if (m_escape) {
+                m_escape = false;
+            } else if (c == '\\') {
+                m_escape = true;
+            } else if (c == '"') {
+                m_inString = false;
+                if (m_keyStart >= 0) {
+                    m_stack.last().key = m_buffer.mid(m_keyStart, m_pos - m_keyStart);
+                    m_keyStart = -1;
+                }
+            }
+            continue;
+        }
+
+        switch (c) {
+        case '"':
+            m_inString = true;
+            // Keys only matter up to the target depth
+            if (!m_stack.isEmpty() && m_stack.last().type == '{' && m_stack.last().expectKey
+                    && m_elementStart < 0) {
+                m_keyStart = m_pos + 1;
+            }
+            break;
+        case ':':
+            if (!m_stack.isEmpty()) {
+                m_stack.last().expectKey = false;
+            }
+            break;
+        case ',':
+            if (!m_stack.isEmpty() && m_stack.last().type == '{') {
+                m_stack.last().expectKey = true;
+            }
+            break;
+        case '{':
+        case '[':
+            if (c == '{' && m_targetDepth >= 0 && m_stack.size() == m_targetDepth) {
+                // Element starts: skeleton gets a placeholder instead
+                m_skeleton.append(data + m_copyFrom, m_pos - m_copyFrom);
+                m_skeleton.append('0');
+                m_elementStart = m_pos;
+            }
+            if (c == '[' && m_targetDepth < 0 && atTargetPath()) {
+                m_targetDepth = m_stack.size() + 1;
+            }
+            m_stack.append(Frame{c, QByteArray(), c == '{'});
+            break;
+        case '}':
+        case ']':
+            if (m_stack.isEmpty()) {
+                break;
+            }
+            m_stack.removeLast();
+            if (c == '}' && m_elementStart >= 0 && m_stack.size() == m_targetDepth) {
+                elements.append(m_buffer.mid(m_elementStart, m_pos - m_elementStart + 1));
+                m_elementStart = -1;
+                m_copyFrom = m_pos + 1;
+            } else if (c == ']' && m_targetDepth >= 0 && m_stack.size() == m_targetDepth - 1) {
+                m_targetDepth = -1;
+                m_targetDone = true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    compact();
+    return elements;
+}
+
+void JsonArrayScanner::compact()
+{
+    if (m_elementStart < 0) {
+        m_skeleton.append(m_buffer.constData() + m_copyFrom, m_buffer.size() - m_copyFrom);
+        m_copyFrom = m_buffer.size();
+    }
+
+    // Keep only what a pending element or key still needs
+    int drop = m_buffer.size();
+    if (m_elementStart >= 0) {
+        drop = m_elementStart;
+    }
+    if (m_keyStart >= 0) {
+        drop = qMin(drop, m_keyStart);
+    }
+    if (drop == 0) {
+        return;
+    }
+
+    m_buffer.remove(0, drop);
+    m_pos -= drop;
+    m_copyFrom = qMax(0, m_copyFrom - drop);
+    if (m_elementStart >= 0) {
+        m_elementStart -= drop;
+    }
+    if (m_keyStart >= 0) {
+        m_keyStart -= drop;
+    }
+}
+
+// ========================================
+// READER
+// ========================================
+
+StreamingArrayReader::StreamingArrayReader(QNetworkReply *reply, const QList<QByteArray> &path,
+                                           Decoder decoder, QObject *parent)
+    : QObject(parent)
+    , m_reply(reply)
+    , m_scanner(path)
+    , m_decoder(decoder)
+    , m_busy(false)
+    , m_finished(false)
+    , m_aborted(false)
+{
+    connect(m_reply, &QNetworkReply::readyRead, this, &StreamingArrayReader::onReadyRead);
+}
+
+StreamingArrayReader *StreamingArrayReader::attach(QNetworkReply *reply, const QList<QByteArray> &path,
+                                                   Decoder decoder, QObject *parent)
+{
+    StreamingArrayReader *reader = new StreamingArrayReader(reply, path, decoder, parent);
+    reply->setProperty("streamingReader", QVariant::fromValue<QObject*>(reader));
+    return reader;
+}
+
+StreamingArrayReader *StreamingArrayReader::of(QNetworkReply *reply)
+{
+    return qobject_cast<StreamingArrayReader*>(reply->property("streamingReader").value<QObject*>());
+}
+
+void StreamingArrayReader::onReadyRead()
+{
+    if (!m_reply || m_aborted) {
+        return;
+    }
+
+    // Error bodies aren't the document we're looking for
+    int status = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status >= 400) {
+        return;
+    }
+
+    m_pending += m_scanner.feed(m_reply->readAll());
+    dispatch();
+}
+
+void StreamingArrayReader::finish()
+{
+    // Drain whatever arrived together with 'finished'
+    onReadyRead();
+
+    m_finished = true;
+    m_reply = nullptr;
+    dispatch();
+}
+
+void StreamingArrayReader::abort()
+{
+    m_aborted = true;
+    m_pending.clear();
+    m_reply = nullptr;
+
+    if (!m_busy) {
+        deleteLater();
+    }
+}
+
+void StreamingArrayReader::dispatch()
+{
+    if (m_busy || m_aborted) {
+        return;
+    }
+
+    bool last = m_finished;
+    if (!last && m_pending.size() < MIN_BATCH) {
+        return;
+    }
+
+    QVector<QByteArray> elements;
+    elements.swap(m_pending);
+    QByteArray skeleton = last ? m_scanner.skeleton() : QByteArray();
+    Decoder decoder = m_decoder;
+
+    m_busy = true;
+    ParseWorker::run(this,
+        [decoder, elements, skeleton, last]() { return decoder(elements, skeleton, last); },
+        [this, last](const std::function<void()> &deliver) {
+            m_busy = false;
+            if (m_aborted) {
+                deleteLater();
+                return;
+            }
+
+            deliver();
+
+            if (last) {
+                deleteLater();
+            } else {
+                dispatch();
+            }
+        });
+}
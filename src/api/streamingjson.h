@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STREAMINGJSON_H
+#define STREAMINGJSON_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+#include <QNetworkReply>
+#include <functional>
+
+/**
+ * JsonArrayScanner - Cuts the elements of one array out of a JSON body
+ * while it is still arriving
+ *
+ * 'path' names the keys from the root object to the array, e.g.
+ * {"data"} for Helix or {"data", "directoriesWithTags", "edges"} for GQL.
+ * Only the raw bytes of each complete object element are returned; they
+ * are decoded elsewhere. Everything outside the array is kept as a small
+ * "skeleton" document (elements replaced by 0) for cursors and errors.
+ */
+class JsonArrayScanner
+{
+public:
+    explicit JsonArrayScanner(const QList<QByteArray> &path);
+
+    // Returns the elements completed by this chunk
+    QVector<QByteArray> feed(const QByteArray &chunk);
+
+    QByteArray skeleton() const { return m_skeleton; }
+
+private:
+    struct Frame {
+        char type;          // '{' or '['
+        QByteArray key;     // last key seen (objects)
+        bool expectKey;
+    };
+
+    QList<QByteArray> m_path;
+    QByteArray m_buffer;
+    QByteArray m_skeleton;
+    QVector<Frame> m_stack;
+
+    int m_pos;
+    int m_copyFrom;         // first byte not yet copied to the skeleton
+    int m_keyStart;         // -1 unless inside a key string
+    int m_elementStart;     // -1 unless inside a target element
+    int m_targetDepth;      // stack size of the target array, -1 if not in it
+    bool m_inString;
+    bool m_escape;
+    bool m_targetDone;
+
+    bool atTargetPath() const;
+    void compact();
+};
+
+/**
+ * StreamingArrayReader - Turns a reply's readyRead chunks into row batches
+ *
+ * Purpose: Let list responses render their first rows before the body
+ * finished downloading, instead of readAll() + parse after 'finished'.
+ *
+ * Features:
+ * - Scanning happens per chunk; decoding of each batch runs on the
+ *   ParseWorker pool, one batch at a time so batches stay in order
+ * - The decoder returns the GUI-thread step that hands the typed rows on;
+ *   the last batch gets the skeleton (cursor, GraphQL errors)
+ * - Deletes itself after the last batch or when the reply fails
+ */
+class StreamingArrayReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Runs on the pool; 'skeleton' is only set for the last batch
+    using Decoder = std::function<std::function<void()>(const QVector<QByteArray> &elements,
+                                                         const QByteArray &skeleton, bool last)>;
+
+    static StreamingArrayReader *attach(QNetworkReply *reply, const QList<QByteArray> &path,
+                                        Decoder decoder, QObject *parent);
+
+    // For reply handlers: the reader attached to 'reply', or nullptr
+    static StreamingArrayReader *of(QNetworkReply *reply);
+
+    // Called from the reply's finished handler
+    void finish();
+    void abort();
+
+    // Scan what has arrived so far; after the last chunk skeleton() is the
+    // whole body minus the elements (e.g. to read a cursor before finish())
+    void drain() { onReadyRead(); }
+    QByteArray skeleton() const { return m_scanner.skeleton(); }
+
+private slots:
+    void onReadyRead();
+
+private:
+    StreamingArrayReader(QNetworkReply *reply, const QList<QByteArray> &path,
+                         Decoder decoder, QObject *parent);
+
+    QNetworkReply *m_reply;
+    JsonArrayScanner m_scanner;
+    Decoder m_decoder;
+
+    QVector<QByteArray> m_pending;
+    bool m_busy;
+    bool m_finished;
+    bool m_aborted;
+
+    static const int MIN_BATCH = 8;
+
+    void dispatch();
+};
+
+#endif // STREAMINGJSON_H
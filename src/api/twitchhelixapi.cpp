@@ -21,7 +21,14 @@
 #include <QUrlQuery>
 #include <QUrl>
 #include "../network/networkmanager.h"
-
+#include "../core/parseworker.h"
+#include "helixlookupaggregator.h"
+#include "responseparser.h"
+#include "streamingjson.h"
+
+const int TwitchHelixAPI::MAX_FOLLOWED_PAGES;
+const int TwitchHelixAPI::MAX_FOLLOWED_CHANNEL_PAGES;
+const int TwitchHelixAPI::MAX_USERS_PER_REQUEST;
 const QString TwitchHelixAPI::HELIX_BASE_URL = "https://api.twitch.tv/helix";
 
 TwitchHelixAPI::TwitchHelixAPI(QObject *parent)
@@ -29,6 +36,8 @@ TwitchHelixAPI::TwitchHelixAPI(QObject *parent)
     , m_netStatusManager(nullptr)
     , m_networkManager(new QNetworkAccessManager(this))
     , m_authToken("")
+    , m_lowPriority(false)
+    , m_bytesReceived(0)
 {
 }
 
@@ -54,6 +63,7 @@ void TwitchHelixAPI::getTopGames(int limit)
     
     QNetworkReply *reply = m_networkManager->get(request);
     setupRequestTimeout(reply);
+    attachGamesReader(reply);
     connect(reply, &QNetworkReply::finished, this, &TwitchHelixAPI::onTopGamesReceived);
 }
 
@@ -73,10 +83,15 @@ void TwitchHelixAPI::getStreamsForGame(const QString &gameId, int limit)
     // Mark as non-pagination request
     reply->setProperty("withPagination", false);
     
+    attachStreamsReader(reply,
+        [this](const QVector<StreamInfo> &streams, const QString &, bool complete) {
+            emit streamsReceived(streams, complete);
+        });
     connect(reply, &QNetworkReply::finished, this, &TwitchHelixAPI::onStreamsReceived);
 }
 
-void TwitchHelixAPI::getStreamsForGameWithCursor(const QString &gameId, int limit, const QString &cursor)
+void TwitchHelixAPI::getStreamsForGameWithCursor(const QString &gameId, int limit, const QString &cursor,
+                                                 int generation)
 {
     
     // Clamp limit
@@ -98,12 +113,28 @@ void TwitchHelixAPI::getStreamsForGameWithCursor(const QString &gameId, int limi
     // Mark as pagination request
     reply->setProperty("withPagination", true);
     
+    attachStreamsReader(reply,
+        [this, gameId, generation](const QVector<StreamInfo> &streams, const QString &cursor, bool complete) {
+            emit streamsPaginationReceived(streams, cursor, complete, gameId, generation);
+        });
     connect(reply, &QNetworkReply::finished, this, &TwitchHelixAPI::onStreamsWithPaginationReceived);
 }
 
 void TwitchHelixAPI::getStreamForUser(const QString &userLogin)
 {
-    
+    if (m_lookup) {
+        m_lookup->lookup(HelixLookupAggregator::StreamByLogin, userLogin, this,
+            [this](const QJsonObject &stream) {
+                // Offline (or failed): no row, like an empty /streams answer
+                if (stream.isEmpty()) {
+                    emit streamsReceived(QVector<StreamInfo>(), true);
+                } else {
+                    emit streamReceived(stream);
+                }
+            });
+        return;
+    }
+
     QString endpoint = QString("/streams?user_login=%1").arg(userLogin);
     QNetworkRequest request = createRequest(endpoint, m_authToken);
     
@@ -118,7 +149,18 @@ void TwitchHelixAPI::getStreamForUser(const QString &userLogin)
 
 void TwitchHelixAPI::getUserInfo(const QString &userLogin)
 {
-    
+    if (m_lookup) {
+        m_lookup->lookup(HelixLookupAggregator::UserByLogin, userLogin, this,
+            [this](const QJsonObject &user) {
+                if (user.isEmpty()) {
+                    emit error("User not found");
+                } else {
+                    emit userInfoReceived(user);
+                }
+            });
+        return;
+    }
+
     QString endpoint = QString("/users?login=%1").arg(userLogin);
     QNetworkRequest request = createRequest(endpoint, m_authToken);
     
@@ -141,19 +183,182 @@ void TwitchHelixAPI::getFollowedStreams(const QString &userId, int limit)
     if (limit > 100) limit = 100;
     if (limit < 1) limit = 1;
     
-    QString endpoint = QString("/streams/followed?user_id=%1&first=%2").arg(userId).arg(limit);
+    // A new walk replaces one still running
+    int generation = m_followed.generation + 1;
+    m_followed = FollowedWalk();
+    m_followed.generation = generation;
+    m_followed.userId = userId;
+    m_followed.pageSize = limit;
+    m_followed.timer.start();
+
+    requestFollowedPage(QString());
+}
+
+void TwitchHelixAPI::requestFollowedPage(const QString &cursor)
+{
+    QString endpoint = QString("/streams/followed?user_id=%1&first=%2")
+                           .arg(m_followed.userId).arg(m_followed.pageSize);
+    if (!cursor.isEmpty()) {
+        endpoint += QString("&after=%1").arg(cursor);
+    }
     QNetworkRequest request = createRequest(endpoint, m_authToken);
 
     QNetworkReply *reply = m_networkManager->get(request);
     setupRequestTimeout(reply);
+
+    int generation = m_followed.generation;
+    reply->setProperty("followedGeneration", generation);
+    m_followed.pages++;
+    m_followed.outstanding++;
+
+    attachStreamsReader(reply,
+        [this, generation](const QVector<StreamInfo> &streams, const QString &, bool pageDone) {
+            if (generation != m_followed.generation) {
+                return;
+            }
+
+            m_followed.rows += streams.size();
+            if (m_followed.firstRowsMs < 0 && !streams.isEmpty()) {
+                m_followed.firstRowsMs = m_followed.timer.elapsed();
+            }
+
+            // Pages decode in parallel; the walk is complete when the last
+            // page was requested and every page delivered its last batch
+            bool complete = false;
+            if (pageDone) {
+                m_followed.outstanding--;
+                complete = m_followed.lastRequested && m_followed.outstanding == 0;
+            }
+
+            emit followedStreamsReceived(streams, complete);
+
+            if (complete) {
+                LOG_API("Followed streams:" << m_followed.rows << "live in" << m_followed.pages
+                        << "pages, first rows after" << m_followed.firstRowsMs << "ms, complete after"
+                        << m_followed.timer.elapsed() << "ms");
+            }
+        });
     connect(reply, &QNetworkReply::finished, this, &TwitchHelixAPI::onFollowedStreamsReceived);
 }
 
+void TwitchHelixAPI::getFollowedChannels(const QString &userId)
+{
+    if (m_authToken.isEmpty()) {
+        WARN_API("Cannot get followed channels without OAuth token");
+        emit error("Authentication required to view followed channels");
+        return;
+    }
+
+    requestFollowedChannelsPage(userId, QString(), QStringList(), 1);
+}
+
+void TwitchHelixAPI::requestFollowedChannelsPage(const QString &userId, const QString &cursor,
+                                                 const QStringList &ids, int page)
+{
+    QString endpoint = QString("/channels/followed?user_id=%1&first=100").arg(userId);
+    if (!cursor.isEmpty()) {
+        endpoint += QString("&after=%1").arg(cursor);
+    }
+    QNetworkRequest request = createRequest(endpoint, m_authToken);
+
+    QNetworkReply *reply = m_networkManager->get(request);
+    setupRequestTimeout(reply);
+    reply->setProperty("followedUserId", userId);
+    reply->setProperty("followedIds", ids);
+    reply->setProperty("followedPage", page);
+    connect(reply, &QNetworkReply::finished, this, &TwitchHelixAPI::onFollowedChannelsReceived);
+}
+
+void TwitchHelixAPI::getStreamsForUsers(const QStringList &userIds)
+{
+    requestLookup("/streams", "user_id", userIds, true);
+}
+
+void TwitchHelixAPI::lookup(const QString &endpoint, const QString &param, const QStringList &values)
+{
+    requestLookup(endpoint, param, values, false);
+}
+
+void TwitchHelixAPI::requestLookup(const QString &endpoint, const QString &param,
+                                   const QStringList &values, bool streamRows)
+{
+    if (values.isEmpty()) {
+        return;
+    }
+
+    QStringList batch = values.mid(0, MAX_USERS_PER_REQUEST);
+    QUrlQuery query;
+    for (const QString &value : batch) {
+        query.addQueryItem(param, value);
+    }
+    if (endpoint == "/streams") {
+        query.addQueryItem("first", QString::number(MAX_USERS_PER_REQUEST));
+    }
+
+    QNetworkRequest request = createRequest(endpoint + "?" + query.toString(QUrl::FullyEncoded), m_authToken);
+
+    QNetworkReply *reply = m_networkManager->get(request);
+    setupRequestTimeout(reply);
+    reply->setProperty("lookupParam", param);
+    reply->setProperty("lookupValues", batch);
+    reply->setProperty("lookupStreamRows", streamRows);
+    connect(reply, &QNetworkReply::finished, this, &TwitchHelixAPI::onLookupReceived);
+}
+
+void TwitchHelixAPI::searchChannels(const QString &query, int limit)
+{
+    startSearch("/search/channels", query, limit, m_channelSearch);
+}
+
+void TwitchHelixAPI::searchCategories(const QString &query, int limit)
+{
+    startSearch("/search/categories", query, limit, m_categorySearch);
+}
+
+void TwitchHelixAPI::cancelSearches()
+{
+    for (QNetworkReply *reply : { m_channelSearch.data(), m_categorySearch.data() }) {
+        if (reply && reply->isRunning()) {
+            reply->setProperty("superseded", true);
+            reply->abort();
+        }
+    }
+}
+
+void TwitchHelixAPI::startSearch(const QString &endpoint, const QString &query, int limit,
+                                 QPointer<QNetworkReply> &current)
+{
+    // The answer to the previous query is of no use anymore
+    if (current && current->isRunning()) {
+        current->setProperty("superseded", true);
+        current->abort();
+    }
+
+    QUrlQuery params;
+    params.addQueryItem("query", query);
+    params.addQueryItem("first", QString::number(qBound(1, limit, 100)));
+
+    QNetworkRequest request = createRequest(endpoint + "?" + params.toString(QUrl::FullyEncoded), m_authToken);
+
+    QNetworkReply *reply = m_networkManager->get(request);
+    setupRequestTimeout(reply);
+    reply->setProperty("searchEndpoint", endpoint);
+    reply->setProperty("searchQuery", query);
+    connect(reply, &QNetworkReply::finished, this, &TwitchHelixAPI::onSearchReceived);
+
+    current = reply;
+}
+
 void TwitchHelixAPI::setNetworkManager(NetworkManager *networkManager)
 {
     m_netStatusManager = networkManager;
 }
 
+void TwitchHelixAPI::setLookupAggregator(HelixLookupAggregator *lookup)
+{
+    m_lookup = lookup;
+}
+
 void TwitchHelixAPI::validateAuthToken(const QString &authToken)
 {
     
@@ -166,6 +371,53 @@ void TwitchHelixAPI::validateAuthToken(const QString &authToken)
     connect(reply, &QNetworkReply::finished, this, &TwitchHelixAPI::onAuthValidationReceived);
 }
 
+// ========================================
+// INCREMENTAL DECODING
+// ========================================
+
+void TwitchHelixAPI::attachStreamsReader(QNetworkReply *reply, StreamsEmitter emitRows)
+{
+    StreamingArrayReader::attach(reply, {"data"},
+        [this, emitRows](const QVector<QByteArray> &elements, const QByteArray &skeleton, bool last)
+                -> std::function<void()> {
+            QVector<StreamInfo> streams = ResponseParser::helixStreamElements(elements);
+            QString failure = last ? ResponseParser::helixSkeletonError(skeleton) : QString();
+            QString cursor = last ? ResponseParser::helixCursor(skeleton) : QString();
+
+            return [this, emitRows, streams, cursor, failure, last]() {
+                if (!failure.isEmpty()) {
+                    emit error(failure);
+                    return;
+                }
+                if (last && m_netStatusManager) {
+                    m_netStatusManager->reportSuccess();
+                }
+                emitRows(streams, cursor, last);
+            };
+        }, this);
+}
+
+void TwitchHelixAPI::attachGamesReader(QNetworkReply *reply)
+{
+    StreamingArrayReader::attach(reply, {"data"},
+        [this](const QVector<QByteArray> &elements, const QByteArray &skeleton, bool last)
+                -> std::function<void()> {
+            QVector<CategoryInfo> games = ResponseParser::helixGameElements(elements);
+            QString failure = last ? ResponseParser::helixSkeletonError(skeleton) : QString();
+
+            return [this, games, failure, last]() {
+                if (!failure.isEmpty()) {
+                    emit error(failure);
+                    return;
+                }
+                if (last && m_netStatusManager) {
+                    m_netStatusManager->reportSuccess();
+                }
+                emit topGamesReceived(games, last);
+            };
+        }, this);
+}
+
 // ========================================
 // RESPONSE HANDLERS
 // ========================================
@@ -176,68 +428,132 @@ void TwitchHelixAPI::onTopGamesReceived()
     if (!reply) return;
     
     reply->deleteLater();
+    StreamingArrayReader *reader = StreamingArrayReader::of(reply);
     
     if (reply->error() != QNetworkReply::NoError) {
+        if (reader) {
+            reader->abort();
+        }
         handleNetworkError(reply);
         return;
     }
     
-    QByteArray responseData = reply->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(responseData);
+    // Rows were decoded while the body arrived, flush the rest
+    if (reader) {
+        reader->finish();
+    }
+}
+
+void TwitchHelixAPI::onStreamsReceived()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
     
-    if (doc.isNull() || !doc.isObject()) {
-        emit error("Invalid JSON response");
+    reply->deleteLater();
+    StreamingArrayReader *reader = StreamingArrayReader::of(reply);
+    
+    if (reply->error() != QNetworkReply::NoError) {
+        if (reader) {
+            reader->abort();
+        }
+        handleNetworkError(reply);
         return;
     }
     
-    QJsonObject obj = doc.object();
-    QJsonArray games = obj["data"].toArray();
-
-    // Report successful network request
-    if (m_netStatusManager) {
-        m_netStatusManager->reportSuccess();
+    // Game listings are streamed; single-user lookups are parsed in one go
+    if (reader) {
+        reader->finish();
+        return;
     }
+    
+    QByteArray responseData = reply->readAll();
+
+    ParseWorker::run(this,
+        [responseData]() { return ResponseParser::helixStreams(responseData); },
+        [this](const StreamsResult &result) {
+            if (!result.error.isEmpty()) {
+                emit error(result.error);
+                return;
+            }
 
-    emit topGamesReceived(games);
+            // Report successful network request
+            if (m_netStatusManager) {
+                m_netStatusManager->reportSuccess();
+            }
+
+            // If single stream request, emit single stream
+            if (result.streams.size() == 1) {
+                emit streamReceived(result.single);
+            } else {
+                emit streamsReceived(result.streams, true);
+            }
+        });
 }
 
-void TwitchHelixAPI::onStreamsReceived()
+void TwitchHelixAPI::onStreamsWithPaginationReceived()
 {
     QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
     
     reply->deleteLater();
+    StreamingArrayReader *reader = StreamingArrayReader::of(reply);
     
     if (reply->error() != QNetworkReply::NoError) {
+        if (reader) {
+            reader->abort();
+        }
         handleNetworkError(reply);
         return;
     }
     
-    QByteArray responseData = reply->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(responseData);
+    // Rows were decoded while the body arrived, flush the rest
+    if (reader) {
+        reader->finish();
+    }
+}
+
+void TwitchHelixAPI::onFollowedStreamsReceived()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
     
-    if (doc.isNull() || !doc.isObject()) {
-        emit error("Invalid JSON response");
+    reply->deleteLater();
+    StreamingArrayReader *reader = StreamingArrayReader::of(reply);
+    bool current = reply->property("followedGeneration").toInt() == m_followed.generation;
+    
+    if (reply->error() != QNetworkReply::NoError) {
+        if (reader) {
+            reader->abort();
+        }
+        if (current) {
+            // Give up on this walk; the list keeps what it had
+            m_followed.generation++;
+        }
+        handleNetworkError(reply);
         return;
     }
     
-    QJsonObject obj = doc.object();
-    QJsonArray streams = obj["data"].toArray();
-
-    // Report successful network request
-    if (m_netStatusManager) {
-        m_netStatusManager->reportSuccess();
+    if (!reader) {
+        return;
     }
 
-    // If single stream request, emit single stream
-    if (streams.size() == 1) {
-        emit streamReceived(streams[0].toObject());
-    } else {
-        emit streamsReceived(streams);
+    // The cursor sits after data[] - read it from the skeleton now and
+    // request the next page before this one's rows finished decoding
+    reader->drain();
+    if (current) {
+        QString cursor = ResponseParser::helixCursor(reader->skeleton());
+        if (!cursor.isEmpty() && m_followed.pages < MAX_FOLLOWED_PAGES) {
+            requestFollowedPage(cursor);
+        } else {
+            m_followed.lastRequested = true;
+        }
     }
+
+    // Rows were decoded while the body arrived, flush the rest
+    reader->finish();
 }
 
-void TwitchHelixAPI::onStreamsWithPaginationReceived()
+void TwitchHelixAPI::onFollowedChannelsReceived()
 {
     QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
@@ -250,60 +566,107 @@ void TwitchHelixAPI::onStreamsWithPaginationReceived()
     }
     
     QByteArray responseData = reply->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(responseData);
+    QString userId = reply->property("followedUserId").toString();
+    QStringList ids = reply->property("followedIds").toStringList();
+    int page = reply->property("followedPage").toInt();
+
+    ParseWorker::run(this,
+        [responseData]() { return ResponseParser::helixFollowedChannels(responseData); },
+        [this, userId, ids, page](const ChannelIdsResult &result) {
+            if (!result.error.isEmpty()) {
+                emit error(result.error);
+                return;
+            }
+
+            if (m_netStatusManager) {
+                m_netStatusManager->reportSuccess();
+            }
+
+            QStringList all = ids + result.ids;
+            if (!result.cursor.isEmpty() && page < MAX_FOLLOWED_CHANNEL_PAGES) {
+                requestFollowedChannelsPage(userId, result.cursor, all, page + 1);
+                return;
+            }
+
+            LOG_API("Followed channels:" << all.size() << "in" << page << "pages");
+            emit followedChannelsReceived(all);
+        });
+}
+
+void TwitchHelixAPI::onLookupReceived()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
     
-    if (doc.isNull() || !doc.isObject()) {
-        emit error("Invalid JSON response");
+    reply->deleteLater();
+    QString param = reply->property("lookupParam").toString();
+    QStringList values = reply->property("lookupValues").toStringList();
+    bool streamRows = reply->property("lookupStreamRows").toBool();
+    
+    if (reply->error() != QNetworkReply::NoError) {
+        handleNetworkError(reply);
+        emit lookupFailed(param, values);
         return;
     }
     
-    QJsonObject obj = doc.object();
-    QJsonArray streams = obj["data"].toArray();
-    
-    // Extract pagination cursor
-    QString cursor = "";
-    if (obj.contains("pagination")) {
-        QJsonObject pagination = obj["pagination"].toObject();
-        cursor = pagination["cursor"].toString();
-    }
+    QByteArray responseData = reply->readAll();
 
-    // Report successful network request
-    if (m_netStatusManager) {
-        m_netStatusManager->reportSuccess();
-    }
+    ParseWorker::run(this,
+        [responseData, streamRows]() { return ResponseParser::helixLookup(responseData, streamRows); },
+        [this, param, values, streamRows](const LookupResult &result) {
+            if (!result.error.isEmpty()) {
+                emit error(result.error);
+                emit lookupFailed(param, values);
+                return;
+            }
+
+            if (m_netStatusManager) {
+                m_netStatusManager->reportSuccess();
+            }
 
-    emit streamsPaginationReceived(streams, cursor);
+            emit lookupReceived(param, values, result.data);
+            if (streamRows) {
+                emit streamsForUsersReceived(values, result.streams);
+            }
+        });
 }
 
-void TwitchHelixAPI::onFollowedStreamsReceived()
+void TwitchHelixAPI::onSearchReceived()
 {
     QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
     
     reply->deleteLater();
+    QString query = reply->property("searchQuery").toString();
+    
+    // Cancelled for a newer query - not an error
+    if (reply->property("superseded").toBool()) {
+        return;
+    }
     
     if (reply->error() != QNetworkReply::NoError) {
         handleNetworkError(reply);
+        emit searchFailed(query);
         return;
     }
     
-    QByteArray responseData = reply->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(responseData);
-    
-    if (doc.isNull() || !doc.isObject()) {
+    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll());
+    if (!doc.isObject()) {
         emit error("Invalid JSON response");
+        emit searchFailed(query);
         return;
     }
-    
-    QJsonObject obj = doc.object();
-    QJsonArray streams = obj["data"].toArray();
 
-    // Report successful network request
     if (m_netStatusManager) {
         m_netStatusManager->reportSuccess();
     }
 
-    emit followedStreamsReceived(streams);
+    QJsonArray data = doc.object()["data"].toArray();
+    if (reply->property("searchEndpoint").toString() == "/search/channels") {
+        emit channelSearchReceived(query, data);
+    } else {
+        emit categorySearchReceived(query, data);
+    }
 }
 
 void TwitchHelixAPI::onUserInfoReceived()
@@ -403,6 +766,10 @@ QNetworkRequest TwitchHelixAPI::createRequest(const QString &endpoint, const QSt
         request.setRawHeader("Client-ID", Config::TWITCH_PUBLIC_CLIENT_ID.toUtf8());
         }
     
+    if (m_lowPriority) {
+        request.setPriority(QNetworkRequest::LowPriority);
+    }
+    
     return request;
 }
 
@@ -473,6 +840,12 @@ void TwitchHelixAPI::setupRequestTimeout(QNetworkReply *reply)
     m_timeoutTimers[reply] = timer;
     timer->start();
 
+    // Counted as it arrives, see bytesReceived()
+    connect(reply, &QNetworkReply::downloadProgress, this, [this, reply](qint64 received, qint64) {
+        m_bytesReceived += received - reply->property("bytesCounted").toLongLong();
+        reply->setProperty("bytesCounted", received);
+    });
+
 }
 
 void TwitchHelixAPI::onRequestTimeout()
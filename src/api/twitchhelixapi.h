@@ -19,15 +19,21 @@
 
 #include <QObject>
 #include <QString>
+#include <QStringList>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QMap>
+#include <QPointer>
+#include <functional>
+#include "../models/streaminfo.h"
 
 class NetworkManager;
+class HelixLookupAggregator;
 
 /**
  * Twitch Helix REST API Client
@@ -37,6 +43,9 @@ class NetworkManager;
  * - Get Streams (with pagination support)
  * - Get User Info
  * - Get Followed Streams (requires OAuth)
+ * - Get Followed Channels / live status by user ID (requires OAuth)
+ * - Batched user/stream lookups (up to 100 logins or IDs per request)
+ * - Channel and category search (see SearchController)
  * 
  * Note: This is separate from GraphQL API (used for PlaybackAccessToken)
  */
@@ -74,11 +83,15 @@ public:
      * @param gameId Twitch Game ID
      * @param limit Number of results (max 100, default 20)
      * @param cursor Pagination cursor (empty for first page)
+     * @param generation Passed back with the response, together with
+     *                   gameId, so stale pages can be told apart
      */
-    Q_INVOKABLE void getStreamsForGameWithCursor(const QString &gameId, int limit, const QString &cursor);
+    Q_INVOKABLE void getStreamsForGameWithCursor(const QString &gameId, int limit, const QString &cursor,
+                                                 int generation = 0);
     
     /**
      * Get Stream info for a specific channel
+     * Batched with other lookups once setLookupAggregator() was called
      * 
      * @param userLogin Channel name (lowercase)
      */
@@ -98,8 +111,9 @@ public:
     
     /**
      * Get user info by login name
+     * Batched with other lookups once setLookupAggregator() was called
      * 
-     * @param userLogin Username (can be multiple, comma-separated)
+     * @param userLogin Username
      */
     Q_INVOKABLE void getUserInfo(const QString &userLogin);
 
@@ -107,30 +121,104 @@ public:
      * Get Followed Live Streams (requires OAuth)
      * Shows live streams from channels the authenticated user follows
      * 
+     * All pages are fetched: the next page is requested as soon as the
+     * previous body finished downloading, while its rows still decode.
+     * followedStreamsReceived reports 'complete' once, after the last page.
+     * 
      * @param userId User ID (from OAuth validation or user info)
-     * @param limit Number of results (max 100, default 20)
+     * @param limit Page size (max 100, default 20)
      */
     Q_INVOKABLE void getFollowedStreams(const QString &userId, int limit = 20);
 
+    /**
+     * Get the IDs of all channels the user follows (requires OAuth)
+     * Walks /channels/followed 100 at a time, live or not
+     * 
+     * @param userId User ID (from OAuth validation or user info)
+     */
+    Q_INVOKABLE void getFollowedChannels(const QString &userId);
+
+    /**
+     * Get live streams for a set of channels in one request
+     * The ("/streams", "user_id") lookup, also answered with typed rows
+     * (streamsForUsersReceived)
+     * 
+     * @param userIds Broadcaster user IDs (max 100, the rest is dropped)
+     */
+    void getStreamsForUsers(const QStringList &userIds);
+
+    /**
+     * One batched lookup, e.g. ("/users", "login", {...}) or
+     * ("/streams", "user_id", {...}); see HelixLookupAggregator
+     * 
+     * @param values Repeated as 'param' (max 100, the rest is dropped)
+     */
+    void lookup(const QString &endpoint, const QString &param, const QStringList &values);
+
+    /**
+     * Search channels by name (/search/channels)
+     * A search still in flight is cancelled - only the newest counts
+     * 
+     * @param query Search text
+     * @param limit Number of results (max 100, default 20)
+     */
+    Q_INVOKABLE void searchChannels(const QString &query, int limit = 20);
+
+    /**
+     * Search categories by name (/search/categories)
+     * Same superseding as searchChannels()
+     */
+    Q_INVOKABLE void searchCategories(const QString &query, int limit = 20);
+
+    // Cancel both searches, e.g. when the query was cleared
+    void cancelSearches();
+
     // Set OAuth token for authenticated requests
     void setAuthToken(const QString &token) { m_authToken = token; }
     void setNetworkManager(NetworkManager *networkManager); 
+    // Shared batcher for getStreamForUser() / getUserInfo()
+    void setLookupAggregator(HelixLookupAggregator *lookup);
+    // Background work (prefetching): requests go out at low network priority
+    void setLowPriority(bool lowPriority) { m_lowPriority = lowPriority; }
+    // Response bytes downloaded by this instance so far
+    qint64 bytesReceived() const { return m_bytesReceived; }
 
 signals:
+    // List responses arrive in batches while the body downloads;
+    // 'complete' marks the last batch of a response
+
     // Top Games response
-    void topGamesReceived(const QJsonArray &games);
+    void topGamesReceived(const QVector<CategoryInfo> &games, bool complete);
     
     // Streams response (without pagination info)
-    void streamsReceived(const QJsonArray &streams);
+    void streamsReceived(const QVector<StreamInfo> &streams, bool complete);
     
-    // Streams response WITH pagination info
-    void streamsPaginationReceived(const QJsonArray &streams, const QString &cursor);
+    // Streams response WITH pagination info (cursor set on the last batch);
+    // gameId and generation are the ones the page was requested with
+    void streamsPaginationReceived(const QVector<StreamInfo> &streams, const QString &cursor, bool complete,
+                                   const QString &gameId, int generation);
     
     // Single stream response
     void streamReceived(const QJsonObject &stream);
     
     // Followed streams response
-    void followedStreamsReceived(const QJsonArray &streams);
+    void followedStreamsReceived(const QVector<StreamInfo> &streams, bool complete);
+
+    // All followed channel IDs, after the last page
+    void followedChannelsReceived(const QStringList &userIds);
+
+    // Live streams among 'userIds'; channels without a row are offline
+    void streamsForUsersReceived(const QStringList &userIds, const QVector<StreamInfo> &streams);
+
+    // Batched lookup response: the data[] objects for 'values'
+    void lookupReceived(const QString &param, const QStringList &values, const QJsonArray &data);
+    void lookupFailed(const QString &param, const QStringList &values);
+
+    // Search responses: the data[] objects for 'query'
+    void channelSearchReceived(const QString &query, const QJsonArray &channels);
+    void categorySearchReceived(const QString &query, const QJsonArray &categories);
+    // Not emitted for cancelled searches
+    void searchFailed(const QString &query);
     
     // User info response
     void userInfoReceived(const QJsonObject &user);
@@ -147,6 +235,9 @@ private slots:
     void onStreamsReceived();
     void onStreamsWithPaginationReceived();
     void onFollowedStreamsReceived();
+    void onFollowedChannelsReceived();
+    void onLookupReceived();
+    void onSearchReceived();
     void onUserInfoReceived();
     void onAuthValidationReceived();
     void onRequestTimeout();
@@ -154,6 +245,8 @@ private slots:
 private:
     QNetworkAccessManager *m_networkManager;
     QString m_authToken;
+    bool m_lowPriority;
+    qint64 m_bytesReceived;
 
     // Request timeout management
     QMap<QNetworkReply*, QTimer*> m_timeoutTimers;
@@ -168,6 +261,46 @@ private:
     void cleanupRequest(QNetworkReply *reply);
     NetworkManager *m_netStatusManager;
     void handleNetworkError(QNetworkReply *reply);
+
+    // Followed streams page walk (see getFollowedStreams)
+    struct FollowedWalk {
+        int generation = 0;         // bumped per walk, stale pages are dropped
+        QString userId;
+        int pageSize = 0;
+        int pages = 0;
+        int outstanding = 0;        // pages whose last batch isn't delivered yet
+        bool lastRequested = false; // a page came back without a cursor
+        int rows = 0;
+        qint64 firstRowsMs = -1;
+        QElapsedTimer timer;
+    };
+    FollowedWalk m_followed;
+    static const int MAX_FOLLOWED_PAGES = 20;
+
+    void requestFollowedPage(const QString &cursor);
+
+    // Followed channel walk: user and ids so far ride on the reply
+    static const int MAX_FOLLOWED_CHANNEL_PAGES = 50;
+    static const int MAX_USERS_PER_REQUEST = 100;
+    void requestFollowedChannelsPage(const QString &userId, const QString &cursor,
+                                     const QStringList &ids, int page);
+
+    // Behind lookup() and getStreamsForUsers(); 'streamRows' adds
+    // streamsForUsersReceived to the answer
+    void requestLookup(const QString &endpoint, const QString &param,
+                       const QStringList &values, bool streamRows);
+    QPointer<HelixLookupAggregator> m_lookup;
+
+    // Searches in flight, aborted when superseded
+    QPointer<QNetworkReply> m_channelSearch;
+    QPointer<QNetworkReply> m_categorySearch;
+    void startSearch(const QString &endpoint, const QString &query, int limit,
+                     QPointer<QNetworkReply> &current);
+
+    // Incremental decoding of data[] (see StreamingArrayReader)
+    using StreamsEmitter = std::function<void(const QVector<StreamInfo> &, const QString &cursor, bool complete)>;
+    void attachStreamsReader(QNetworkReply *reply, StreamsEmitter emitRows);
+    void attachGamesReader(QNetworkReply *reply);
 };
 
 #endif // TWITCHHELIXAPI_H
\ No newline at end of file
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "viewercountrefresher.h"
+#include "twitchhelixapi.h"
+#include "responseparser.h"
+#include "../core/applifecycle.h"
+#include "../core/logging.h"
+#include "../core/parseworker.h"
+#include "../models/entitystore.h"
+#include "../models/streamlistmodel.h"
+#include "../models/categorylistmodel.h"
+#include <QAbstractProxyModel>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSet>
+
+const int ViewerCountRefresher::REFRESH_INTERVAL_MS;
+const int ViewerCountRefresher::IDS_PER_REQUEST;
+const int ViewerCountRefresher::GQL_BATCH_SIZE;
+
+ViewerCountRefresher::ViewerCountRefresher(EntityStore *store, AppLifecycle *lifecycle, QObject *parent)
+    : QObject(parent)
+    , m_store(store)
+    , m_lifecycle(lifecycle)
+    , m_api(new TwitchHelixAPI(this))
+    , m_http(new QNetworkAccessManager(this))
+    , m_timer(new QTimer(this))
+{
+    m_timer->setInterval(REFRESH_INTERVAL_MS);
+    connect(m_timer, &QTimer::timeout, this, &ViewerCountRefresher::refresh);
+
+    connect(m_api, &TwitchHelixAPI::streamsForUsersReceived,
+            this, &ViewerCountRefresher::onStreamsForUsersReceived);
+
+    if (m_lifecycle) {
+        connect(m_lifecycle, &AppLifecycle::foregroundChanged,
+                this, &ViewerCountRefresher::onForegroundChanged);
+    }
+}
+
+void ViewerCountRefresher::setNetworkManager(NetworkManager *networkManager)
+{
+    m_api->setNetworkManager(networkManager);
+}
+
+void ViewerCountRefresher::setAuthToken(const QString &token)
+{
+    m_api->setAuthToken(token);
+    m_authToken = token;
+}
+
+// ========================================
+// VISIBLE ROWS
+// ========================================
+
+void ViewerCountRefresher::setVisibleRows(QObject *model, int first, int last)
+{
+    if (!model) {
+        return;
+    }
+    if (last < first) {
+        clearVisibleRows(model);
+        return;
+    }
+
+    m_ranges.insert(model, Range{QPointer<QObject>(model), first, last});
+    updateTimer();
+}
+
+void ViewerCountRefresher::clearVisibleRows(QObject *model)
+{
+    m_ranges.remove(model);
+    updateTimer();
+}
+
+void ViewerCountRefresher::updateTimer()
+{
+    bool wanted = !m_ranges.isEmpty() && (!m_lifecycle || m_lifecycle->isForeground());
+    if (wanted && !m_timer->isActive()) {
+        // The rows were just loaded; the first refresh is one interval away
+        m_timer->start();
+    } else if (!wanted) {
+        m_timer->stop();
+    }
+}
+
+void ViewerCountRefresher::onForegroundChanged(bool foreground)
+{
+    Q_UNUSED(foreground);
+    updateTimer();
+}
+
+// ========================================
+// REFRESH
+// ========================================
+
+void ViewerCountRefresher::refresh()
+{
+    QStringList userIds;
+    QStringList gameIds;
+    QSet<QString> seen;
+
+    for (auto it = m_ranges.begin(); it != m_ranges.end(); ) {
+        QObject *model = it->model;
+        if (!model) {
+            it = m_ranges.erase(it);
+            continue;
+        }
+
+        // Half a screen of margin on both sides
+        int margin = (it->last - it->first + 1) / 2;
+        int first = qMax(0, it->first - margin);
+        int last = it->last + margin;
+
+        // Filtered grids (SearchFilterModel) report their own rows
+        QVector<int> rows;
+        if (QAbstractProxyModel *proxy = qobject_cast<QAbstractProxyModel*>(model)) {
+            last = qMin(last, proxy->rowCount() - 1);
+            for (int row = first; row <= last; ++row) {
+                rows.append(proxy->mapToSource(proxy->index(row, 0)).row());
+            }
+            model = proxy->sourceModel();
+        } else if (QAbstractItemModel *list = qobject_cast<QAbstractItemModel*>(model)) {
+            last = qMin(last, list->rowCount() - 1);
+            for (int row = first; row <= last; ++row) {
+                rows.append(row);
+            }
+        }
+
+        if (StreamListModel *streams = qobject_cast<StreamListModel*>(model)) {
+            for (int row : rows) {
+                // Stream keys are user ids whenever the id is known
+                QString key = streams->keyAt(row);
+                const UserEntity *user = m_store->user(key);
+                if (user && user->id == key && !seen.contains(key)) {
+                    seen.insert(key);
+                    userIds.append(key);
+                }
+            }
+        } else if (CategoryListModel *categories = qobject_cast<CategoryListModel*>(model)) {
+            for (int row : rows) {
+                QString id = categories->idAt(row);
+                if (!seen.contains(id)) {
+                    seen.insert(id);
+                    gameIds.append(id);
+                }
+            }
+        }
+        ++it;
+    }
+
+    if (m_ranges.isEmpty()) {
+        updateTimer();
+        return;
+    }
+
+    for (int i = 0; i < userIds.size(); i += IDS_PER_REQUEST) {
+        QStringList chunk = userIds.mid(i, IDS_PER_REQUEST);
+        if (m_authToken.isEmpty()) {
+            postGqlBatch(GqlOperations::StreamViewers, chunk);
+        } else {
+            m_api->getStreamsForUsers(chunk);
+        }
+    }
+    if (!gameIds.isEmpty()) {
+        postGqlBatch(GqlOperations::GameViewers, gameIds);
+    }
+}
+
+void ViewerCountRefresher::postGqlBatch(GqlOperations::Operation op, const QStringList &ids)
+{
+    for (int i = 0; i < ids.size(); i += GQL_BATCH_SIZE) {
+        QVector<QByteArray> payloads;
+        for (const QString &id : ids.mid(i, GQL_BATCH_SIZE)) {
+            payloads.append(GqlOperations::payload(op, {GqlOperations::string(id)}));
+        }
+
+        // Anonymous, same as the GraphQL browse pages
+        QNetworkReply *reply = m_http->post(GqlOperations::anonymousRequest(), GqlOperations::batch(payloads));
+        reply->setProperty("gqlOperation", int(op));
+        connect(reply, &QNetworkReply::finished, this, &ViewerCountRefresher::onGqlReceived);
+    }
+}
+
+void ViewerCountRefresher::onStreamsForUsersReceived(const QStringList &userIds,
+                                                     const QVector<StreamInfo> &streams)
+{
+    Q_UNUSED(userIds);
+
+    // Channels that went offline keep their row until the next reload
+    QHash<QString, int> counts;
+    for (const StreamInfo &stream : streams) {
+        counts.insert(stream.userId, stream.viewerCount);
+    }
+    m_store->setViewerCounts(counts);
+}
+
+void ViewerCountRefresher::onGqlReceived()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    reply->deleteLater();
+
+    // A missed refresh is harmless, the next one comes in a minute
+    if (reply->error() != QNetworkReply::NoError) {
+        WARN_API("Viewer count refresh failed:" << reply->errorString());
+        return;
+    }
+
+    QByteArray responseData = reply->readAll();
+    bool games = reply->property("gqlOperation").toInt() == GqlOperations::GameViewers;
+
+    ParseWorker::run(this,
+        [responseData, games]() {
+            return games ? ResponseParser::gqlGameViewers(responseData)
+                         : ResponseParser::gqlStreamViewers(responseData);
+        },
+        [this, games](const QHash<QString, int> &counts) {
+            if (games) {
+                m_store->setGameViewerCounts(counts);
+            } else {
+                m_store->setViewerCounts(counts);
+            }
+        });
+}
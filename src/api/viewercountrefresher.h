@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VIEWERCOUNTREFRESHER_H
+#define VIEWERCOUNTREFRESHER_H
+
+#include <QObject>
+#include <QHash>
+#include <QNetworkAccessManager>
+#include <QPointer>
+#include <QStringList>
+#include <QTimer>
+#include <QVector>
+#include "../models/streaminfo.h"
+#include "gqloperations.h"
+
+class EntityStore;
+class AppLifecycle;
+class TwitchHelixAPI;
+class NetworkManager;
+
+/**
+ * ViewerCountRefresher - Keeps the counts on screen up to date
+ *
+ * Purpose: Viewer counts in the browse grids were frozen at load time,
+ * and reloading the whole page just for them would reset the list.
+ *
+ * Features:
+ * - Pages report the rows they show; half a screen above and below is
+ *   refreshed too, everything else is left alone
+ * - Streams: Helix /streams?user_id=, 100 channels per request
+ *   (batched GraphQL when not logged in, like the pages themselves)
+ * - Categories: batched GraphQL, as Helix has no per-game count
+ * - Only the count fields in the EntityStore change, so only the
+ *   viewer count roles are re-emitted
+ * - Pauses while no page reports rows or the app is in the background
+ */
+class ViewerCountRefresher : public QObject
+{
+    Q_OBJECT
+
+public:
+    ViewerCountRefresher(EntityStore *store, AppLifecycle *lifecycle, QObject *parent = nullptr);
+
+    void setNetworkManager(NetworkManager *networkManager);
+    void setAuthToken(const QString &token);
+
+    // 'model' is a StreamListModel or CategoryListModel, or a proxy of
+    // one (SearchFilterModel); last < first clears
+    Q_INVOKABLE void setVisibleRows(QObject *model, int first, int last);
+    Q_INVOKABLE void clearVisibleRows(QObject *model);
+
+private slots:
+    void refresh();
+    void onStreamsForUsersReceived(const QStringList &userIds, const QVector<StreamInfo> &streams);
+    void onGqlReceived();
+    void onForegroundChanged(bool foreground);
+
+private:
+    struct Range {
+        QPointer<QObject> model;
+        int first;
+        int last;
+    };
+
+    EntityStore *m_store;
+    AppLifecycle *m_lifecycle;
+    TwitchHelixAPI *m_api;
+    QNetworkAccessManager *m_http;
+    QTimer *m_timer;
+
+    QHash<QObject*, Range> m_ranges;
+    QString m_authToken;
+
+    static const int REFRESH_INTERVAL_MS = 60000;
+    static const int IDS_PER_REQUEST = 100;
+    static const int GQL_BATCH_SIZE = 30;
+
+    void updateTimer();
+    void postGqlBatch(GqlOperations::Operation op, const QStringList &ids);
+};
+
+#endif // VIEWERCOUNTREFRESHER_H
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "applifecycle.h"
+#include "logging.h"
+#include <QGuiApplication>
+
+const int AppLifecycle::BACKGROUND_GRACE_MS;
+
+AppLifecycle::AppLifecycle(QObject *parent)
+    : QObject(parent)
+    , m_isForeground(true)
+    , m_backgroundTimer(new QTimer(this))
+{
+    m_backgroundTimer->setSingleShot(true);
+    m_backgroundTimer->setInterval(BACKGROUND_GRACE_MS);
+    connect(m_backgroundTimer, &QTimer::timeout, this, &AppLifecycle::onBackgroundGraceElapsed);
+
+    connect(qGuiApp, &QGuiApplication::applicationStateChanged,
+            this, &AppLifecycle::onApplicationStateChanged);
+}
+
+AppLifecycle::~AppLifecycle()
+{
+}
+
+void AppLifecycle::onApplicationStateChanged(Qt::ApplicationState state)
+{
+    if (state == Qt::ApplicationActive) {
+        // Coming back is reported immediately
+        m_backgroundTimer->stop();
+        setForeground(true);
+    } else if (m_isForeground && !m_backgroundTimer->isActive()) {
+        m_backgroundTimer->start();
+    }
+}
+
+void AppLifecycle::onBackgroundGraceElapsed()
+{
+    if (qGuiApp->applicationState() != Qt::ApplicationActive) {
+        setForeground(false);
+    }
+}
+
+void AppLifecycle::setForeground(bool foreground)
+{
+    if (m_isForeground == foreground) {
+        return;
+    }
+
+    m_isForeground = foreground;
+    LOG_APP((foreground ? "Entered foreground" : "Entered background"));
+    emit foregroundChanged(foreground);
+}
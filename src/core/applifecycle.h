@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef APPLIFECYCLE_H
+#define APPLIFECYCLE_H
+
+#include <QObject>
+#include <QTimer>
+
+/**
+ * AppLifecycle - Tracks whether the app is in the foreground
+ *
+ * Purpose: Let the player and background work react to the app being
+ * backgrounded or the screen being turned off.
+ *
+ * Features:
+ * - Follows QGuiApplication::applicationState
+ * - Short grace period before reporting background, so the app switcher
+ *   or a notification doesn't flip the player to audio-only
+ */
+class AppLifecycle : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool isForeground READ isForeground NOTIFY foregroundChanged)
+
+public:
+    explicit AppLifecycle(QObject *parent = nullptr);
+    ~AppLifecycle();
+
+    bool isForeground() const { return m_isForeground; }
+
+signals:
+    // Emitted when the app enters or leaves the foreground
+    void foregroundChanged(bool foreground);
+
+private slots:
+    void onApplicationStateChanged(Qt::ApplicationState state);
+    void onBackgroundGraceElapsed();
+
+private:
+    bool m_isForeground;
+    QTimer *m_backgroundTimer;
+
+    static const int BACKGROUND_GRACE_MS = 2000;
+
+    void setForeground(bool foreground);
+};
+
+#endif // APPLIFECYCLE_H
@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "parseworker.h"
+
+QThreadPool *ParseWorker::pool()
+{
+    // Separate from the global pool so QML image loading doesn't queue
+    // behind (or in front of) response parsing
+    static QThreadPool *instance = [] {
+        QThreadPool *p = new QThreadPool(qApp);
+        p->setMaxThreadCount(2);
+        p->setExpiryTimeout(30000);
+        return p;
+    }();
+    return instance;
+}
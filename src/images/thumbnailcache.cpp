@@ -0,0 +1,571 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "thumbnailcache.h"
+#include "../core/logging.h"
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QImageReader>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkRequest>
+#include <QPointer>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QSharedPointer>
+#include <QStandardPaths>
+#include <QtMath>
+#include <algorithm>
+
+const int ThumbnailCache::MEMORY_BUDGET_BYTES;
+const qint64 ThumbnailCache::DISK_BUDGET_BYTES;
+const int ThumbnailCache::LIVE_PREVIEW_TTL_SECS;
+const int ThumbnailCache::STATIC_IMAGE_TTL_SECS;
+const int ThumbnailCache::SAVE_DELAY_MS;
+const int ThumbnailCache::MAX_DECODES;
+
+static qint64 now()
+{
+    return QDateTime::currentSecsSinceEpoch();
+}
+
+ThumbnailCache::ThumbnailCache(QObject *parent)
+    : QObject(parent)
+    , m_network(new QNetworkAccessManager(this))
+    , m_pool(new QThreadPool(this))
+    , m_diskBytes(0)
+    , m_saveTimer(new QTimer(this))
+    , m_nextTicket(0)
+    , m_activeDecodes(0)
+{
+    m_pool->setMaxThreadCount(2);
+    m_pool->setExpiryTimeout(30000);
+
+    m_memory.setMaxCost(MEMORY_BUDGET_BYTES);
+
+    m_dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/thumbs";
+    QDir().mkpath(m_dir + "/blobs");
+
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(SAVE_DELAY_MS);
+    connect(m_saveTimer, &QTimer::timeout, this, &ThumbnailCache::saveIndex);
+
+    loadIndex();
+}
+
+ThumbnailCache::~ThumbnailCache()
+{
+    if (m_saveTimer->isActive()) {
+        saveIndex();
+    }
+    m_pool->waitForDone();
+}
+
+int ThumbnailCache::ttlFor(const QString &url)
+{
+    // Live previews are re-rendered by Twitch every few minutes
+    if (url.contains(QLatin1String("/previews-ttv/"))) {
+        return LIVE_PREVIEW_TTL_SECS;
+    }
+    return STATIC_IMAGE_TTL_SECS;
+}
+
+QString ThumbnailCache::blobPath(const QByteArray &blob) const
+{
+    return m_dir + "/blobs/" + QString::fromLatin1(blob);
+}
+
+QString ThumbnailCache::memoryKey(const QString &url, const QSize &size)
+{
+    if (size.width() <= 0 && size.height() <= 0) {
+        return url;
+    }
+    return url + QLatin1Char('|') + QString::number(size.width())
+           + QLatin1Char('x') + QString::number(size.height());
+}
+
+QImage ThumbnailCache::decodeScaled(QIODevice *device, const QSize &target)
+{
+    QImageReader reader(device);
+    QSize source = reader.size();
+
+    // Smallest size that still covers the target (delegates crop to fill).
+    // For JPEG this scales inside the decoder, so the full-size image
+    // never exists in memory.
+    if (source.isValid() && (target.width() > 0 || target.height() > 0)) {
+        qreal scale = qMax(target.width() > 0 ? qreal(target.width()) / source.width() : 0.0,
+                           target.height() > 0 ? qreal(target.height()) / source.height() : 0.0);
+        if (scale < 1.0) {
+            reader.setScaledSize(QSize(qMax(1, qCeil(source.width() * scale)),
+                                       qMax(1, qCeil(source.height() * scale))));
+        }
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        return image;
+    }
+
+    // The formats the scene graph uploads without converting
+    return image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied
+                                                         : QImage::Format_RGB32);
+}
+
+// ========================================
+// LOOKUP
+// ========================================
+
+QImage ThumbnailCache::cachedImage(const QString &url, const QSize &size)
+{
+    QMutexLocker lock(&m_memoryLock);
+    MemoryEntry *entry = m_memory.object(memoryKey(url, size));
+    if (!entry || entry->expires < now()) {
+        return QImage();
+    }
+    return entry->image;
+}
+
+quint64 ThumbnailCache::load(const QString &url, const QSize &size, Callback done)
+{
+    QString key = memoryKey(url, size);
+
+    // 1. Memory - stale images are still shown, just checked again
+    QImage image;
+    bool stale = false;
+    {
+        QMutexLocker lock(&m_memoryLock);
+        if (MemoryEntry *entry = m_memory.object(key)) {
+            image = entry->image;
+            stale = entry->expires < now();
+        }
+    }
+    if (!image.isNull()) {
+        done(image);
+        if (stale) {
+            fetch(url, size, true);
+        }
+        return 0;
+    }
+
+    quint64 ticket = ++m_nextTicket;
+    m_tickets.insert(ticket, key);
+
+    // Someone is already on it
+    auto waiting = m_waiting.find(key);
+    if (waiting != m_waiting.end()) {
+        waiting->append(Waiter{ticket, done});
+        return ticket;
+    }
+    m_waiting[key].append(Waiter{ticket, done});
+
+    if (m_revalidating.contains(key)) {
+        return ticket;
+    }
+
+    // 2. Disk, 3. network
+    auto it = m_index.find(url);
+    if (it != m_index.end() && QFile::exists(blobPath(it->blob))) {
+        it->used = now();
+        m_saveTimer->start();
+        decodeBlob(url, size, it.value());
+        return ticket;
+    }
+    if (it != m_index.end()) {
+        dropIndex(url);
+    }
+    fetch(url, size, false);
+    return ticket;
+}
+
+void ThumbnailCache::cancel(quint64 ticket)
+{
+    QString key = m_tickets.take(ticket);
+    if (key.isEmpty()) {
+        return;
+    }
+
+    auto waiting = m_waiting.find(key);
+    if (waiting == m_waiting.end()) {
+        return;
+    }
+    for (int i = 0; i < waiting->size(); ++i) {
+        if (waiting->at(i).ticket == ticket) {
+            waiting->remove(i);
+            break;
+        }
+    }
+    if (!waiting->isEmpty()) {
+        return;
+    }
+    m_waiting.erase(waiting);
+
+    // Nobody else wants it; a queued decode notices on its own
+    if (QNetworkReply *reply = m_replies.value(key)) {
+        reply->abort();
+    }
+}
+
+void ThumbnailCache::complete(const QString &key, const QImage &image)
+{
+    QVector<Waiter> waiters = m_waiting.take(key);
+    for (const Waiter &waiter : waiters) {
+        m_tickets.remove(waiter.ticket);
+        waiter.done(image);
+    }
+}
+
+// ========================================
+// NETWORK
+// ========================================
+
+void ThumbnailCache::fetch(const QString &url, const QSize &size, bool revalidate)
+{
+    QString key = memoryKey(url, size);
+    if (m_revalidating.contains(key) || m_replies.contains(key)
+            || (revalidate && m_waiting.contains(key))) {
+        return;
+    }
+
+    QNetworkRequest request{QUrl(url)};
+    request.setAttribute(QNetworkRequest::RedirectPolicyAttribute,
+                         QNetworkRequest::NoLessSafeRedirectPolicy);
+
+    if (revalidate) {
+        m_revalidating.insert(key);
+        auto it = m_index.constFind(url);
+        if (it != m_index.constEnd()) {
+            if (!it->etag.isEmpty()) {
+                request.setRawHeader("If-None-Match", it->etag);
+            }
+            if (!it->lastModified.isEmpty()) {
+                request.setRawHeader("If-Modified-Since", it->lastModified);
+            }
+        }
+    }
+
+    QNetworkReply *reply = m_network->get(request);
+    reply->setProperty("thumbUrl", url);
+    reply->setProperty("thumbSize", size);
+    if (!revalidate) {
+        m_replies.insert(key, reply);
+    }
+    connect(reply, &QNetworkReply::finished, this, &ThumbnailCache::onReplyFinished);
+}
+
+void ThumbnailCache::onReplyFinished()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    reply->deleteLater();
+
+    QString url = reply->property("thumbUrl").toString();
+    QSize size = reply->property("thumbSize").toSize();
+    QString key = memoryKey(url, size);
+
+    bool revalidation = m_revalidating.remove(key);
+    if (m_replies.value(key) == reply) {
+        m_replies.remove(key);
+    }
+    int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+
+    if (status == 304) {
+        // Unchanged - the copy on disk is good for another TTL
+        auto it = m_index.find(url);
+        if (it != m_index.end()) {
+            it->fetched = now();
+            it->used = it->fetched;
+            m_saveTimer->start();
+
+            QMutexLocker lock(&m_memoryLock);
+            if (MemoryEntry *entry = m_memory.object(key)) {
+                entry->expires = it->fetched + ttlFor(url);
+            }
+        }
+        if (m_waiting.contains(key)) {
+            if (it != m_index.end()) {
+                decodeBlob(url, size, it.value());
+            } else {
+                fetch(url, size, false);
+            }
+        }
+        return;
+    }
+
+    if (reply->error() == QNetworkReply::OperationCanceledError) {
+        complete(key, QImage());
+        return;
+    }
+    if (reply->error() != QNetworkReply::NoError) {
+        WARN_NETWORK("Thumbnail failed:" << url << reply->errorString());
+        complete(key, QImage());
+        return;
+    }
+
+    QByteArray bytes = reply->readAll();
+    DiskEntry entry;
+    entry.fetched = now();
+    entry.used = entry.fetched;
+    entry.size = bytes.size();
+    entry.etag = reply->rawHeader("ETag");
+    entry.lastModified = reply->rawHeader("Last-Modified");
+
+    QString dir = m_dir;
+    auto blob = QSharedPointer<QByteArray>::create();
+
+    queueDecode(DecodeJob{key,
+        [dir, bytes, blob, size](bool decode) {
+            *blob = QCryptographicHash::hash(bytes, QCryptographicHash::Sha1).toHex();
+
+            QString path = dir + "/blobs/" + QString::fromLatin1(*blob);
+            if (!QFile::exists(path)) {
+                QSaveFile file(path);
+                if (file.open(QIODevice::WriteOnly)) {
+                    file.write(bytes);
+                    file.commit();
+                }
+            }
+            if (!decode) {
+                return QImage();
+            }
+            QBuffer buffer;
+            buffer.setData(bytes);
+            buffer.open(QIODevice::ReadOnly);
+            return decodeScaled(&buffer, size);
+        },
+        [this, url, key, entry, blob, revalidation](const QImage &image, bool decoded) mutable {
+            entry.blob = *blob;
+            if (decoded && image.isNull()) {
+                complete(key, image);
+                return;
+            }
+
+            storeIndex(url, entry);
+            if (decoded) {
+                storeMemory(key, url, image, entry.fetched);
+                complete(key, image);
+            } else if (revalidation) {
+                // New content nobody is looking at: the next load reads it
+                QMutexLocker lock(&m_memoryLock);
+                m_memory.remove(key);
+            }
+        }});
+}
+
+// ========================================
+// DISK
+// ========================================
+
+void ThumbnailCache::decodeBlob(const QString &url, const QSize &size, const DiskEntry &entry)
+{
+    QString path = blobPath(entry.blob);
+    QString key = memoryKey(url, size);
+
+    queueDecode(DecodeJob{key,
+        [path, size](bool decode) {
+            if (!decode) {
+                return QImage();
+            }
+            QFile file(path);
+            if (!file.open(QIODevice::ReadOnly)) {
+                return QImage();
+            }
+            return decodeScaled(&file, size);
+        },
+        [this, url, size, key, entry](const QImage &image, bool decoded) {
+            if (!decoded) {
+                return;
+            }
+            if (image.isNull()) {
+                // Broken blob, start over from the network
+                dropIndex(url);
+                fetch(url, size, false);
+                return;
+            }
+
+            storeMemory(key, url, image, entry.fetched);
+            complete(key, image);
+
+            if (entry.fetched + ttlFor(url) < now()) {
+                fetch(url, size, true);
+            }
+        }});
+}
+
+void ThumbnailCache::queueDecode(const DecodeJob &job)
+{
+    m_decodeQueue.append(job);
+    pumpDecodes();
+}
+
+void ThumbnailCache::pumpDecodes()
+{
+    QPointer<ThumbnailCache> guard(this);
+
+    while (m_activeDecodes < MAX_DECODES && !m_decodeQueue.isEmpty()) {
+        // Newest first: that's what just scrolled into view
+        DecodeJob job = m_decodeQueue.takeLast();
+        bool decode = m_waiting.contains(job.key);
+
+        ++m_activeDecodes;
+        m_pool->start(QRunnable::create([guard, job, decode]() {
+            QImage image = job.work(decode);
+
+            QMetaObject::invokeMethod(qApp, [guard, job, image, decode]() {
+                if (!guard) {
+                    return;
+                }
+                guard->m_activeDecodes--;
+                job.finish(image, decode);
+                guard->pumpDecodes();
+            }, Qt::QueuedConnection);
+        }));
+    }
+}
+
+void ThumbnailCache::storeMemory(const QString &key, const QString &url, const QImage &image,
+                                 qint64 fetched)
+{
+    MemoryEntry *entry = new MemoryEntry{image, fetched + ttlFor(url)};
+    int cost = qMax(1, int(image.sizeInBytes()));
+
+    QMutexLocker lock(&m_memoryLock);
+    m_memory.insert(key, entry, cost);
+}
+
+void ThumbnailCache::storeIndex(const QString &url, const DiskEntry &entry)
+{
+    auto it = m_index.find(url);
+    if (it != m_index.end() && it->blob == entry.blob) {
+        *it = entry;
+        m_saveTimer->start();
+        return;
+    }
+    if (it != m_index.end()) {
+        dropIndex(url);
+    }
+
+    m_index.insert(url, entry);
+    if (m_blobRefs[entry.blob]++ == 0) {
+        m_diskBytes += entry.size;
+    }
+
+    enforceDiskBudget();
+    m_saveTimer->start();
+}
+
+void ThumbnailCache::dropIndex(const QString &url)
+{
+    auto it = m_index.find(url);
+    if (it == m_index.end()) {
+        return;
+    }
+
+    QByteArray blob = it->blob;
+    qint64 size = it->size;
+    m_index.erase(it);
+
+    auto ref = m_blobRefs.find(blob);
+    if (ref != m_blobRefs.end() && --ref.value() <= 0) {
+        m_blobRefs.erase(ref);
+        m_diskBytes -= size;
+        QFile::remove(blobPath(blob));
+    }
+    m_saveTimer->start();
+}
+
+void ThumbnailCache::enforceDiskBudget()
+{
+    if (m_diskBytes <= DISK_BUDGET_BYTES) {
+        return;
+    }
+
+    // Oldest use first, down to 90% so this doesn't run on every store
+    QVector<QPair<qint64, QString>> byUse;
+    byUse.reserve(m_index.size());
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        byUse.append(qMakePair(it->used, it.key()));
+    }
+    std::sort(byUse.begin(), byUse.end());
+
+    qint64 target = DISK_BUDGET_BYTES * 9 / 10;
+    for (const auto &item : byUse) {
+        if (m_diskBytes <= target) {
+            break;
+        }
+        dropIndex(item.second);
+    }
+}
+
+void ThumbnailCache::loadIndex()
+{
+    QFile file(m_dir + "/index.json");
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    // url -> [blob, fetched, used, size, etag, lastModified]
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = root.constBegin(); it != root.constEnd(); ++it) {
+        QJsonArray fields = it.value().toArray();
+        if (fields.size() < 6) {
+            continue;
+        }
+
+        DiskEntry entry;
+        entry.blob = fields[0].toString().toLatin1();
+        entry.fetched = qint64(fields[1].toDouble());
+        entry.used = qint64(fields[2].toDouble());
+        entry.size = qint64(fields[3].toDouble());
+        entry.etag = fields[4].toString().toLatin1();
+        entry.lastModified = fields[5].toString().toLatin1();
+
+        m_index.insert(it.key(), entry);
+        if (m_blobRefs[entry.blob]++ == 0) {
+            m_diskBytes += entry.size;
+        }
+    }
+
+    LOG_NETWORK("Thumbnail cache:" << m_index.size() << "entries,"
+                << m_diskBytes / 1024 << "KB on disk");
+}
+
+void ThumbnailCache::saveIndex()
+{
+    QJsonObject root;
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        root.insert(it.key(), QJsonArray{
+            QString::fromLatin1(it->blob),
+            double(it->fetched),
+            double(it->used),
+            double(it->size),
+            QString::fromLatin1(it->etag),
+            QString::fromLatin1(it->lastModified)
+        });
+    }
+
+    QSaveFile file(m_dir + "/index.json");
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QImage>
+#include <QIODevice>
+#include <QSize>
+#include <QCache>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+#include <QMutex>
+#include <QTimer>
+#include <QThreadPool>
+#include <functional>
+
+/**
+ * ThumbnailCache - Memory and disk cache behind the "thumbs" image provider
+ *
+ * Purpose: Plain Image { source: url } keeps nothing across page visits,
+ * so going back to a list downloaded and decoded every card again.
+ *
+ * Features:
+ * - Decoded images in a byte-budgeted LRU (QCache, cost = image bytes)
+ * - Downloads on disk, content-addressed: blobs are named by the SHA-1 of
+ *   their bytes, so the offline placeholder many channels share is stored
+ *   once. A small index maps URL -> blob, fetch time and validators.
+ * - TTL per kind: live previews go stale after a few minutes, box art
+ *   after a week. Stale images are shown right away and revalidated in
+ *   the background (If-None-Match / If-Modified-Since), so scrolling
+ *   back never waits on the network.
+ * - Disk budget enforced by dropping the least recently used entries
+ *
+ * - Decoded at the size the delegate draws (QImageReader::setScaledSize),
+ *   so decode time and texture memory follow the screen, not the source.
+ *   Memory entries are per URL and size; the disk keeps the download.
+ *
+ * All loading runs on the GUI thread except file I/O and decoding, which
+ * go to a small pool. At most MAX_DECODES decodes run at once, newest
+ * request first; a decode nobody waits for anymore is skipped (the
+ * download is still stored). cachedImage() may be called from any thread.
+ */
+class ThumbnailCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Callback = std::function<void(const QImage &image)>;
+
+    explicit ThumbnailCache(QObject *parent = nullptr);
+    ~ThumbnailCache();
+
+    // Any thread: the decoded image if it's in memory and still fresh.
+    // 'size' is the target size (either dimension may be 0 = any).
+    QImage cachedImage(const QString &url, const QSize &size);
+
+    // GUI thread: memory -> disk -> network. 'done' is called once, with a
+    // null image on failure, unless the returned ticket is cancelled first.
+    // Memory hits call 'done' right away and return 0.
+    quint64 load(const QString &url, const QSize &size, Callback done);
+
+    // GUI thread: forget a load; the download is aborted if it was the
+    // last one waiting for it
+    void cancel(quint64 ticket);
+
+private slots:
+    void onReplyFinished();
+    void saveIndex();
+
+private:
+    struct MemoryEntry {
+        QImage image;
+        qint64 expires;     // secs since epoch
+    };
+
+    struct DiskEntry {
+        QByteArray blob;    // SHA-1 hex of the bytes
+        qint64 fetched = 0;
+        qint64 used = 0;
+        qint64 size = 0;
+        QByteArray etag;
+        QByteArray lastModified;
+    };
+
+    QNetworkAccessManager *m_network;
+    QThreadPool *m_pool;
+    QString m_dir;
+
+    QMutex m_memoryLock;
+    QCache<QString, MemoryEntry> m_memory;
+
+    QHash<QString, DiskEntry> m_index;
+    QHash<QByteArray, int> m_blobRefs;
+    qint64 m_diskBytes;
+    QTimer *m_saveTimer;
+
+    struct Waiter {
+        quint64 ticket;
+        Callback done;
+    };
+
+    struct DecodeJob {
+        QString key;
+        std::function<QImage(bool decode)> work;                        // pool
+        std::function<void(const QImage &image, bool decoded)> finish;  // GUI
+    };
+
+    // Keyed by memoryKey()
+    QHash<QString, QVector<Waiter>> m_waiting;      // loads in flight
+    QHash<quint64, QString> m_tickets;
+    quint64 m_nextTicket;
+    QHash<QString, QNetworkReply*> m_replies;       // cancellable downloads
+    QSet<QString> m_revalidating;
+
+    QVector<DecodeJob> m_decodeQueue;
+    int m_activeDecodes;
+
+    static const int MEMORY_BUDGET_BYTES = 32 * 1024 * 1024;
+    static const qint64 DISK_BUDGET_BYTES = 64 * 1024 * 1024;
+    static const int LIVE_PREVIEW_TTL_SECS = 5 * 60;
+    static const int STATIC_IMAGE_TTL_SECS = 7 * 24 * 3600;
+    static const int SAVE_DELAY_MS = 5000;
+    static const int MAX_DECODES = 2;
+
+    static int ttlFor(const QString &url);
+    static QString memoryKey(const QString &url, const QSize &size);
+    static QImage decodeScaled(QIODevice *device, const QSize &target);
+    QString blobPath(const QByteArray &blob) const;
+
+    void storeMemory(const QString &key, const QString &url, const QImage &image, qint64 fetched);
+    void storeIndex(const QString &url, const DiskEntry &entry);
+    void dropIndex(const QString &url);
+    void enforceDiskBudget();
+    void loadIndex();
+
+    void fetch(const QString &url, const QSize &size, bool revalidate);
+    void decodeBlob(const QString &url, const QSize &size, const DiskEntry &entry);
+    void queueDecode(const DecodeJob &job);
+    void pumpDecodes();
+    void complete(const QString &key, const QImage &image);
+};
+
+#endif // THUMBNAILCACHE_H
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "thumbnailprovider.h"
+#include "thumbnailcache.h"
+#include "thumbnailscheduler.h"
+#include "thumbnailurl.h"
+
+// ========================================
+// RESPONSE
+// ========================================
+
+ThumbnailResponse::ThumbnailResponse(ThumbnailCache *cache, ThumbnailScheduler *scheduler,
+                                     const QString &url, const QSize &size)
+    : m_scheduler(scheduler)
+    , m_id(0)
+    , m_url(url)
+{
+    m_image = cache->cachedImage(url, size);
+    if (!m_image.isNull()) {
+        // finished() must not fire before the engine connected to it
+        QMetaObject::invokeMethod(this, &ThumbnailResponse::finished, Qt::QueuedConnection);
+        return;
+    }
+
+    // The engine keeps a response alive until finished(), even when it
+    // cancels it, so 'this' is safe to capture. The scheduler calls back
+    // exactly once, also for cancelled requests.
+    m_id = scheduler->reserveId();
+    quint64 id = m_id;
+    QMetaObject::invokeMethod(scheduler, [this, scheduler, id, url, size]() {
+        scheduler->request(id, url, size, [this](const QImage &image) {
+            m_image = image;
+            emit finished();
+        });
+    }, Qt::QueuedConnection);
+}
+
+void ThumbnailResponse::cancel()
+{
+    if (m_id == 0) {
+        return;     // memory hit, finished() is already on its way
+    }
+
+    ThumbnailScheduler *scheduler = m_scheduler;
+    quint64 id = m_id;
+    QMetaObject::invokeMethod(scheduler, [scheduler, id]() {
+        scheduler->cancel(id);
+    }, Qt::QueuedConnection);
+}
+
+QQuickTextureFactory *ThumbnailResponse::textureFactory() const
+{
+    return QQuickTextureFactory::textureFactoryForImage(m_image);
+}
+
+QString ThumbnailResponse::errorString() const
+{
+    return m_image.isNull() ? QStringLiteral("Failed to load %1").arg(m_url) : QString();
+}
+
+// ========================================
+// PROVIDER
+// ========================================
+
+ThumbnailProvider::ThumbnailProvider(ThumbnailCache *cache, ThumbnailScheduler *scheduler)
+    : m_cache(cache)
+    , m_scheduler(scheduler)
+{
+}
+
+QQuickImageResponse *ThumbnailProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    // The CDN rendition comes from a coarse ladder; decoding then scales
+    // it to exactly what is drawn
+    return new ThumbnailResponse(m_cache, m_scheduler, ThumbnailUrl::forSize(id, requestedSize),
+                                 requestedSize);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef THUMBNAILPROVIDER_H
+#define THUMBNAILPROVIDER_H
+
+#include <QQuickAsyncImageProvider>
+#include <QQuickImageResponse>
+#include <QImage>
+
+class ThumbnailCache;
+class ThumbnailScheduler;
+
+/**
+ * ThumbnailResponse - One "image://thumbs/..." request
+ *
+ * Created on QML's image loader thread. Memory hits finish right away,
+ * everything else is queued with ThumbnailScheduler on the GUI thread.
+ */
+class ThumbnailResponse : public QQuickImageResponse
+{
+    Q_OBJECT
+
+public:
+    ThumbnailResponse(ThumbnailCache *cache, ThumbnailScheduler *scheduler,
+                      const QString &url, const QSize &size);
+
+    QQuickTextureFactory *textureFactory() const override;
+    QString errorString() const override;
+    void cancel() override;
+
+private:
+    ThumbnailScheduler *m_scheduler;
+    quint64 m_id;
+    QString m_url;
+    QImage m_image;
+};
+
+/**
+ * ThumbnailProvider - Image provider "thumbs" for stream previews and box art
+ *
+ * Usage in QML: source: "image://thumbs/" + model.thumbnailUrl, with
+ * sourceSize set to the drawn size (see components/Thumbnail.qml)
+ */
+class ThumbnailProvider : public QQuickAsyncImageProvider
+{
+public:
+    ThumbnailProvider(ThumbnailCache *cache, ThumbnailScheduler *scheduler);
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+private:
+    ThumbnailCache *m_cache;
+    ThumbnailScheduler *m_scheduler;
+};
+
+#endif // THUMBNAILPROVIDER_H
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "thumbnailscheduler.h"
+#include "thumbnailcache.h"
+#include "../core/applifecycle.h"
+#include <QtMath>
+
+const int ThumbnailScheduler::MAX_ACTIVE_LOADS;
+const int ThumbnailScheduler::SETTLE_DELAY_MS;
+const int ThumbnailScheduler::VELOCITY_EXPIRY_MS;
+
+// Viewport heights per second; a slow drag still loads as it goes
+static const qreal FLING_SPEED = 1.5;
+
+ThumbnailScheduler::ThumbnailScheduler(ThumbnailCache *cache, AppLifecycle *lifecycle, QObject *parent)
+    : QObject(parent)
+    , m_cache(cache)
+    , m_lifecycle(lifecycle)
+    , m_nextId(0)
+    , m_velocity(0)
+    , m_settleTimer(new QTimer(this))
+    , m_expiryTimer(new QTimer(this))
+{
+    // Flickable reports velocity 0 for a frame between drags; don't
+    // drain the queue on that
+    m_settleTimer->setSingleShot(true);
+    m_settleTimer->setInterval(SETTLE_DELAY_MS);
+    connect(m_settleTimer, &QTimer::timeout, this, &ThumbnailScheduler::pump);
+
+    // A flinging Flickable reports a new velocity every frame; silence
+    // means nobody is scrolling anymore
+    m_expiryTimer->setSingleShot(true);
+    m_expiryTimer->setInterval(VELOCITY_EXPIRY_MS);
+    connect(m_expiryTimer, &QTimer::timeout, this, [this]() { setVelocity(0); });
+
+    if (m_lifecycle) {
+        connect(m_lifecycle, &AppLifecycle::foregroundChanged,
+                this, &ThumbnailScheduler::onForegroundChanged);
+    }
+}
+
+quint64 ThumbnailScheduler::reserveId()
+{
+    return ++m_nextId;
+}
+
+bool ThumbnailScheduler::isFlinging() const
+{
+    return qAbs(m_velocity) > FLING_SPEED;
+}
+
+bool ThumbnailScheduler::isHeldBack() const
+{
+    // Nobody sees the grids in the background - don't spend data or
+    // battery on them
+    return isFlinging() || (m_lifecycle && !m_lifecycle->isForeground());
+}
+
+void ThumbnailScheduler::onForegroundChanged(bool foreground)
+{
+    if (foreground) {
+        pump();
+    }
+}
+
+void ThumbnailScheduler::setVelocity(qreal velocity)
+{
+    if (qFuzzyCompare(m_velocity, velocity)) {
+        return;
+    }
+
+    bool wasFlinging = isFlinging();
+    m_velocity = velocity;
+    emit velocityChanged();
+
+    if (qFuzzyIsNull(m_velocity)) {
+        m_expiryTimer->stop();
+    } else {
+        m_expiryTimer->start();
+    }
+
+    if (wasFlinging && !isFlinging()) {
+        m_settleTimer->start();
+    } else if (isFlinging()) {
+        m_settleTimer->stop();
+    }
+}
+
+// ========================================
+// QUEUE
+// ========================================
+
+void ThumbnailScheduler::request(quint64 id, const QString &url, const QSize &size, Callback done)
+{
+    m_queued.append(Job{id, url, size, done, 0});
+    if (!m_settleTimer->isActive()) {
+        pump();
+    }
+}
+
+void ThumbnailScheduler::cancel(quint64 id)
+{
+    for (int i = 0; i < m_queued.size(); ++i) {
+        if (m_queued[i].id == id) {
+            Job job = m_queued.takeAt(i);
+            job.done(QImage());
+            return;
+        }
+    }
+
+    auto it = m_active.find(id);
+    if (it == m_active.end()) {
+        return;     // already delivered
+    }
+    Job job = it.value();
+    m_active.erase(it);
+    m_cache->cancel(job.ticket);
+    job.done(QImage());
+    pump();
+}
+
+void ThumbnailScheduler::pump()
+{
+    if (isHeldBack()) {
+        return;
+    }
+
+    while (m_active.size() < MAX_ACTIVE_LOADS && !m_queued.isEmpty()) {
+        // Newest first: those are where the view came to rest
+        Job job = m_queued.takeLast();
+        quint64 id = job.id;
+        m_active.insert(id, job);
+
+        quint64 ticket = m_cache->load(job.url, job.size, [this, id](const QImage &image) {
+            onLoaded(id, image);
+        });
+
+        // Memory hits are delivered inside load()
+        auto it = m_active.find(id);
+        if (it != m_active.end()) {
+            it->ticket = ticket;
+        }
+    }
+}
+
+void ThumbnailScheduler::onLoaded(quint64 id, const QImage &image)
+{
+    auto it = m_active.find(id);
+    if (it == m_active.end()) {
+        return;
+    }
+    Job job = it.value();
+    m_active.erase(it);
+    job.done(image);
+
+    // Called from inside load() for memory hits; pump() continues there
+    QMetaObject::invokeMethod(this, &ThumbnailScheduler::pump, Qt::QueuedConnection);
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef THUMBNAILSCHEDULER_H
+#define THUMBNAILSCHEDULER_H
+
+#include <QObject>
+#include <QAtomicInteger>
+#include <QHash>
+#include <QImage>
+#include <QSize>
+#include <QTimer>
+#include <QVector>
+#include <functional>
+
+class AppLifecycle;
+class ThumbnailCache;
+
+/**
+ * ThumbnailScheduler - Decides when a thumbnail load may start
+ *
+ * Purpose: A fast flick through a long grid used to start a download and
+ * decode for every card that flashed past.
+ *
+ * Features:
+ * - The pages report their scroll speed (viewport heights per second);
+ *   above FLING_SPEED new loads wait in a queue
+ * - Once scrolling slows down the queue drains newest first, at most
+ *   MAX_ACTIVE_LOADS at a time
+ * - A velocity that isn't updated for VELOCITY_EXPIRY_MS counts as 0, so
+ *   a page destroyed mid-fling can't hold the queue forever
+ * - Cancelled requests (delegate destroyed or scrolled out of reach)
+ *   leave the queue, or cancel their cache load if already running
+ * - Memory hits never get here (see ThumbnailResponse)
+ * - While the app is in the background nothing new starts; the queue
+ *   drains once it's back in the foreground
+ *
+ * request() and cancel() run on the GUI thread; ids come from
+ * reserveId(), which any thread may call.
+ */
+class ThumbnailScheduler : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(qreal velocity READ velocity WRITE setVelocity NOTIFY velocityChanged)
+
+public:
+    using Callback = std::function<void(const QImage &image)>;
+
+    ThumbnailScheduler(ThumbnailCache *cache, AppLifecycle *lifecycle, QObject *parent = nullptr);
+
+    quint64 reserveId();
+
+    // 'done' is called exactly once, with a null image when cancelled
+    void request(quint64 id, const QString &url, const QSize &size, Callback done);
+    void cancel(quint64 id);
+
+    qreal velocity() const { return m_velocity; }
+    void setVelocity(qreal velocity);
+
+signals:
+    void velocityChanged();
+
+private slots:
+    void pump();
+    void onForegroundChanged(bool foreground);
+
+private:
+    struct Job {
+        quint64 id;
+        QString url;
+        QSize size;
+        Callback done;
+        quint64 ticket;
+    };
+
+    ThumbnailCache *m_cache;
+    AppLifecycle *m_lifecycle;
+    QAtomicInteger<quint64> m_nextId;
+    qreal m_velocity;
+    QTimer *m_settleTimer;
+    QTimer *m_expiryTimer;
+
+    QVector<Job> m_queued;
+    QHash<quint64, Job> m_active;
+
+    static const int MAX_ACTIVE_LOADS = 6;
+    static const int SETTLE_DELAY_MS = 120;
+    static const int VELOCITY_EXPIRY_MS = 400;
+
+    bool isFlinging() const;
+    bool isHeldBack() const;
+    void onLoaded(quint64 id, const QImage &image);
+};
+
+#endif // THUMBNAILSCHEDULER_H
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "thumbnailurl.h"
+#include <QRegularExpression>
+#include <QtMath>
+
+// Widths the CDN is asked for; heights follow the image's aspect ratio
+static const int WIDTH_LADDER[] = { 40, 80, 160, 240, 320, 440, 640, 960, 1280 };
+
+QString ThumbnailUrl::forSize(const QString &url, const QSize &requested)
+{
+    if (requested.width() <= 0 && requested.height() <= 0) {
+        return url;
+    }
+
+    // ".../live_user_foo-440x248.jpg", ".../33214-{width}x{height}.jpg"
+    static const QRegularExpression sizePattern(
+        QStringLiteral("-(\\d+|\\{width\\})x(\\d+|\\{height\\})(\\.[A-Za-z]+)(\\?.*)?$"));
+
+    QRegularExpressionMatch match = sizePattern.match(url);
+    if (!match.hasMatch()) {
+        return url;
+    }
+
+    // Aspect from the URL, or from the request for bare templates
+    bool okW = false;
+    bool okH = false;
+    int sourceW = match.captured(1).toInt(&okW);
+    int sourceH = match.captured(2).toInt(&okH);
+    qreal aspect = (okW && okH && sourceH > 0) ? qreal(sourceW) / sourceH
+                 : (requested.width() > 0 && requested.height() > 0)
+                   ? qreal(requested.width()) / requested.height()
+                   : 16.0 / 9.0;
+
+    // Cover both dimensions (delegates crop to fill)
+    int needed = qMax(requested.width(), qCeil(requested.height() * aspect));
+
+    int width = WIDTH_LADDER[sizeof(WIDTH_LADDER) / sizeof(WIDTH_LADDER[0]) - 1];
+    for (int step : WIDTH_LADDER) {
+        if (step >= needed) {
+            width = step;
+            break;
+        }
+    }
+    int height = qMax(1, qRound(width / aspect));
+
+    QString result = url;
+    result.replace(match.capturedStart(1), match.capturedEnd(2) - match.capturedStart(1),
+                   QString::number(width) + QLatin1Char('x') + QString::number(height));
+    return result;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef THUMBNAILURL_H
+#define THUMBNAILURL_H
+
+#include <QString>
+#include <QSize>
+
+/**
+ * ThumbnailUrl - Picks the CDN rendition of a thumbnail for a target size
+ *
+ * Twitch's static CDN renders previews and box art at any "-WxH" size,
+ * and Helix hands out "{width}x{height}" templates. The models carry one
+ * fixed size (440x248 / 285x380); the image layer swaps it for the
+ * smallest size from a short ladder that still covers what is drawn.
+ * The ladder keeps the number of distinct cache entries small.
+ */
+namespace ThumbnailUrl
+{
+    // 'requested' as passed to the image provider (sourceSize, in pixels);
+    // returns 'url' unchanged if it has no size or no size was requested
+    QString forSize(const QString &url, const QSize &requested);
+}
+
+#endif // THUMBNAILURL_H
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "categorylistmodel.h"
+#include "listdiff.h"
+#include "entitystore.h"
+
+CategoryListModel::CategoryListModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(nullptr)
+    , m_refreshPending(true)
+{
+}
+
+void CategoryListModel::setEntityStore(EntityStore *store)
+{
+    m_store = store;
+    connect(m_store, &EntityStore::gamesChanged, this, &CategoryListModel::onGamesChanged);
+}
+
+int CategoryListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_ids.size();
+}
+
+QVariant CategoryListModel::data(const QModelIndex &index, int role) const
+{
+    if (!m_store || !index.isValid() || index.row() >= m_ids.size()) {
+        return QVariant();
+    }
+
+    const GameEntity *game = m_store->game(m_ids[index.row()]);
+    if (!game) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case IdRole:           return game->id;
+    case NameRole:         return game->name;
+    case BoxArtUrlRole:    return game->boxArtUrl;
+    case TagsRole:         return game->tags;
+    case ViewersCountRole: return game->viewersCount;
+    default:               return QVariant();
+    }
+}
+
+QHash<int, QByteArray> CategoryListModel::roleNames() const
+{
+    static const QHash<int, QByteArray> roles = {
+        { IdRole, "id" },
+        { NameRole, "name" },
+        { BoxArtUrlRole, "boxArtUrl" },
+        { TagsRole, "tags" },
+        { ViewersCountRole, "viewersCount" }
+    };
+    return roles;
+}
+
+void CategoryListModel::clear()
+{
+    if (m_ids.isEmpty()) {
+        return;
+    }
+
+    beginResetModel();
+    QVector<QString> released;
+    released.swap(m_ids);
+    endResetModel();
+
+    m_store->releaseGames(released);
+    emit countChanged();
+}
+
+void CategoryListModel::beginRefresh()
+{
+    m_refreshPending = true;
+    m_refreshIds.clear();
+}
+
+void CategoryListModel::receive(const QVector<CategoryInfo> &categories)
+{
+    receiveBatch(categories, true);
+}
+
+void CategoryListModel::receiveBatch(const QVector<CategoryInfo> &categories, bool complete)
+{
+    if (!m_refreshPending) {
+        appendCategories(categories);
+        return;
+    }
+    if (!m_store) {
+        return;
+    }
+
+    m_refreshIds += m_store->putCategories(categories);
+    QVector<QString> target = m_refreshIds;
+
+    if (complete) {
+        m_refreshPending = false;
+        m_refreshIds.clear();
+    } else {
+        QSet<QString> received(target.cbegin(), target.cend());
+        for (const QString &id : qAsConst(m_ids)) {
+            if (!received.contains(id)) {
+                target.append(id);
+            }
+        }
+    }
+
+    applyIds(target);
+}
+
+ListDiffOps CategoryListModel::diffOps()
+{
+    ListDiffOps ops;
+    ops.beginRemove = [this](int first, int last) { beginRemoveRows(QModelIndex(), first, last); };
+    ops.endRemove = [this]() { endRemoveRows(); };
+    ops.beginInsert = [this](int first, int last) { beginInsertRows(QModelIndex(), first, last); };
+    ops.endInsert = [this]() { endInsertRows(); };
+    ops.beginMove = [this](int from, int to) { beginMoveRows(QModelIndex(), from, from, QModelIndex(), to); };
+    ops.endMove = [this]() { endMoveRows(); };
+    ops.changed = [this](int row, const QVector<int> &roles) {
+        QModelIndex idx = index(row);
+        emit dataChanged(idx, idx, roles);
+    };
+    return ops;
+}
+
+void CategoryListModel::setCategories(const QVector<CategoryInfo> &categories)
+{
+    if (!m_store) {
+        return;
+    }
+
+    applyIds(m_store->putCategories(categories));
+}
+
+void CategoryListModel::applyIds(const QVector<QString> &ids)
+{
+    QSet<QString> before(m_ids.cbegin(), m_ids.cend());
+    QSet<QString> after(ids.cbegin(), ids.cend());
+
+    m_store->retainGames(toVector(after - before));
+
+    int oldCount = m_ids.size();
+    auto identity = [](const QString &id) { return id; };
+    auto noRoles = [](const QString &, const QString &) { return QVector<int>(); };
+    applyKeyedDiff(m_ids, ids, identity, noRoles, diffOps());
+
+    m_store->releaseGames(toVector(before - after));
+
+    if (m_ids.size() != oldCount) {
+        emit countChanged();
+    }
+}
+
+void CategoryListModel::appendCategories(const QVector<CategoryInfo> &categories)
+{
+    if (!m_store) {
+        return;
+    }
+
+    QVector<QString> ids = m_store->putCategories(categories);
+
+    QSet<QString> seen(m_ids.cbegin(), m_ids.cend());
+    QVector<QString> fresh = uniqueByKey(ids, [](const QString &id) { return id; }, &seen);
+
+    if (fresh.isEmpty()) {
+        return;
+    }
+
+    m_store->retainGames(fresh);
+
+    int first = m_ids.size();
+    beginInsertRows(QModelIndex(), first, first + fresh.size() - 1);
+    m_ids.append(fresh);
+    endInsertRows();
+    emit countChanged();
+}
+
+void CategoryListModel::onGamesChanged(const QHash<QString, int> &fields)
+{
+    for (int row = 0; row < m_ids.size(); ++row) {
+        auto it = fields.constFind(m_ids[row]);
+        if (it == fields.constEnd()) {
+            continue;
+        }
+
+        int mask = it.value();
+        QVector<int> roles;
+        if (mask & EntityStore::GameNameField)     roles << NameRole;
+        if (mask & EntityStore::BoxArtField)       roles << BoxArtUrlRole;
+        if (mask & EntityStore::GameTagsField)     roles << TagsRole;
+        if (mask & EntityStore::ViewersCountField) roles << ViewersCountRole;
+
+        QModelIndex idx = index(row);
+        emit dataChanged(idx, idx, roles);
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CATEGORYLISTMODEL_H
+#define CATEGORYLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include "streaminfo.h"
+
+class EntityStore;
+struct ListDiffOps;
+
+/**
+ * CategoryListModel - Categories for the top categories grid
+ *
+ * Same idea as StreamListModel: CategoryInfo batches from Helix or
+ * GraphQL, role names matching the old QML ListModel fields. Rows are
+ * game ids into the shared EntityStore; refreshes are diffed by id
+ * instead of resetting the grid.
+ */
+class CategoryListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        IdRole = Qt::UserRole + 1,
+        NameRole,
+        BoxArtUrlRole,
+        TagsRole,
+        ViewersCountRole
+    };
+
+    explicit CategoryListModel(QObject *parent = nullptr);
+
+    // Shared entity store (called from main.cpp)
+    void setEntityStore(EntityStore *store);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return m_ids.size(); }
+    QString idAt(int row) const { return m_ids[row]; }
+
+    // Next received response replaces the content instead of appending
+    Q_INVOKABLE void beginRefresh();
+
+    Q_INVOKABLE void clear();
+
+    void receive(const QVector<CategoryInfo> &categories);
+
+    // One batch of a response still downloading (see StreamListModel)
+    void receiveBatch(const QVector<CategoryInfo> &categories, bool complete);
+
+    void setCategories(const QVector<CategoryInfo> &categories);
+    void appendCategories(const QVector<CategoryInfo> &categories);
+
+signals:
+    void countChanged();
+
+private slots:
+    void onGamesChanged(const QHash<QString, int> &fields);
+
+private:
+    EntityStore *m_store;
+    QVector<QString> m_ids;
+    bool m_refreshPending;
+    QVector<QString> m_refreshIds;
+
+    ListDiffOps diffOps();
+    void applyIds(const QVector<QString> &ids);
+};
+
+#endif // CATEGORYLISTMODEL_H
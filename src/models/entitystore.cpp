@@ -0,0 +1,381 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "entitystore.h"
+
+const int EntityStore::STRING_PRUNE_INTERVAL;
+
+EntityStore::EntityStore(QObject *parent)
+    : QObject(parent)
+    , m_releasedSincePrune(0)
+{
+}
+
+QString EntityStore::streamKey(const StreamInfo &stream)
+{
+    // One live stream per channel; the GraphQL path has no stable stream id
+    return stream.userId.isEmpty() ? stream.userLogin : stream.userId;
+}
+
+// ========================================
+// UPSERTS
+// ========================================
+
+QVector<QString> EntityStore::putStreams(const QVector<StreamInfo> &streams)
+{
+    QVector<QString> keys;
+    keys.reserve(streams.size());
+    QHash<QString, int> streamChanges;
+    QHash<QString, int> gameChanges;
+
+    for (const StreamInfo &info : streams) {
+        QString key = streamKey(info);
+        if (key.isEmpty()) {
+            continue;
+        }
+        keys.append(key);
+
+        int mask = 0;
+
+        UserEntity &user = m_users[key];
+        if (!info.userId.isEmpty()) {
+            user.id = info.userId;
+        }
+        if (!info.userLogin.isEmpty() && user.login != info.userLogin) {
+            user.login = info.userLogin;
+            mask |= UserField;
+        }
+        if (!info.userName.isEmpty() && user.displayName != info.userName) {
+            user.displayName = info.userName;
+            mask |= UserField;
+        }
+
+        if (!info.gameId.isEmpty()) {
+            GameEntity &game = m_games[info.gameId];
+            game.id = intern(info.gameId);
+            if (!info.gameName.isEmpty() && game.name != info.gameName) {
+                game.name = intern(info.gameName);
+                gameChanges[info.gameId] |= GameNameField;
+            }
+        }
+
+        auto it = m_streams.find(key);
+        if (it == m_streams.end()) {
+            StreamEntity entity;
+            entity.key = key;
+            entity.id = info.id;
+            entity.gameId = intern(info.gameId);
+            entity.title = info.title;
+            entity.language = intern(info.language);
+            entity.thumbnailUrl = info.thumbnailUrl;
+            entity.tags = intern(info.tags);
+            entity.viewerCount = info.viewerCount;
+            m_streams.insert(key, entity);
+            continue;
+        }
+
+        StreamEntity &entity = it.value();
+        if (entity.id != info.id) {
+            entity.id = info.id;
+            mask |= StreamIdField;
+        }
+        if (entity.title != info.title) {
+            entity.title = info.title;
+            mask |= TitleField;
+        }
+        if (entity.viewerCount != info.viewerCount) {
+            entity.viewerCount = info.viewerCount;
+            mask |= ViewerCountField;
+        }
+        if (entity.thumbnailUrl != info.thumbnailUrl) {
+            entity.thumbnailUrl = info.thumbnailUrl;
+            mask |= ThumbnailField;
+        }
+
+        // Not every backend sends these (GraphQL game listings don't) -
+        // keep what another source already told us
+        if (!info.gameId.isEmpty() && entity.gameId != info.gameId) {
+            if (entity.refs > 0) {
+                dropGameRef(entity.gameId);
+                addGameRef(info.gameId);
+            }
+            entity.gameId = intern(info.gameId);
+            mask |= GameField;
+        }
+        if (!info.language.isEmpty() && entity.language != info.language) {
+            entity.language = intern(info.language);
+            mask |= LanguageField;
+        }
+        if (!info.tags.isEmpty() && entity.tags != info.tags) {
+            entity.tags = intern(info.tags);
+            mask |= TagsField;
+        }
+
+        if (mask) {
+            streamChanges[key] |= mask;
+        }
+    }
+
+    if (!gameChanges.isEmpty()) {
+        emit gamesChanged(gameChanges);
+    }
+    if (!streamChanges.isEmpty()) {
+        emit streamsChanged(streamChanges);
+    }
+
+    return keys;
+}
+
+QVector<QString> EntityStore::putCategories(const QVector<CategoryInfo> &categories)
+{
+    QVector<QString> ids;
+    ids.reserve(categories.size());
+    QHash<QString, int> gameChanges;
+
+    for (const CategoryInfo &info : categories) {
+        if (info.id.isEmpty()) {
+            continue;
+        }
+        ids.append(info.id);
+
+        bool isNew = !m_games.contains(info.id);
+        GameEntity &game = m_games[info.id];
+        int mask = 0;
+
+        game.id = intern(info.id);
+        if (game.name != info.name) {
+            game.name = intern(info.name);
+            mask |= GameNameField;
+        }
+        if (!info.boxArtUrl.isEmpty() && game.boxArtUrl != info.boxArtUrl) {
+            game.boxArtUrl = info.boxArtUrl;
+            mask |= BoxArtField;
+        }
+        if (!info.tags.isEmpty() && game.tags != info.tags) {
+            game.tags = intern(info.tags);
+            mask |= GameTagsField;
+        }
+        // Helix reports 0 (unknown) - don't wipe a GraphQL count
+        if (info.viewersCount > 0 && game.viewersCount != info.viewersCount) {
+            game.viewersCount = info.viewersCount;
+            mask |= ViewersCountField;
+        }
+
+        if (mask && !isNew) {
+            gameChanges[info.id] |= mask;
+        }
+    }
+
+    if (!gameChanges.isEmpty()) {
+        emit gamesChanged(gameChanges);
+    }
+
+    return ids;
+}
+
+void EntityStore::setViewerCounts(const QHash<QString, int> &streams)
+{
+    QHash<QString, int> changes;
+    for (auto it = streams.cbegin(); it != streams.cend(); ++it) {
+        auto entity = m_streams.find(it.key());
+        if (entity != m_streams.end() && entity->viewerCount != it.value()) {
+            entity->viewerCount = it.value();
+            changes.insert(it.key(), ViewerCountField);
+        }
+    }
+
+    if (!changes.isEmpty()) {
+        emit streamsChanged(changes);
+    }
+}
+
+void EntityStore::setGameViewerCounts(const QHash<QString, int> &games)
+{
+    QHash<QString, int> changes;
+    for (auto it = games.cbegin(); it != games.cend(); ++it) {
+        auto game = m_games.find(it.key());
+        if (game != m_games.end() && game->viewersCount != it.value()) {
+            game->viewersCount = it.value();
+            changes.insert(it.key(), ViewersCountField);
+        }
+    }
+
+    if (!changes.isEmpty()) {
+        emit gamesChanged(changes);
+    }
+}
+
+// ========================================
+// REFERENCE COUNTING
+// ========================================
+
+void EntityStore::retainStreams(const QVector<QString> &keys)
+{
+    for (const QString &key : keys) {
+        auto it = m_streams.find(key);
+        if (it == m_streams.end()) {
+            continue;
+        }
+        if (it->refs++ == 0) {
+            m_users[key].refs++;
+            addGameRef(it->gameId);
+        }
+    }
+}
+
+void EntityStore::releaseStreams(const QVector<QString> &keys)
+{
+    for (const QString &key : keys) {
+        auto it = m_streams.find(key);
+        if (it == m_streams.end() || --it->refs > 0) {
+            continue;
+        }
+
+        dropGameRef(it->gameId);
+        m_streams.erase(it);
+
+        auto user = m_users.find(key);
+        if (user != m_users.end() && --user->refs <= 0) {
+            m_users.erase(user);
+        }
+
+        if (++m_releasedSincePrune >= STRING_PRUNE_INTERVAL) {
+            pruneStrings();
+        }
+    }
+}
+
+void EntityStore::retainGames(const QVector<QString> &ids)
+{
+    for (const QString &id : ids) {
+        addGameRef(id);
+    }
+}
+
+void EntityStore::releaseGames(const QVector<QString> &ids)
+{
+    for (const QString &id : ids) {
+        dropGameRef(id);
+    }
+}
+
+void EntityStore::addGameRef(const QString &id)
+{
+    auto it = m_games.find(id);
+    if (it != m_games.end()) {
+        it->refs++;
+    }
+}
+
+void EntityStore::dropGameRef(const QString &id)
+{
+    auto it = m_games.find(id);
+    if (it != m_games.end() && --it->refs <= 0) {
+        m_games.erase(it);
+    }
+}
+
+// ========================================
+// LOOKUP
+// ========================================
+
+const StreamEntity *EntityStore::stream(const QString &key) const
+{
+    auto it = m_streams.constFind(key);
+    return it == m_streams.constEnd() ? nullptr : &it.value();
+}
+
+const UserEntity *EntityStore::user(const QString &key) const
+{
+    auto it = m_users.constFind(key);
+    return it == m_users.constEnd() ? nullptr : &it.value();
+}
+
+const GameEntity *EntityStore::game(const QString &id) const
+{
+    auto it = m_games.constFind(id);
+    return it == m_games.constEnd() ? nullptr : &it.value();
+}
+
+StreamInfo EntityStore::streamInfo(const QString &key) const
+{
+    StreamInfo info;
+    const StreamEntity *entity = stream(key);
+    if (!entity) {
+        return info;
+    }
+
+    info.id = entity->id;
+    info.gameId = entity->gameId;
+    info.title = entity->title;
+    info.language = entity->language;
+    info.thumbnailUrl = entity->thumbnailUrl;
+    info.tags = entity->tags;
+    info.viewerCount = entity->viewerCount;
+
+    if (const UserEntity *u = user(key)) {
+        info.userId = u->id;
+        info.userLogin = u->login;
+        info.userName = u->displayName;
+    }
+    if (const GameEntity *g = game(entity->gameId)) {
+        info.gameName = g->name;
+    }
+    return info;
+}
+
+// ========================================
+// STRING INTERNING
+// ========================================
+
+QString EntityStore::intern(const QString &value)
+{
+    if (value.isEmpty()) {
+        return value;
+    }
+
+    // Returning the pooled copy makes equal strings share one buffer
+    auto it = m_strings.constFind(value);
+    if (it != m_strings.constEnd()) {
+        return *it;
+    }
+    m_strings.insert(value);
+    return value;
+}
+
+QStringList EntityStore::intern(const QStringList &values)
+{
+    QStringList result;
+    result.reserve(values.size());
+    for (const QString &value : values) {
+        result.append(intern(value));
+    }
+    return result;
+}
+
+void EntityStore::pruneStrings()
+{
+    m_releasedSincePrune = 0;
+
+    // Only the pool still holds these
+    for (auto it = m_strings.begin(); it != m_strings.end(); ) {
+        if (it->isDetached()) {
+            it = m_strings.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
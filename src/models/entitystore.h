@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ENTITYSTORE_H
+#define ENTITYSTORE_H
+
+#include <QObject>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include "streaminfo.h"
+
+struct UserEntity
+{
+    QString id;
+    QString login;
+    QString displayName;
+    int refs = 0;
+};
+
+struct GameEntity
+{
+    QString id;
+    QString name;
+    QString boxArtUrl;
+    QStringList tags;
+    int viewersCount = 0;
+    int refs = 0;
+};
+
+struct StreamEntity
+{
+    QString key;            // channel key, also the UserEntity key
+    QString id;             // changes with every broadcast
+    QString gameId;
+    QString title;
+    QString language;
+    QString thumbnailUrl;
+    QStringList tags;
+    int viewerCount = 0;
+    int refs = 0;
+};
+
+/**
+ * EntityStore - One copy of every stream, user and game on screen
+ *
+ * Purpose: Helix and GraphQL deliver the same channel or game in
+ * different JSON shapes, and every page used to keep its own copy.
+ * The list models now only hold keys and read the entities from here,
+ * so an update from any backend shows up in every list at once.
+ *
+ * Features:
+ * - Upserts report which fields changed (streamsChanged/gamesChanged)
+ * - Repeated strings (game names, languages, tags) are interned
+ * - Reference counted by the models: entities no list shows are dropped,
+ *   so memory follows what's on screen, not how many pages were visited
+ *
+ * Usage: put*() then retain*() the returned keys; release*() when a row
+ * goes away.
+ */
+class EntityStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum StreamChange {
+        StreamIdField    = 0x01,
+        TitleField       = 0x02,
+        ViewerCountField = 0x04,
+        ThumbnailField   = 0x08,
+        TagsField        = 0x10,
+        LanguageField    = 0x20,
+        GameField        = 0x40,    // game id or the game's name
+        UserField        = 0x80
+    };
+
+    enum GameChange {
+        GameNameField     = 0x01,
+        BoxArtField       = 0x02,
+        GameTagsField     = 0x04,
+        ViewersCountField = 0x08
+    };
+
+    explicit EntityStore(QObject *parent = nullptr);
+
+    // Channel key used for streams and users
+    static QString streamKey(const StreamInfo &stream);
+
+    QVector<QString> putStreams(const QVector<StreamInfo> &streams);
+    QVector<QString> putCategories(const QVector<CategoryInfo> &categories);
+
+    // Count-only refreshes (ViewerCountRefresher); unknown keys are ignored
+    void setViewerCounts(const QHash<QString, int> &streams);
+    void setGameViewerCounts(const QHash<QString, int> &games);
+
+    void retainStreams(const QVector<QString> &keys);
+    void releaseStreams(const QVector<QString> &keys);
+    void retainGames(const QVector<QString> &ids);
+    void releaseGames(const QVector<QString> &ids);
+
+    const StreamEntity *stream(const QString &key) const;
+    const UserEntity *user(const QString &key) const;
+    const GameEntity *game(const QString &id) const;
+
+    // Denormalized copy, for callers that want a plain value
+    StreamInfo streamInfo(const QString &key) const;
+
+    int streamCount() const { return m_streams.size(); }
+    int gameCount() const { return m_games.size(); }
+
+signals:
+    // key -> StreamChange mask / game id -> GameChange mask
+    void streamsChanged(const QHash<QString, int> &fields);
+    void gamesChanged(const QHash<QString, int> &fields);
+
+private:
+    QHash<QString, StreamEntity> m_streams;
+    QHash<QString, UserEntity> m_users;
+    QHash<QString, GameEntity> m_games;
+    QSet<QString> m_strings;
+    int m_releasedSincePrune;
+
+    static const int STRING_PRUNE_INTERVAL = 256;
+
+    QString intern(const QString &value);
+    QStringList intern(const QStringList &values);
+
+    void addGameRef(const QString &id);
+    void dropGameRef(const QString &id);
+    void pruneStrings();
+};
+
+#endif // ENTITYSTORE_H
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LISTDIFF_H
+#define LISTDIFF_H
+
+#include <QVector>
+#include <QSet>
+#include <QString>
+#include <functional>
+
+/**
+ * ListDiffOps - Model notifications used by applyKeyedDiff()
+ *
+ * beginInsertRows() & co. are protected in QAbstractItemModel, so the
+ * model hands in lambdas that forward to them.
+ */
+struct ListDiffOps
+{
+    std::function<void(int first, int last)> beginRemove;
+    std::function<void()> endRemove;
+    std::function<void(int first, int last)> beginInsert;
+    std::function<void()> endInsert;
+    std::function<void(int from, int to)> beginMove;   // 'to' as in beginMoveRows
+    std::function<void()> endMove;
+    std::function<void(int row, const QVector<int> &roles)> changed;
+};
+
+inline QVector<QString> toVector(const QSet<QString> &keys)
+{
+    return QVector<QString>(keys.cbegin(), keys.cend());
+}
+
+/**
+ * Drop rows whose key was already seen (pagination can repeat a stream
+ * that moved between pages while we were scrolling)
+ */
+template <typename T, typename KeyFn>
+QVector<T> uniqueByKey(const QVector<T> &items, KeyFn key, QSet<QString> *seen)
+{
+    QVector<T> result;
+    result.reserve(items.size());
+    for (const T &item : items) {
+        QString k = key(item);
+        if (!seen->contains(k)) {
+            seen->insert(k);
+            result.append(item);
+        }
+    }
+    return result;
+}
+
+/**
+ * Turn 'rows' into 'next' with keyed remove/move/insert/dataChanged steps
+ *
+ * Rows that survive a refresh keep their delegate (and thumbnail); only
+ * the roles reported by changedRoles() are refreshed in place. Work is
+ * one pass over both lists plus a short forward scan per moved row.
+ */
+template <typename T, typename KeyFn, typename ChangedFn>
+void applyKeyedDiff(QVector<T> &rows, const QVector<T> &next, KeyFn key,
+                    ChangedFn changedRoles, const ListDiffOps &ops)
+{
+    QSet<QString> nextKeys;
+    QVector<T> target = uniqueByKey(next, key, &nextKeys);
+
+    // 1. Removals, back to front, contiguous runs in one notification
+    int row = rows.size() - 1;
+    while (row >= 0) {
+        if (nextKeys.contains(key(rows[row]))) {
+            --row;
+            continue;
+        }
+        int last = row;
+        while (row > 0 && !nextKeys.contains(key(rows[row - 1]))) {
+            --row;
+        }
+        ops.beginRemove(row, last);
+        rows.remove(row, last - row + 1);
+        ops.endRemove();
+        --row;
+    }
+
+    QSet<QString> currentKeys;
+    currentKeys.reserve(rows.size());
+    for (const T &item : rows) {
+        currentKeys.insert(key(item));
+    }
+
+    // 2. Walk the target order; rows before i already match target[0..i)
+    int i = 0;
+    while (i < target.size()) {
+        QString k = key(target[i]);
+
+        if (!currentKeys.contains(k)) {
+            // New rows, batched while they keep coming
+            int end = i + 1;
+            while (end < target.size() && !currentKeys.contains(key(target[end]))) {
+                ++end;
+            }
+            ops.beginInsert(i, end - 1);
+            for (int j = i; j < end; ++j) {
+                rows.insert(j, target[j]);
+            }
+            ops.endInsert();
+            i = end;
+            continue;
+        }
+
+        if (key(rows[i]) != k) {
+            int from = i + 1;
+            while (key(rows[from]) != k) {
+                ++from;
+            }
+            ops.beginMove(from, i);
+            rows.move(from, i);
+            ops.endMove();
+        }
+
+        QVector<int> roles = changedRoles(rows[i], target[i]);
+        if (!roles.isEmpty()) {
+            rows[i] = target[i];
+            ops.changed(i, roles);
+        }
+        ++i;
+    }
+
+    // Leftover duplicates of already matched keys
+    if (rows.size() > target.size()) {
+        ops.beginRemove(target.size(), rows.size() - 1);
+        rows.resize(target.size());
+        ops.endRemove();
+    }
+}
+
+#endif // LISTDIFF_H
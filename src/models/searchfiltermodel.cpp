@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "searchfiltermodel.h"
+#include "streamlistmodel.h"
+#include "categorylistmodel.h"
+#include <QTimer>
+
+const int SearchFilterModel::MAX_FACETS;
+
+SearchFilterModel::SearchFilterModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_streams(nullptr)
+    , m_categories(nullptr)
+    , m_tagsRole(-1)
+    , m_wasFiltering(false)
+    , m_facetsPending(false)
+{
+    // Shown rows changed - after the proxy has caught up with the source.
+    // One filter change can be several remove/insert steps, so the facets
+    // are counted once afterwards
+    auto rowsChanged = [this]() {
+        emit countChanged();
+        if (!m_facetsPending) {
+            m_facetsPending = true;
+            QTimer::singleShot(0, this, &SearchFilterModel::updateFacets);
+        }
+    };
+    connect(this, &QAbstractItemModel::rowsInserted, this, rowsChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, rowsChanged);
+    connect(this, &QAbstractItemModel::modelReset, this, rowsChanged);
+}
+
+void SearchFilterModel::setSourceModel(QAbstractItemModel *model)
+{
+    if (model == sourceModel()) {
+        return;
+    }
+
+    if (QAbstractItemModel *old = sourceModel()) {
+        disconnect(old, &QAbstractItemModel::modelReset, this, &SearchFilterModel::onSourceReset);
+        disconnect(old, &QAbstractItemModel::rowsInserted, this, &SearchFilterModel::onSourceRowsInserted);
+        disconnect(old, &QAbstractItemModel::dataChanged, this, &SearchFilterModel::onSourceDataChanged);
+    }
+
+    m_streams = qobject_cast<StreamListModel*>(model);
+    m_categories = qobject_cast<CategoryListModel*>(model);
+
+    if (m_streams) {
+        m_textRoles = { StreamListModel::TitleRole, StreamListModel::UserNameRole,
+                        StreamListModel::UserLoginRole };
+        m_tagsRole = StreamListModel::TagsRole;
+    } else if (m_categories) {
+        m_textRoles = { CategoryListModel::NameRole };
+        m_tagsRole = CategoryListModel::TagsRole;
+    } else {
+        m_textRoles.clear();
+        m_tagsRole = -1;
+    }
+
+    // Connected before the proxy's own handlers, so the index is up to
+    // date by the time filterAcceptsRow() sees the new rows
+    if (model) {
+        connect(model, &QAbstractItemModel::modelReset, this, &SearchFilterModel::onSourceReset);
+        connect(model, &QAbstractItemModel::rowsInserted, this, &SearchFilterModel::onSourceRowsInserted);
+        connect(model, &QAbstractItemModel::dataChanged, this, &SearchFilterModel::onSourceDataChanged);
+    }
+
+    rebuildIndex();
+    m_matches = filtering() ? m_index.match(m_query, m_tags) : QBitArray();
+
+    QSortFilterProxyModel::setSourceModel(model);
+}
+
+// ========================================
+// FILTER
+// ========================================
+
+void SearchFilterModel::setQuery(const QString &query)
+{
+    if (query == m_query) {
+        return;
+    }
+    m_query = query;
+    emit queryChanged();
+    applyFilter();
+}
+
+void SearchFilterModel::setTags(const QStringList &tags)
+{
+    if (tags == m_tags) {
+        return;
+    }
+    m_tags = tags;
+    emit tagsChanged();
+    applyFilter();
+}
+
+void SearchFilterModel::toggleTag(const QString &tag)
+{
+    QStringList tags = m_tags;
+    if (!tags.removeOne(tag)) {
+        tags.append(tag);
+    }
+    setTags(tags);
+}
+
+bool SearchFilterModel::filtering() const
+{
+    return !m_query.trimmed().isEmpty() || !m_tags.isEmpty();
+}
+
+bool SearchFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent);
+
+    if (!filtering()) {
+        return true;
+    }
+    int doc = m_index.document(sourceKey(sourceRow));
+    return doc >= 0 && doc < m_matches.size() && m_matches.testBit(doc);
+}
+
+void SearchFilterModel::applyFilter()
+{
+    m_matches = filtering() ? m_index.match(m_query, m_tags) : QBitArray();
+    invalidateFilter();
+
+    if (filtering() != m_wasFiltering) {
+        m_wasFiltering = filtering();
+        emit filteringChanged();
+    }
+    updateFacets();
+}
+
+void SearchFilterModel::updateFacets()
+{
+    m_facetsPending = false;
+
+    // Facets count the rows on screen; retired or removed rows are not
+    // in the source anymore and drop out here
+    QBitArray shown(m_index.size());
+    int rows = rowCount();
+    for (int row = 0; row < rows; ++row) {
+        int doc = m_index.document(sourceKey(mapToSource(index(row, 0)).row()));
+        if (doc >= 0) {
+            shown.setBit(doc);
+        }
+    }
+
+    QStringList available = m_index.topTags(shown, MAX_FACETS);
+
+    // Selected tags stay visible so they can be unselected
+    for (const QString &tag : m_tags) {
+        if (!available.contains(tag)) {
+            available.prepend(tag);
+        }
+    }
+
+    if (available != m_availableTags) {
+        m_availableTags = available;
+        emit availableTagsChanged();
+    }
+}
+
+// ========================================
+// INDEX
+// ========================================
+
+QString SearchFilterModel::sourceKey(int row) const
+{
+    if (m_streams && row >= 0 && row < m_streams->count()) {
+        return m_streams->keyAt(row);
+    }
+    if (m_categories && row >= 0 && row < m_categories->count()) {
+        return m_categories->idAt(row);
+    }
+    return QString();
+}
+
+void SearchFilterModel::indexRows(int first, int last)
+{
+    // Also called from setSourceModel() before the proxy switches over
+    QAbstractItemModel *model = m_streams ? static_cast<QAbstractItemModel*>(m_streams) : m_categories;
+    for (int row = first; row <= last; ++row) {
+        QModelIndex idx = model->index(row, 0);
+        QStringList texts;
+        for (int role : m_textRoles) {
+            texts.append(idx.data(role).toString());
+        }
+        m_index.insert(sourceKey(row), texts, idx.data(m_tagsRole).toStringList());
+    }
+}
+
+void SearchFilterModel::rebuildIndex()
+{
+    m_index.clear();
+    int rows = m_streams ? m_streams->count() : (m_categories ? m_categories->count() : 0);
+    if (rows > 0) {
+        indexRows(0, rows - 1);
+    }
+}
+
+void SearchFilterModel::onSourceReset()
+{
+    rebuildIndex();
+    m_matches = filtering() ? m_index.match(m_query, m_tags) : QBitArray();
+}
+
+void SearchFilterModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(parent);
+
+    // Every refresh retires the numbers of re-inserted rows; start over
+    // once most of the index is dead weight
+    int rows = m_streams ? m_streams->count() : (m_categories ? m_categories->count() : 0);
+    if (m_index.size() > 2 * rows + 64) {
+        rebuildIndex();
+    } else {
+        indexRows(first, last);
+    }
+
+    // Only the new rows are filtered by the proxy, the others keep theirs
+    if (filtering()) {
+        m_matches = m_index.match(m_query, m_tags);
+    }
+}
+
+void SearchFilterModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                            const QVector<int> &roles)
+{
+    bool indexed = roles.isEmpty() || roles.contains(m_tagsRole);
+    for (int role : m_textRoles) {
+        indexed = indexed || roles.contains(role);
+    }
+    if (!indexed) {
+        return;
+    }
+
+    indexRows(topLeft.row(), bottomRight.row());
+    if (filtering()) {
+        m_matches = m_index.match(m_query, m_tags);
+    }
+}
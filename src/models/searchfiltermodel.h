@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEARCHFILTERMODEL_H
+#define SEARCHFILTERMODEL_H
+
+#include <QSortFilterProxyModel>
+#include <QBitArray>
+#include <QStringList>
+#include "searchindex.h"
+
+class StreamListModel;
+class CategoryListModel;
+
+/**
+ * SearchFilterModel - Filter-as-you-type over a browse list model
+ *
+ * Sits between a StreamListModel or CategoryListModel and its grid.
+ * Category names, stream titles and broadcaster names are searched by
+ * substring, tags are facets (see SearchIndex). With no query and no
+ * tags selected every row passes.
+ *
+ * The index follows the source model: new rows are indexed as they
+ * arrive, rows whose text or tags changed are re-indexed, and count-only
+ * updates (ViewerCountRefresher) don't touch it.
+ */
+class SearchFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QString query READ query WRITE setQuery NOTIFY queryChanged)
+    Q_PROPERTY(QStringList tags READ tags WRITE setTags NOTIFY tagsChanged)
+    // Tags of the rows currently shown, for the facet chips
+    Q_PROPERTY(QStringList availableTags READ availableTags NOTIFY availableTagsChanged)
+    Q_PROPERTY(bool filtering READ filtering NOTIFY filteringChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    explicit SearchFilterModel(QObject *parent = nullptr);
+
+    // StreamListModel or CategoryListModel
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    QString query() const { return m_query; }
+    void setQuery(const QString &query);
+
+    QStringList tags() const { return m_tags; }
+    void setTags(const QStringList &tags);
+    Q_INVOKABLE void toggleTag(const QString &tag);
+
+    QStringList availableTags() const { return m_availableTags; }
+    bool filtering() const;
+    int count() const { return rowCount(); }
+
+signals:
+    void queryChanged();
+    void tagsChanged();
+    void availableTagsChanged();
+    void filteringChanged();
+    void countChanged();
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private slots:
+    void onSourceReset();
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                             const QVector<int> &roles);
+
+private:
+    StreamListModel *m_streams;
+    CategoryListModel *m_categories;
+    QVector<int> m_textRoles;
+    int m_tagsRole;
+
+    SearchIndex m_index;
+    QBitArray m_matches;
+    QString m_query;
+    QStringList m_tags;
+    QStringList m_availableTags;
+    bool m_wasFiltering;
+    bool m_facetsPending;
+
+    static const int MAX_FACETS = 12;
+
+    QString sourceKey(int row) const;
+    void indexRows(int first, int last);
+    void rebuildIndex();
+    void applyFilter();
+    void updateFacets();
+};
+
+#endif // SEARCHFILTERMODEL_H
@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "searchindex.h"
+#include <QPair>
+#include <algorithm>
+#include <iterator>
+
+QString SearchIndex::fold(const QString &value)
+{
+    return value.toCaseFolded().simplified();
+}
+
+quint64 SearchIndex::trigram(const QChar *c)
+{
+    return (quint64(c[0].unicode()) << 32) | (quint64(c[1].unicode()) << 16) | c[2].unicode();
+}
+
+void SearchIndex::clear()
+{
+    m_documents.clear();
+    m_texts.clear();
+    m_live.clear();
+    m_trigrams.clear();
+    m_tagDocuments.clear();
+    m_tagNames.clear();
+}
+
+// ========================================
+// INDEXING
+// ========================================
+
+int SearchIndex::insert(const QString &key, const QStringList &texts, const QStringList &tags)
+{
+    int previous = document(key);
+    if (previous >= 0) {
+        m_live.clearBit(previous);
+    }
+
+    // Fields are separated by a newline no query word can contain, so
+    // trigrams spanning two fields never match
+    int doc = m_texts.size();
+    QString text = fold(texts.join(QLatin1Char('\n')));
+    m_texts.append(text);
+    m_live.resize(doc + 1);
+    m_live.setBit(doc);
+    m_documents.insert(key, doc);
+
+    QVector<quint64> grams;
+    grams.reserve(qMax(0, text.size() - 2));
+    for (int i = 0; i + 3 <= text.size(); ++i) {
+        grams.append(trigram(text.constData() + i));
+    }
+    std::sort(grams.begin(), grams.end());
+    grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+
+    // New numbers are always the highest, so the lists stay sorted
+    for (quint64 gram : grams) {
+        m_trigrams[gram].append(doc);
+    }
+
+    for (const QString &tag : tags) {
+        QString folded = fold(tag);
+        if (folded.isEmpty()) {
+            continue;
+        }
+        QBitArray &bits = m_tagDocuments[folded];
+        if (bits.size() <= doc) {
+            bits.resize(qMax(doc + 1, bits.size() * 2));
+        }
+        bits.setBit(doc);
+        if (!m_tagNames.contains(folded)) {
+            m_tagNames.insert(folded, tag);
+        }
+    }
+
+    return doc;
+}
+
+// ========================================
+// QUERIES
+// ========================================
+
+QBitArray SearchIndex::match(const QString &query, const QStringList &tags) const
+{
+    QBitArray result = m_live;
+
+    // Missing bits count as unset, so an unknown tag matches nothing
+    for (const QString &tag : tags) {
+        result &= m_tagDocuments.value(fold(tag));
+    }
+
+    const QStringList words = fold(query).split(QLatin1Char(' '), Qt::SkipEmptyParts);
+    for (const QString &word : words) {
+        if (word.size() < 3) {
+            // Too short for trigrams - check what's left directly
+            for (int doc = 0; doc < m_texts.size(); ++doc) {
+                if (result.testBit(doc) && !m_texts[doc].contains(word)) {
+                    result.clearBit(doc);
+                }
+            }
+            continue;
+        }
+
+        QVector<const QVector<int> *> lists;
+        for (int i = 0; i + 3 <= word.size(); ++i) {
+            auto it = m_trigrams.constFind(trigram(word.constData() + i));
+            if (it == m_trigrams.constEnd()) {
+                return QBitArray(result.size());
+            }
+            lists.append(&it.value());
+        }
+
+        // Rarest trigram first, the candidates shrink fastest
+        std::sort(lists.begin(), lists.end(),
+                  [](const QVector<int> *a, const QVector<int> *b) { return a->size() < b->size(); });
+
+        QVector<int> candidates = *lists.first();
+        for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+            QVector<int> both;
+            std::set_intersection(candidates.constBegin(), candidates.constEnd(),
+                                  lists[i]->constBegin(), lists[i]->constEnd(),
+                                  std::back_inserter(both));
+            candidates.swap(both);
+        }
+
+        // Sharing all trigrams doesn't make it a substring ("abcxbcd"
+        // for "abcd"), so confirm on the text
+        QBitArray narrowed(result.size());
+        for (int doc : candidates) {
+            if (result.testBit(doc) && m_texts[doc].contains(word)) {
+                narrowed.setBit(doc);
+            }
+        }
+        result = narrowed;
+    }
+
+    return result;
+}
+
+QStringList SearchIndex::topTags(const QBitArray &documents, int limit) const
+{
+    QVector<QPair<int, QString>> counts;
+    for (auto it = m_tagDocuments.constBegin(); it != m_tagDocuments.constEnd(); ++it) {
+        int count = (it.value() & documents).count(true);
+        if (count > 0) {
+            counts.append(qMakePair(count, it.key()));
+        }
+    }
+
+    std::sort(counts.begin(), counts.end(),
+              [](const QPair<int, QString> &a, const QPair<int, QString> &b) {
+                  return a.first != b.first ? a.first > b.first : a.second < b.second;
+              });
+
+    QStringList tags;
+    for (int i = 0; i < qMin(limit, counts.size()); ++i) {
+        tags.append(m_tagNames.value(counts[i].second));
+    }
+    return tags;
+}
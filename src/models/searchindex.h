@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include <QBitArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * SearchIndex - Substring search and tag facets over loaded rows
+ *
+ * Purpose: Filter-as-you-type over a few thousand categories or streams
+ * without scanning every title on each keystroke.
+ *
+ * Features:
+ * - Trigram posting lists: a query word of 3+ characters only checks the
+ *   documents that contain all of its trigrams
+ * - One bitset per tag, so facets are ANDed instead of compared per row
+ * - Case-insensitive; every word of a query has to match
+ *
+ * Documents are numbered in insertion order. Re-inserting a key retires
+ * its old number instead of editing the posting lists, so they stay
+ * sorted and appendable; clear() and rebuild when too many are retired.
+ */
+class SearchIndex
+{
+public:
+    // (Re)index one document; returns its number
+    int insert(const QString &key, const QStringList &texts, const QStringList &tags);
+
+    // Current number of 'key', -1 if not indexed
+    int document(const QString &key) const { return m_documents.value(key, -1); }
+
+    // All numbers handed out, retired ones included
+    int size() const { return m_texts.size(); }
+    int liveCount() const { return m_documents.size(); }
+
+    void clear();
+
+    // Live documents containing every word of 'query' and all 'tags'
+    QBitArray match(const QString &query, const QStringList &tags) const;
+
+    // Tags of the documents in 'documents', most common first
+    QStringList topTags(const QBitArray &documents, int limit) const;
+
+private:
+    QHash<QString, int> m_documents;         // key -> live number
+    QVector<QString> m_texts;                // number -> folded text
+    QBitArray m_live;
+    QHash<quint64, QVector<int>> m_trigrams; // trigram -> sorted numbers
+    QHash<QString, QBitArray> m_tagDocuments;
+    QHash<QString, QString> m_tagNames;      // folded -> as received
+
+    static QString fold(const QString &value);
+    static quint64 trigram(const QChar *c);
+};
+
+#endif // SEARCHINDEX_H
@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "streaminfo.h"
+
+// Sizes the list delegates were designed for
+static const char *THUMBNAIL_WIDTH = "440";
+static const char *THUMBNAIL_HEIGHT = "248";
+static const char *BOX_ART_WIDTH = "285";
+static const char *BOX_ART_HEIGHT = "380";
+
+static QString substituteSize(QString url, const char *width, const char *height)
+{
+    url.replace(QLatin1String("{width}"), QLatin1String(width));
+    url.replace(QLatin1String("{height}"), QLatin1String(height));
+    return url;
+}
+
+static QStringList toStringList(const QJsonArray &array)
+{
+    QStringList result;
+    result.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        result.append(value.toString());
+    }
+    return result;
+}
+
+// ========================================
+// STREAMS
+// ========================================
+
+StreamInfo StreamInfo::fromJson(const QJsonObject &stream)
+{
+    StreamInfo info;
+    info.id = stream["id"].toString();
+    info.userId = stream["user_id"].toString();
+    info.userLogin = stream["user_login"].toString();
+    info.userName = stream["user_name"].toString();
+    info.gameId = stream["game_id"].toString();
+    info.gameName = stream["game_name"].toString();
+    info.title = stream["title"].toString();
+    info.language = stream["language"].toString();
+    info.thumbnailUrl = substituteSize(stream["thumbnail_url"].toString(), THUMBNAIL_WIDTH, THUMBNAIL_HEIGHT);
+    info.tags = toStringList(stream["tags"].toArray());
+    info.viewerCount = stream["viewer_count"].toInt();
+    return info;
+}
+
+QVector<StreamInfo> StreamInfo::fromJsonArray(const QJsonArray &streams)
+{
+    QVector<StreamInfo> result;
+    result.reserve(streams.size());
+    for (const QJsonValue &value : streams) {
+        result.append(fromJson(value.toObject()));
+    }
+    return result;
+}
+
+QString StreamInfo::formatViewerCount(int count)
+{
+    if (count >= 1000) {
+        return QString::number(count / 1000.0, 'f', 1) + "K";
+    }
+    return QString::number(count);
+}
+
+// ========================================
+// CATEGORIES
+// ========================================
+
+CategoryInfo CategoryInfo::fromHelix(const QJsonObject &game)
+{
+    CategoryInfo info;
+    info.id = game["id"].toString();
+    info.name = game["name"].toString();
+    info.boxArtUrl = substituteSize(game["box_art_url"].toString(), BOX_ART_WIDTH, BOX_ART_HEIGHT);
+    // Helix doesn't provide viewer counts for games
+    info.viewersCount = 0;
+    return info;
+}
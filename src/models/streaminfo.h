@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STREAMINFO_H
+#define STREAMINFO_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QMetaType>
+
+/**
+ * One live stream as shown in the browse lists
+ *
+ * Built from Helix /streams objects or GraphQL stream nodes (see
+ * ResponseParser).
+ */
+struct StreamInfo
+{
+    QString id;
+    QString userId;
+    QString userLogin;
+    QString userName;
+    QString gameId;
+    QString gameName;
+    QString title;
+    QString language;
+    QString thumbnailUrl;   // {width}x{height} already substituted
+    QStringList tags;
+    int viewerCount = 0;
+
+    static StreamInfo fromJson(const QJsonObject &stream);
+    static QVector<StreamInfo> fromJsonArray(const QJsonArray &streams);
+
+    // "12.3K" style count used by the list delegates
+    static QString formatViewerCount(int count);
+};
+
+/**
+ * One category/game as shown in the categories grid
+ */
+struct CategoryInfo
+{
+    QString id;
+    QString name;
+    QString boxArtUrl;      // {width}x{height} already substituted
+    QStringList tags;
+    int viewersCount = 0;
+
+    // Helix /games/top object (GraphQL nodes: see ResponseParser)
+    static CategoryInfo fromHelix(const QJsonObject &game);
+};
+
+Q_DECLARE_METATYPE(StreamInfo)
+Q_DECLARE_METATYPE(CategoryInfo)
+
+#endif // STREAMINFO_H
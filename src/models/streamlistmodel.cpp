@@ -0,0 +1,308 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "streamlistmodel.h"
+#include "listdiff.h"
+#include "entitystore.h"
+
+StreamListModel::StreamListModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(nullptr)
+    , m_refreshPending(true)
+    , m_requestGeneration(0)
+{
+}
+
+void StreamListModel::setEntityStore(EntityStore *store)
+{
+    m_store = store;
+    connect(m_store, &EntityStore::streamsChanged, this, &StreamListModel::onStreamsChanged);
+    connect(m_store, &EntityStore::gamesChanged, this, &StreamListModel::onGamesChanged);
+}
+
+int StreamListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_keys.size();
+}
+
+QVariant StreamListModel::data(const QModelIndex &index, int role) const
+{
+    if (!m_store || !index.isValid() || index.row() >= m_keys.size()) {
+        return QVariant();
+    }
+
+    const QString &key = m_keys[index.row()];
+    const StreamEntity *stream = m_store->stream(key);
+    if (!stream) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case IdRole:                   return stream->id;
+    case GameIdRole:               return stream->gameId;
+    case TitleRole:                return stream->title;
+    case LanguageRole:             return stream->language;
+    case ThumbnailUrlRole:         return stream->thumbnailUrl;
+    case TagsRole:                 return stream->tags;
+    case ViewerCountRole:          return stream->viewerCount;
+    case ViewerCountFormattedRole: return StreamInfo::formatViewerCount(stream->viewerCount);
+    case GameNameRole: {
+        const GameEntity *game = m_store->game(stream->gameId);
+        return game ? game->name : QString();
+    }
+    case UserIdRole:
+    case UserLoginRole:
+    case UserNameRole: {
+        const UserEntity *user = m_store->user(key);
+        if (!user) {
+            return QString();
+        }
+        if (role == UserIdRole) return user->id;
+        if (role == UserLoginRole) return user->login;
+        return user->displayName;
+    }
+    default:                       return QVariant();
+    }
+}
+
+QHash<int, QByteArray> StreamListModel::roleNames() const
+{
+    static const QHash<int, QByteArray> roles = {
+        { IdRole, "streamId" },
+        { UserIdRole, "userId" },
+        { UserLoginRole, "userLogin" },
+        { UserNameRole, "userName" },
+        { GameIdRole, "gameId" },
+        { GameNameRole, "gameName" },
+        { TitleRole, "title" },
+        { LanguageRole, "language" },
+        { ThumbnailUrlRole, "thumbnailUrl" },
+        { TagsRole, "tags" },
+        { ViewerCountRole, "viewerCount" },
+        { ViewerCountFormattedRole, "viewerCountFormatted" }
+    };
+    return roles;
+}
+
+StreamInfo StreamListModel::at(int row) const
+{
+    return m_store ? m_store->streamInfo(m_keys[row]) : StreamInfo();
+}
+
+void StreamListModel::clear()
+{
+    // Whatever is still in flight was asked for the old content
+    m_requestTag.clear();
+    m_requestGeneration++;
+
+    if (m_keys.isEmpty()) {
+        return;
+    }
+
+    beginResetModel();
+    QVector<QString> released;
+    released.swap(m_keys);
+    endResetModel();
+
+    m_store->releaseStreams(released);
+    emit countChanged();
+}
+
+void StreamListModel::beginRefresh()
+{
+    m_refreshPending = true;
+    m_refreshKeys.clear();
+}
+
+int StreamListModel::beginRequest(const QString &tag)
+{
+    m_requestTag = tag;
+    return ++m_requestGeneration;
+}
+
+bool StreamListModel::isCurrentRequest(const QString &tag, int generation) const
+{
+    return !m_requestTag.isEmpty() && tag == m_requestTag && generation == m_requestGeneration;
+}
+
+void StreamListModel::receive(const QVector<StreamInfo> &streams)
+{
+    receiveBatch(streams, true);
+}
+
+void StreamListModel::receiveBatch(const QVector<StreamInfo> &streams, bool complete)
+{
+    if (!m_refreshPending) {
+        appendStreams(streams);
+        return;
+    }
+    if (!m_store) {
+        return;
+    }
+
+    m_refreshKeys += m_store->putStreams(streams);
+    QVector<QString> target = m_refreshKeys;
+
+    if (complete) {
+        m_refreshPending = false;
+        m_refreshKeys.clear();
+    } else {
+        // Old rows stay below the new ones until the response is complete
+        QSet<QString> received(target.cbegin(), target.cend());
+        for (const QString &key : qAsConst(m_keys)) {
+            if (!received.contains(key)) {
+                target.append(key);
+            }
+        }
+    }
+
+    applyKeys(target);
+}
+
+ListDiffOps StreamListModel::diffOps()
+{
+    ListDiffOps ops;
+    ops.beginRemove = [this](int first, int last) { beginRemoveRows(QModelIndex(), first, last); };
+    ops.endRemove = [this]() { endRemoveRows(); };
+    ops.beginInsert = [this](int first, int last) { beginInsertRows(QModelIndex(), first, last); };
+    ops.endInsert = [this]() { endInsertRows(); };
+    ops.beginMove = [this](int from, int to) { beginMoveRows(QModelIndex(), from, from, QModelIndex(), to); };
+    ops.endMove = [this]() { endMoveRows(); };
+    ops.changed = [this](int row, const QVector<int> &roles) {
+        QModelIndex idx = index(row);
+        emit dataChanged(idx, idx, roles);
+    };
+    return ops;
+}
+
+void StreamListModel::setStreams(const QVector<StreamInfo> &streams)
+{
+    if (!m_store) {
+        return;
+    }
+
+    // Field changes of rows we already show go out via onStreamsChanged
+    applyKeys(m_store->putStreams(streams));
+}
+
+void StreamListModel::applyKeys(const QVector<QString> &keys)
+{
+    QSet<QString> before(m_keys.cbegin(), m_keys.cend());
+    QSet<QString> after(keys.cbegin(), keys.cend());
+
+    // Retain first so rows that stay never drop to zero references
+    m_store->retainStreams(toVector(after - before));
+
+    int oldCount = m_keys.size();
+    auto identity = [](const QString &key) { return key; };
+    auto noRoles = [](const QString &, const QString &) { return QVector<int>(); };
+    applyKeyedDiff(m_keys, keys, identity, noRoles, diffOps());
+
+    m_store->releaseStreams(toVector(before - after));
+
+    if (m_keys.size() != oldCount) {
+        emit countChanged();
+    }
+}
+
+void StreamListModel::appendStreams(const QVector<StreamInfo> &streams)
+{
+    if (!m_store) {
+        return;
+    }
+
+    QVector<QString> keys = m_store->putStreams(streams);
+
+    QSet<QString> seen(m_keys.cbegin(), m_keys.cend());
+    QVector<QString> fresh = uniqueByKey(keys, [](const QString &key) { return key; }, &seen);
+
+    if (fresh.isEmpty()) {
+        return;
+    }
+
+    m_store->retainStreams(fresh);
+
+    // One insert notification for the whole page
+    int first = m_keys.size();
+    beginInsertRows(QModelIndex(), first, first + fresh.size() - 1);
+    m_keys.append(fresh);
+    endInsertRows();
+    emit countChanged();
+}
+
+void StreamListModel::removeStreams(const QVector<QString> &keys)
+{
+    if (!m_store) {
+        return;
+    }
+
+    QSet<QString> gone(keys.cbegin(), keys.cend());
+    QVector<QString> remaining;
+    remaining.reserve(m_keys.size());
+    for (const QString &key : qAsConst(m_keys)) {
+        if (!gone.contains(key)) {
+            remaining.append(key);
+        }
+    }
+
+    if (remaining.size() != m_keys.size()) {
+        applyKeys(remaining);
+    }
+}
+
+// ========================================
+// STORE UPDATES
+// ========================================
+
+void StreamListModel::onStreamsChanged(const QHash<QString, int> &fields)
+{
+    for (int row = 0; row < m_keys.size(); ++row) {
+        auto it = fields.constFind(m_keys[row]);
+        if (it == fields.constEnd()) {
+            continue;
+        }
+
+        int mask = it.value();
+        QVector<int> roles;
+        if (mask & EntityStore::StreamIdField)    roles << IdRole;
+        if (mask & EntityStore::TitleField)       roles << TitleRole;
+        if (mask & EntityStore::ViewerCountField) roles << ViewerCountRole << ViewerCountFormattedRole;
+        if (mask & EntityStore::ThumbnailField)   roles << ThumbnailUrlRole;
+        if (mask & EntityStore::TagsField)        roles << TagsRole;
+        if (mask & EntityStore::LanguageField)    roles << LanguageRole;
+        if (mask & EntityStore::GameField)        roles << GameIdRole << GameNameRole;
+        if (mask & EntityStore::UserField)        roles << UserIdRole << UserLoginRole << UserNameRole;
+
+        QModelIndex idx = index(row);
+        emit dataChanged(idx, idx, roles);
+    }
+}
+
+void StreamListModel::onGamesChanged(const QHash<QString, int> &fields)
+{
+    for (int row = 0; row < m_keys.size(); ++row) {
+        const StreamEntity *stream = m_store->stream(m_keys[row]);
+        if (!stream || stream->gameId.isEmpty()) {
+            continue;
+        }
+
+        auto it = fields.constFind(stream->gameId);
+        if (it != fields.constEnd() && (it.value() & EntityStore::GameNameField)) {
+            QModelIndex idx = index(row);
+            emit dataChanged(idx, idx, { GameNameRole });
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STREAMLISTMODEL_H
+#define STREAMLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QVector>
+#include "streaminfo.h"
+
+class EntityStore;
+struct ListDiffOps;
+
+/**
+ * StreamListModel - Live streams for the browse/followed grids
+ *
+ * Purpose: Replace QML ListModels that were filled row by row from
+ * JavaScript. Rows arrive as StreamInfo batches straight from the API
+ * signals (wired up in main.cpp) and are inserted with one
+ * beginInsertRows per batch.
+ *
+ * Rows are channel keys into the shared EntityStore; field updates from
+ * any backend arrive through the store and only re-emit the affected
+ * roles. A refresh is diffed against the current rows by key (see
+ * listdiff.h), so surviving rows keep their delegate and scroll position.
+ *
+ * Role names match the old ListModel fields, so delegates keep using
+ * model.userLogin, model.viewerCountFormatted, ...
+ */
+class StreamListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        IdRole = Qt::UserRole + 1,
+        UserIdRole,
+        UserLoginRole,
+        UserNameRole,
+        GameIdRole,
+        GameNameRole,
+        TitleRole,
+        LanguageRole,
+        ThumbnailUrlRole,
+        TagsRole,
+        ViewerCountRole,
+        ViewerCountFormattedRole
+    };
+
+    explicit StreamListModel(QObject *parent = nullptr);
+
+    // Shared entity store (called from main.cpp)
+    void setEntityStore(EntityStore *store);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return m_keys.size(); }
+    QString keyAt(int row) const { return m_keys[row]; }
+    StreamInfo at(int row) const;
+
+    /**
+     * Mark the next received response as a refresh
+     *
+     * Pages call this before a (re)load; the next response then replaces
+     * the content instead of being appended as another page.
+     */
+    Q_INVOKABLE void beginRefresh();
+
+    /**
+     * Start a new generation of requests for 'tag' (e.g. a game id)
+     *
+     * The model is shared between page instances, so a late batch or
+     * next page requested for one category could land in another.
+     * Requests carry the tag and the returned generation; responses are
+     * only let in while both are still current (isCurrentRequest()).
+     * clear() drops everything in flight.
+     */
+    Q_INVOKABLE int beginRequest(const QString &tag);
+    Q_INVOKABLE int requestGeneration() const { return m_requestGeneration; }
+    bool isCurrentRequest(const QString &tag, int generation) const;
+
+    Q_INVOKABLE void clear();
+
+    // Entry point for API results - replaces or appends (see beginRefresh)
+    void receive(const QVector<StreamInfo> &streams);
+
+    /**
+     * One batch of a response that is still downloading
+     *
+     * During a refresh the rows received so far move to the top while
+     * the old rows stay below them until the 'complete' batch, so rows
+     * that survive the refresh keep their delegates.
+     */
+    void receiveBatch(const QVector<StreamInfo> &streams, bool complete);
+
+    // Keyed diff against the current rows
+    void setStreams(const QVector<StreamInfo> &streams);
+    // Next page; channels already listed are skipped
+    void appendStreams(const QVector<StreamInfo> &streams);
+    // Drop the rows of these channel keys (e.g. they went offline)
+    void removeStreams(const QVector<QString> &keys);
+
+signals:
+    void countChanged();
+
+private slots:
+    void onStreamsChanged(const QHash<QString, int> &fields);
+    void onGamesChanged(const QHash<QString, int> &fields);
+
+private:
+    EntityStore *m_store;
+    QVector<QString> m_keys;
+    bool m_refreshPending;
+    QString m_requestTag;
+    int m_requestGeneration;
+    QVector<QString> m_refreshKeys;     // received so far in a batched refresh
+
+    ListDiffOps diffOps();
+    void applyKeys(const QVector<QString> &keys);
+};
+
+#endif // STREAMLISTMODEL_H
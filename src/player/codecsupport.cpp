@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "codecsupport.h"
+#include "../core/logging.h"
+#include <QMediaPlayer>
+#include <QThread>
+
+CodecSupport CodecSupport::detect()
+{
+    CodecSupport support;
+
+    QString forced = qEnvironmentVariable("TWITCHVIEWER_CODECS");
+    if (!forced.isEmpty()) {
+        QStringList codecs = forced.toLower().split(',', Qt::SkipEmptyParts);
+        support.m_h264 = codecs.contains("h264");
+        support.m_hevc = codecs.contains("h265") || codecs.contains("hevc");
+        support.m_av1 = codecs.contains("av1");
+        LOG_STREAM("Codecs forced by environment:" << support.usherCodecList());
+        return support;
+    }
+
+    // GStreamer answers ProbablySupported only when a registered element
+    // takes the format as sink caps. MaybeSupported is its guess for any
+    // video/* type and says nothing about a decoder being installed
+    support.m_h264 = QMediaPlayer::hasSupport("video/x-h264") == QMultimedia::ProbablySupported;
+    support.m_hevc = QMediaPlayer::hasSupport("video/x-h265") == QMultimedia::ProbablySupported;
+    support.m_av1 = QMediaPlayer::hasSupport("video/x-av1") == QMultimedia::ProbablySupported;
+
+    // Twitch always offers H.264 - never advertise an empty list
+    if (!support.m_h264 && !support.m_hevc && !support.m_av1) {
+        support.m_h264 = true;
+    }
+
+    LOG_STREAM("Detected decoders:" << support.usherCodecList());
+    return support;
+}
+
+bool CodecSupport::canDecode(Codec codec) const
+{
+    switch (codec) {
+        case H264:
+            return m_h264;
+        case HEVC:
+            return m_hevc;
+        case AV1:
+            return m_av1;
+        case UnknownCodec:
+            return false;
+    }
+
+    return false;
+}
+
+QString CodecSupport::usherCodecList() const
+{
+    QStringList codecs;
+    if (m_av1) codecs.append("av1");
+    if (m_hevc) codecs.append("h265");
+    if (m_h264) codecs.append("h264");
+    return codecs.join(',');
+}
+
+CodecSupport::Codec CodecSupport::videoCodec(const HlsVariant &variant)
+{
+    if (variant.codecs.isEmpty()) {
+        return H264;
+    }
+
+    const QStringList codecs = variant.codecs.split(',');
+    for (QString codec : codecs) {
+        codec = codec.trimmed().toLower();
+        if (codec.startsWith("avc1") || codec.startsWith("avc3")) {
+            return H264;
+        }
+        if (codec.startsWith("hev1") || codec.startsWith("hvc1")) {
+            return HEVC;
+        }
+        if (codec.startsWith("av01")) {
+            return AV1;
+        }
+    }
+
+    return UnknownCodec;
+}
+
+bool CodecSupport::isPlayable(const HlsVariant &variant) const
+{
+    // Audio-only variants don't need a video decoder
+    if (variant.isAudioOnly()) {
+        return true;
+    }
+
+    Codec codec = videoCodec(variant);
+    if (!canDecode(codec)) {
+        return false;
+    }
+
+    qint64 budget = softwarePixelRateBudget(codec);
+    if (budget <= 0) {
+        return true;
+    }
+
+    double frameRate = variant.frameRate > 0 ? variant.frameRate : 30.0;
+    return variant.pixelCount() * frameRate <= budget;
+}
+
+bool CodecSupport::isBetter(const HlsVariant &candidate, const HlsVariant &current) const
+{
+    bool candidatePlayable = isPlayable(candidate);
+    bool currentPlayable = isPlayable(current);
+
+    if (candidatePlayable != currentPlayable) {
+        return candidatePlayable;
+    }
+
+    return efficiencyRank(videoCodec(candidate)) > efficiencyRank(videoCodec(current));
+}
+
+const HlsVariant *CodecSupport::choose(const QVector<HlsVariant> &variants, const QString &groupId) const
+{
+    const HlsVariant *chosen = nullptr;
+    for (const HlsVariant &variant : variants) {
+        if (variant.groupId != groupId) {
+            continue;
+        }
+        if (chosen ? isBetter(variant, *chosen) : isPlayable(variant)) {
+            chosen = &variant;
+        }
+    }
+    return chosen;
+}
+
+int CodecSupport::efficiencyRank(Codec codec)
+{
+    switch (codec) {
+        case AV1:
+            return 3;
+        case HEVC:
+            return 2;
+        case H264:
+            return 1;
+        case UnknownCodec:
+            return 0;
+    }
+
+    return 0;
+}
+
+qint64 CodecSupport::softwarePixelRateBudget(Codec codec)
+{
+    // Pixels per second a quad-core phone decodes in software without
+    // dropping frames; scaled with the number of cores we actually have
+    qint64 base = 0;
+    switch (codec) {
+        case HEVC:
+            base = qint64(1280) * 720 * 30;
+            break;
+        case AV1:
+            base = qint64(852) * 480 * 30;
+            break;
+        case H264:
+        case UnknownCodec:
+            // H.264 is what every device plays - no limit
+            return 0;
+    }
+
+    int cores = qMax(1, QThread::idealThreadCount());
+    return base * cores / 4;
+}
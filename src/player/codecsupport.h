@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CODECSUPPORT_H
+#define CODECSUPPORT_H
+
+#include <QString>
+#include <QStringList>
+#include "hlsplaylist.h"
+
+/**
+ * Video decoder capabilities of this device
+ *
+ * Probes the QtMultimedia backend (GStreamer on Ubuntu Touch) for
+ * H.264, HEVC and AV1 decoders. We can't tell hardware from software
+ * decoders through QtMultimedia, so the more efficient codecs are only
+ * chosen up to a pixel rate a software decoder can sustain.
+ *
+ * Set TWITCHVIEWER_CODECS (e.g. "h264" or "av1,h264") to override the
+ * probe, which makes every path testable on software decoders only.
+ */
+class CodecSupport
+{
+public:
+    enum Codec {
+        UnknownCodec,
+        H264,
+        HEVC,
+        AV1
+    };
+
+    /**
+     * Probe the multimedia backend
+     * Does a plugin registry scan - call once and keep the result.
+     */
+    static CodecSupport detect();
+
+    bool canDecode(Codec codec) const;
+
+    /**
+     * Comma-separated codec list for usher's supported_codecs parameter
+     * Most efficient first, e.g. "av1,h265,h264"
+     */
+    QString usherCodecList() const;
+
+    /**
+     * Video codec of a variant from its CODECS attribute
+     * Variants without a CODECS attribute are assumed to be H.264.
+     */
+    static Codec videoCodec(const HlsVariant &variant);
+
+    /**
+     * Whether a variant can be decoded within the CPU budget
+     */
+    bool isPlayable(const HlsVariant &variant) const;
+
+    /**
+     * Whether candidate should replace current for the same quality slot
+     * Prefers playable variants, then the more efficient codec.
+     */
+    bool isBetter(const HlsVariant &candidate, const HlsVariant &current) const;
+
+    /**
+     * The variant to play for one quality slot (VIDEO group, e.g. "720p60")
+     * out of the renditions a master playlist offers in several codecs
+     * Returns nullptr if none of them is playable.
+     */
+    const HlsVariant *choose(const QVector<HlsVariant> &variants, const QString &groupId) const;
+
+private:
+    bool m_h264 = true;
+    bool m_hevc = false;
+    bool m_av1 = false;
+
+    static int efficiencyRank(Codec codec);
+    static qint64 softwarePixelRateBudget(Codec codec);
+};
+
+#endif // CODECSUPPORT_H
@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hlsplaylist.h"
+
+QMap<QString, QString> HlsPlaylist::parseAttributes(const QString &attributes)
+{
+    QMap<QString, QString> result;
+
+    int pos = 0;
+    const int length = attributes.length();
+
+    while (pos < length) {
+        int eq = attributes.indexOf('=', pos);
+        if (eq < 0) {
+            break;
+        }
+
+        QString key = attributes.mid(pos, eq - pos).trimmed();
+        QString value;
+        pos = eq + 1;
+
+        if (pos < length && attributes[pos] == '"') {
+            // Quoted value - may contain commas (CODECS="avc1,mp4a")
+            int endQuote = attributes.indexOf('"', pos + 1);
+            if (endQuote < 0) {
+                endQuote = length;
+            }
+            value = attributes.mid(pos + 1, endQuote - pos - 1);
+            pos = endQuote + 1;
+        } else {
+            int comma = attributes.indexOf(',', pos);
+            if (comma < 0) {
+                comma = length;
+            }
+            value = attributes.mid(pos, comma - pos).trimmed();
+            pos = comma;
+        }
+
+        // Skip separator
+        if (pos < length && attributes[pos] == ',') {
+            pos++;
+        }
+
+        if (!key.isEmpty()) {
+            result.insert(key, value);
+        }
+    }
+
+    return result;
+}
+
+QVector<HlsVariant> HlsPlaylist::parseMaster(const QString &content)
+{
+    QVector<HlsVariant> variants;
+    QStringList lines = content.split('\n');
+
+    for (int i = 0; i < lines.size(); i++) {
+        QString line = lines[i].trimmed();
+
+        if (!line.startsWith("#EXT-X-STREAM-INF:")) {
+            continue;
+        }
+
+        QMap<QString, QString> attrs = parseAttributes(line.mid(line.indexOf(':') + 1));
+
+        HlsVariant variant;
+        variant.groupId = attrs.value("VIDEO");
+        variant.bandwidth = attrs.value("BANDWIDTH").toLongLong();
+        variant.frameRate = attrs.value("FRAME-RATE").toDouble();
+        variant.codecs = attrs.value("CODECS");
+
+        QString resolution = attrs.value("RESOLUTION");
+        int x = resolution.indexOf('x');
+        if (x > 0) {
+            variant.width = resolution.left(x).toInt();
+            variant.height = resolution.mid(x + 1).toInt();
+        }
+
+        // Next non-tag line is the URL
+        for (int j = i + 1; j < lines.size(); j++) {
+            QString next = lines[j].trimmed();
+            if (next.isEmpty() || next.startsWith('#')) {
+                continue;
+            }
+            variant.url = next;
+            i = j;
+            break;
+        }
+
+        if (!variant.url.isEmpty()) {
+            variants.append(variant);
+        }
+    }
+
+    return variants;
+}
+
+HlsMediaPlaylist HlsPlaylist::parseMedia(const QString &content, const QUrl &baseUrl)
+{
+    HlsMediaPlaylist playlist;
+    QStringList lines = content.split('\n');
+
+    qint64 pendingDurationMs = -1;
+    qint64 sequence = 0;
+
+    for (const QString &rawLine : lines) {
+        QString line = rawLine.trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        if (line.startsWith("#EXT-X-MEDIA-SEQUENCE:")) {
+            playlist.mediaSequence = line.mid(22).toLongLong();
+            sequence = playlist.mediaSequence;
+        } else if (line.startsWith("#EXT-X-TARGETDURATION:")) {
+            playlist.targetDurationMs = qint64(line.mid(22).toDouble() * 1000.0);
+        } else if (line.startsWith("#EXT-X-ENDLIST")) {
+            playlist.endList = true;
+        } else if (line.startsWith("#EXTINF:")) {
+            // #EXTINF:<duration>,[<title>]
+            QString value = line.mid(8);
+            int comma = value.indexOf(',');
+            if (comma >= 0) {
+                value = value.left(comma);
+            }
+            pendingDurationMs = qint64(value.toDouble() * 1000.0);
+        } else if (!line.startsWith('#')) {
+            if (pendingDurationMs < 0) {
+                continue;
+            }
+
+            HlsSegment segment;
+            segment.url = baseUrl.resolved(QUrl(line)).toString();
+            segment.sequence = sequence++;
+            segment.durationMs = pendingDurationMs;
+            playlist.segments.append(segment);
+
+            pendingDurationMs = -1;
+        }
+    }
+
+    return playlist;
+}
+
+int HlsPlaylist::smallestCovering(const QVector<HlsVariant> &variants, int width, int height)
+{
+    int bestCovering = -1;
+    int largestBelow = -1;
+
+    for (int i = 0; i < variants.size(); i++) {
+        const HlsVariant &v = variants[i];
+        if (v.isAudioOnly()) {
+            continue;
+        }
+
+        if (v.width >= width && v.height >= height) {
+            if (bestCovering < 0) {
+                bestCovering = i;
+                continue;
+            }
+            const HlsVariant &best = variants[bestCovering];
+            // Smaller picture wins, then lower frame rate (less decode work)
+            if (v.pixelCount() < best.pixelCount() ||
+                (v.pixelCount() == best.pixelCount() && v.frameRate < best.frameRate)) {
+                bestCovering = i;
+            }
+        } else {
+            if (largestBelow < 0) {
+                largestBelow = i;
+                continue;
+            }
+            const HlsVariant &best = variants[largestBelow];
+            if (v.pixelCount() > best.pixelCount() ||
+                (v.pixelCount() == best.pixelCount() && v.frameRate < best.frameRate)) {
+                largestBelow = i;
+            }
+        }
+    }
+
+    return bestCovering >= 0 ? bestCovering : largestBelow;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HLSPLAYLIST_H
+#define HLSPLAYLIST_H
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QVector>
+#include <QUrl>
+
+/**
+ * One #EXT-X-STREAM-INF entry of an HLS master playlist
+ *
+ * Twitch's usher returns one variant per transcode ("chunked" is the
+ * source rendition, "audio_only" has no video at all).
+ */
+struct HlsVariant
+{
+    QString groupId;     // VIDEO attribute, e.g. "720p60", "chunked", "audio_only"
+    QString url;         // Media playlist URL
+    QString codecs;      // CODECS attribute, e.g. "avc1.64002A,mp4a.40.2"
+    int width = 0;
+    int height = 0;
+    qint64 bandwidth = 0;
+    double frameRate = 0.0;
+
+    bool isAudioOnly() const { return groupId == "audio_only" || (width == 0 && height == 0); }
+    qint64 pixelCount() const { return qint64(width) * height; }
+};
+
+/**
+ * One media segment of an HLS media playlist
+ */
+struct HlsSegment
+{
+    QString url;            // Absolute segment URL
+    qint64 sequence = 0;    // Media sequence number
+    qint64 durationMs = 0;  // From #EXTINF
+};
+
+/**
+ * Parsed HLS media playlist (the per-variant segment list)
+ */
+struct HlsMediaPlaylist
+{
+    qint64 mediaSequence = 0;     // #EXT-X-MEDIA-SEQUENCE
+    qint64 targetDurationMs = 0;  // #EXT-X-TARGETDURATION
+    bool endList = false;         // #EXT-X-ENDLIST present (VOD / finished)
+    QVector<HlsSegment> segments;
+};
+
+/**
+ * Minimal HLS master/media playlist parser
+ *
+ * Only understands what usher sends us - no byte ranges, no alternate
+ * renditions. Kept free of network code so it can be reused by anything
+ * that already has the playlist text.
+ */
+class HlsPlaylist
+{
+public:
+    /**
+     * Parse a master playlist
+     *
+     * @param content Raw M3U8 text
+     * @return Variants in playlist order (usher lists best first)
+     */
+    static QVector<HlsVariant> parseMaster(const QString &content);
+
+    /**
+     * Parse a media playlist
+     *
+     * @param content Raw M3U8 text
+     * @param baseUrl Playlist URL, used to resolve relative segment URIs
+     * @return Segments in playback order
+     */
+    static HlsMediaPlaylist parseMedia(const QString &content, const QUrl &baseUrl);
+
+    /**
+     * Split an HLS attribute list (KEY=VALUE,KEY="quoted,value")
+     *
+     * @param attributes Everything after the tag's colon
+     * @return Attribute map with quotes stripped
+     */
+    static QMap<QString, QString> parseAttributes(const QString &attributes);
+
+    /**
+     * Pick the smallest video variant that still covers a surface
+     *
+     * Falls back to the largest variant below the surface size when
+     * nothing covers it. Audio-only variants are never returned.
+     *
+     * @param variants Parsed variants
+     * @param width Surface width in device pixels
+     * @param height Surface height in device pixels
+     * @return Index into variants, or -1 if there is no video variant
+     */
+    static int smallestCovering(const QVector<HlsVariant> &variants, int width, int height);
+};
+
+#endif // HLSPLAYLIST_H
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "segmentplaybackdevice.h"
+#include <cstring>
+
+SegmentPlaybackDevice::SegmentPlaybackDevice(QObject *parent)
+    : QIODevice(parent)
+    , m_headOffset(0)
+    , m_buffered(0)
+    , m_finished(false)
+{
+    open(QIODevice::ReadOnly);
+}
+
+SegmentPlaybackDevice::~SegmentPlaybackDevice()
+{
+}
+
+void SegmentPlaybackDevice::appendSegment(const QByteArray &data)
+{
+    if (data.isEmpty() || m_finished) {
+        return;
+    }
+
+    m_segments.enqueue(data);
+    m_buffered += data.size();
+    emit readyRead();
+}
+
+void SegmentPlaybackDevice::finish()
+{
+    if (m_finished) {
+        return;
+    }
+
+    m_finished = true;
+    emit readyRead();
+    if (m_buffered == 0) {
+        emit readChannelFinished();
+    }
+}
+
+qint64 SegmentPlaybackDevice::bytesAvailable() const
+{
+    return m_buffered + QIODevice::bytesAvailable();
+}
+
+bool SegmentPlaybackDevice::atEnd() const
+{
+    return m_finished && bytesAvailable() == 0;
+}
+
+qint64 SegmentPlaybackDevice::readData(char *data, qint64 maxSize)
+{
+    if (m_buffered == 0) {
+        // Nothing queued yet: 0 means "try again on readyRead", -1 is EOF
+        return m_finished ? -1 : 0;
+    }
+
+    qint64 copied = 0;
+    while (copied < maxSize && !m_segments.isEmpty()) {
+        const QByteArray &head = m_segments.head();
+        qint64 chunk = qMin<qint64>(maxSize - copied, head.size() - m_headOffset);
+
+        memcpy(data + copied, head.constData() + m_headOffset, size_t(chunk));
+        copied += chunk;
+        m_headOffset += int(chunk);
+
+        if (m_headOffset >= head.size()) {
+            m_segments.dequeue();
+            m_headOffset = 0;
+            emit segmentConsumed();
+        }
+    }
+
+    m_buffered -= copied;
+
+    if (m_finished && m_buffered == 0) {
+        emit readChannelFinished();
+    }
+
+    return copied;
+}
+
+qint64 SegmentPlaybackDevice::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data)
+    Q_UNUSED(maxSize)
+    return -1;
+}
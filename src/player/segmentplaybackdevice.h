@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEGMENTPLAYBACKDEVICE_H
+#define SEGMENTPLAYBACKDEVICE_H
+
+#include <QIODevice>
+#include <QQueue>
+#include <QByteArray>
+
+/**
+ * Sequential read-only device that plays MPEG-TS segments back to back
+ *
+ * TS segments can simply be concatenated, so whoever owns the segments
+ * (VOD seek window, timeshift buffer) appends them in order and hands
+ * this device to QMediaPlayer::setMedia(). Appending never copies the
+ * segment bytes - QByteArray is implicitly shared.
+ */
+class SegmentPlaybackDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    explicit SegmentPlaybackDevice(QObject *parent = nullptr);
+    ~SegmentPlaybackDevice();
+
+    // Queue the next segment for playback
+    void appendSegment(const QByteArray &data);
+
+    // No more segments will follow - reads hit EOF once drained
+    void finish();
+
+    // Bytes queued but not yet read by the player
+    qint64 bufferedBytes() const { return m_buffered; }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override;
+    bool atEnd() const override;
+
+signals:
+    // Emitted when the player has consumed a whole segment
+    void segmentConsumed();
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    QQueue<QByteArray> m_segments;
+    int m_headOffset;     // Read position inside m_segments.head()
+    qint64 m_buffered;
+    bool m_finished;
+};
+
+#endif // SEGMENTPLAYBACKDEVICE_H
@@ -0,0 +1,274 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timeshiftbuffer.h"
+#include "../core/logging.h"
+#include <algorithm>
+
+TimeshiftBuffer::TimeshiftBuffer()
+    : m_spilledCount(0)
+    , m_map(nullptr)
+    , m_ringSize(0)
+    , m_writeOffset(0)
+    , m_durationMs(0)
+    , m_memoryBytes(0)
+    , m_maxDurationMs(5 * 60 * 1000)
+    , m_memoryThreshold(24 * 1024 * 1024)
+    , m_protectedSequence(-1)
+{
+}
+
+TimeshiftBuffer::~TimeshiftBuffer()
+{
+    close();
+}
+
+bool TimeshiftBuffer::open(const QString &path, qint64 ringBytes)
+{
+    close();
+
+    m_ringFile.setFileName(path);
+
+    // Unbuffered so every write is in the page cache before it's mapped back
+    if (!m_ringFile.open(QIODevice::ReadWrite | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        WARN_STREAM("Timeshift: cannot open ring file" << path << "-" << m_ringFile.errorString());
+        return false;
+    }
+
+    if (!m_ringFile.resize(ringBytes)) {
+        WARN_STREAM("Timeshift: cannot size ring file -" << m_ringFile.errorString());
+        m_ringFile.remove();
+        return false;
+    }
+
+    m_map = m_ringFile.map(0, ringBytes);
+    if (!m_map) {
+        WARN_STREAM("Timeshift: cannot map ring file -" << m_ringFile.errorString());
+        m_ringFile.remove();
+        return false;
+    }
+
+    m_ringSize = ringBytes;
+    m_writeOffset = 0;
+
+    LOG_STREAM("Timeshift ring file ready:" << ringBytes / (1024 * 1024) << "MB");
+    return true;
+}
+
+void TimeshiftBuffer::close()
+{
+    clear();
+
+    if (m_map) {
+        m_ringFile.unmap(m_map);
+        m_map = nullptr;
+    }
+
+    if (m_ringFile.isOpen()) {
+        // Don't leave hundreds of MB behind in the cache directory
+        m_ringFile.remove();
+    }
+
+    m_ringSize = 0;
+}
+
+void TimeshiftBuffer::clear()
+{
+    m_entries.clear();
+    m_spilledCount = 0;
+    m_writeOffset = 0;
+    m_durationMs = 0;
+    m_memoryBytes = 0;
+    m_protectedSequence = -1;
+}
+
+// ========================================
+// APPEND / EVICT
+// ========================================
+
+void TimeshiftBuffer::append(qint64 sequence, qint64 durationMs, const QByteArray &data)
+{
+    if (data.isEmpty() || (!m_entries.isEmpty() && sequence <= m_entries.last().sequence)) {
+        return;
+    }
+
+    Entry entry;
+    entry.sequence = sequence;
+    entry.durationMs = durationMs;
+    entry.diskOffset = -1;
+    entry.size = data.size();
+    entry.memory = data;
+    m_entries.append(entry);
+
+    m_durationMs += durationMs;
+    m_memoryBytes += data.size();
+
+    // Rewind window limit - always keep the live edge segment
+    while (m_durationMs > m_maxDurationMs && m_entries.size() > 1) {
+        evictFront();
+    }
+
+    spillToRing();
+}
+
+void TimeshiftBuffer::evictFront()
+{
+    Entry entry = m_entries.takeFirst();
+    m_durationMs -= entry.durationMs;
+
+    if (entry.diskOffset < 0) {
+        m_memoryBytes -= entry.size;
+    } else {
+        m_spilledCount--;
+    }
+}
+
+void TimeshiftBuffer::spillToRing()
+{
+    while (m_memoryBytes > m_memoryThreshold) {
+        if (!spillOne()) {
+            break;
+        }
+    }
+}
+
+bool TimeshiftBuffer::spillOne()
+{
+    if (!m_map || m_spilledCount >= m_entries.size()) {
+        return false;
+    }
+
+    const int size = m_entries[m_spilledCount].size;
+    if (size > m_ringSize) {
+        return false;
+    }
+
+    // Wrap instead of splitting a segment across the end of the file
+    qint64 offset = m_writeOffset;
+    bool wrap = offset + size > m_ringSize;
+    if (wrap) {
+        offset = 0;
+    }
+
+    // Spilled segments sit in the ring in write order, so the oldest one is
+    // always the next region to be overwritten and overlaps can only happen
+    // at the front. Wrapping skips the tail [m_writeOffset, m_ringSize):
+    // whatever is left there from the previous lap is older than anything
+    // at the start of the file and goes first.
+    while (m_spilledCount > 0) {
+        const Entry &front = m_entries.first();
+        bool inSkippedTail = wrap && front.diskOffset >= m_writeOffset;
+        bool overlaps = front.diskOffset < offset + size &&
+                        front.diskOffset + front.size > offset;
+        if (!inSkippedTail && !overlaps) {
+            break;
+        }
+        if (m_protectedSequence >= 0 && front.sequence >= m_protectedSequence) {
+            // Player still holds a view of it - stay in memory for now
+            return false;
+        }
+        evictFront();
+    }
+
+    Entry &entry = m_entries[m_spilledCount];
+
+    if (!m_ringFile.seek(offset) || m_ringFile.write(entry.memory) != size) {
+        WARN_STREAM("Timeshift: ring write failed -" << m_ringFile.errorString());
+        return false;
+    }
+
+    entry.diskOffset = offset;
+    entry.memory = QByteArray();
+    m_memoryBytes -= size;
+    m_spilledCount++;
+    m_writeOffset = offset + size;
+
+    return true;
+}
+
+// ========================================
+// LOOKUP
+// ========================================
+
+int TimeshiftBuffer::indexOf(qint64 sequence) const
+{
+    auto it = std::lower_bound(m_entries.constBegin(), m_entries.constEnd(), sequence,
+        [](const Entry &entry, qint64 seq) { return entry.sequence < seq; });
+
+    if (it == m_entries.constEnd() || it->sequence != sequence) {
+        return -1;
+    }
+    return int(it - m_entries.constBegin());
+}
+
+QByteArray TimeshiftBuffer::data(qint64 sequence) const
+{
+    int index = indexOf(sequence);
+    if (index < 0) {
+        return QByteArray();
+    }
+
+    const Entry &entry = m_entries[index];
+    if (entry.diskOffset < 0) {
+        return entry.memory;
+    }
+
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(m_map + entry.diskOffset), entry.size);
+}
+
+qint64 TimeshiftBuffer::firstSequence() const
+{
+    return m_entries.isEmpty() ? -1 : m_entries.first().sequence;
+}
+
+qint64 TimeshiftBuffer::lastSequence() const
+{
+    return m_entries.isEmpty() ? -1 : m_entries.last().sequence;
+}
+
+qint64 TimeshiftBuffer::nextAvailable(qint64 sequence) const
+{
+    auto it = std::lower_bound(m_entries.constBegin(), m_entries.constEnd(), sequence,
+        [](const Entry &entry, qint64 seq) { return entry.sequence < seq; });
+
+    return it == m_entries.constEnd() ? -1 : it->sequence;
+}
+
+qint64 TimeshiftBuffer::durationFrom(qint64 sequence) const
+{
+    qint64 total = 0;
+    for (int i = m_entries.size() - 1; i >= 0 && m_entries[i].sequence >= sequence; i--) {
+        total += m_entries[i].durationMs;
+    }
+    return total;
+}
+
+qint64 TimeshiftBuffer::sequenceBehindLive(qint64 behindMs) const
+{
+    if (m_entries.isEmpty()) {
+        return -1;
+    }
+
+    qint64 total = 0;
+    for (int i = m_entries.size() - 1; i >= 0; i--) {
+        total += m_entries[i].durationMs;
+        if (total >= behindMs) {
+            return m_entries[i].sequence;
+        }
+    }
+
+    return m_entries.first().sequence;
+}
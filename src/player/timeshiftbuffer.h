@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TIMESHIFTBUFFER_H
+#define TIMESHIFTBUFFER_H
+
+#include <QList>
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+
+/**
+ * Bounded store of recent live segments for pause/rewind
+ *
+ * The newest segments stay in memory. Once the in-memory part grows past
+ * a threshold the oldest segments are spilled to a preallocated ring file,
+ * written sequentially and read back through a memory map - reads hand out
+ * QByteArray::fromRawData() views, so nothing is copied or allocated per
+ * segment on the way to the player.
+ *
+ * Segments are evicted from the front when the buffer holds more than
+ * the maximum rewind duration, or when the ring wraps onto them.
+ */
+class TimeshiftBuffer
+{
+public:
+    TimeshiftBuffer();
+    ~TimeshiftBuffer();
+
+    /**
+     * Create and map the ring file
+     *
+     * @param path Ring file location (recreated on every open)
+     * @param ringBytes Ring file size
+     * @return false if the file can't be created or mapped; the buffer
+     *         then keeps everything in memory up to the duration limit
+     */
+    bool open(const QString &path, qint64 ringBytes);
+    void close();
+    void clear();
+
+    void setMaxDurationMs(qint64 durationMs) { m_maxDurationMs = durationMs; }
+    void setMemoryThreshold(qint64 bytes) { m_memoryThreshold = bytes; }
+
+    /**
+     * Segments from this sequence on are still queued in the player and
+     * must not be overwritten on disk. -1 disables protection.
+     */
+    void setProtectedSequence(qint64 sequence) { m_protectedSequence = sequence; }
+
+    // Segments must be appended in increasing sequence order
+    void append(qint64 sequence, qint64 durationMs, const QByteArray &data);
+
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    bool contains(qint64 sequence) const { return indexOf(sequence) >= 0; }
+
+    // Segment bytes; a view into the ring mapping for spilled segments
+    QByteArray data(qint64 sequence) const;
+
+    qint64 firstSequence() const;
+    qint64 lastSequence() const;
+
+    // First buffered sequence >= the given one, -1 if none
+    qint64 nextAvailable(qint64 sequence) const;
+
+    // Buffered time from the given sequence up to the live edge
+    qint64 durationFrom(qint64 sequence) const;
+
+    // Sequence that starts roughly behindMs before the live edge
+    qint64 sequenceBehindLive(qint64 behindMs) const;
+
+    qint64 bufferedDurationMs() const { return m_durationMs; }
+
+private:
+    struct Entry {
+        qint64 sequence;
+        qint64 durationMs;
+        qint64 diskOffset;   // -1 while the segment lives in memory
+        int size;
+        QByteArray memory;
+    };
+
+    // Ordered by sequence; spilled entries form a prefix
+    QList<Entry> m_entries;
+    int m_spilledCount;
+
+    QFile m_ringFile;
+    uchar *m_map;
+    qint64 m_ringSize;
+    qint64 m_writeOffset;
+
+    qint64 m_durationMs;
+    qint64 m_memoryBytes;
+    qint64 m_maxDurationMs;
+    qint64 m_memoryThreshold;
+    qint64 m_protectedSequence;
+
+    int indexOf(qint64 sequence) const;
+    void evictFront();
+    void spillToRing();
+    bool spillOne();
+};
+
+#endif // TIMESHIFTBUFFER_H
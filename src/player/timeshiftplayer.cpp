@@ -0,0 +1,488 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timeshiftplayer.h"
+#include "segmentplaybackdevice.h"
+#include "../core/logging.h"
+#include <QNetworkRequest>
+#include <QMediaContent>
+#include <QStandardPaths>
+#include <QDir>
+#include <QUrl>
+
+const int TimeshiftPlayer::LIVE_EDGE_SEGMENTS;
+const int TimeshiftPlayer::LIVE_TOLERANCE_MS;
+const int TimeshiftPlayer::MAX_DEVICE_BUFFER_BYTES;
+const int TimeshiftPlayer::MAX_REWIND_MS;
+const int TimeshiftPlayer::MEMORY_THRESHOLD_BYTES;
+const qint64 TimeshiftPlayer::RING_FILE_BYTES;
+const int TimeshiftPlayer::MAX_PLAYLIST_FAILURES;
+
+static const int LIVE_REQUEST_TIMEOUT_MS = 10000;
+
+TimeshiftPlayer::TimeshiftPlayer(QObject *parent)
+    : QObject(parent)
+    , m_networkManager(new QNetworkAccessManager(this))
+    , m_player(new QMediaPlayer(this, QMediaPlayer::StreamPlayback))
+    , m_device(nullptr)
+    , m_pollTimer(new QTimer(this))
+    , m_playlistReply(nullptr)
+    , m_segmentReply(nullptr)
+    , m_ringOpen(false)
+    , m_lastQueuedSequence(-1)
+    , m_restartSequence(-1)
+    , m_startSequence(-1)
+    , m_nextToFeed(-1)
+    , m_wantPlaying(false)
+    , m_needsRestart(false)
+    , m_isBuffering(false)
+    , m_playlistFailures(0)
+{
+    m_buffer.setMaxDurationMs(MAX_REWIND_MS);
+    m_buffer.setMemoryThreshold(MEMORY_THRESHOLD_BYTES);
+
+    m_pollTimer->setInterval(2000);
+    connect(m_pollTimer, &QTimer::timeout, this, &TimeshiftPlayer::pollPlaylist);
+
+    connect(m_player, &QMediaPlayer::positionChanged, this, &TimeshiftPlayer::positionChanged);
+    connect(m_player, &QMediaPlayer::stateChanged, this, &TimeshiftPlayer::playingChanged);
+    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &TimeshiftPlayer::onPlayerStatusChanged);
+}
+
+TimeshiftPlayer::~TimeshiftPlayer()
+{
+    stop();
+}
+
+QObject *TimeshiftPlayer::mediaObject() const
+{
+    return m_player;
+}
+
+bool TimeshiftPlayer::isPlaying() const
+{
+    return m_player->state() == QMediaPlayer::PlayingState;
+}
+
+qint64 TimeshiftPlayer::behindLiveMs() const
+{
+    if (m_startSequence < 0) {
+        return 0;
+    }
+
+    qint64 behind = m_buffer.durationFrom(m_startSequence) - m_player->position();
+    return qMax<qint64>(0, behind);
+}
+
+// ========================================
+// PUBLIC API
+// ========================================
+
+void TimeshiftPlayer::load(const QString &playlistUrl)
+{
+    LOG_STREAM("Timeshift: following live playlist");
+
+    // A new stream: start over, but keep the ring file - recreating it
+    // means allocating RING_FILE_BYTES again
+    bool wasPlaying = m_wantPlaying;
+    reset();
+    m_wantPlaying = wasPlaying;
+
+    if (!m_ringOpen) {
+        QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        QDir().mkpath(cacheDir);
+        // Without the ring file the buffer still works, memory-only
+        m_ringOpen = m_buffer.open(cacheDir + "/timeshift.ring", RING_FILE_BYTES);
+    }
+
+    m_playlistUrl = playlistUrl;
+    setBuffering(true);
+
+    pollPlaylist();
+    m_pollTimer->start();
+}
+
+void TimeshiftPlayer::switchVariant(const QString &playlistUrl, bool restart)
+{
+    if (playlistUrl == m_playlistUrl) {
+        return;
+    }
+
+    // Twitch variants share media sequence numbers. Queued segments of the
+    // old variant are dropped; the one downloading is kept, so the new
+    // variant continues right after it
+    qint64 lastKept = m_segmentReply ? m_segmentReply->property("sequence").toLongLong()
+                                     : m_buffer.lastSequence();
+    if (m_playlistUrl.isEmpty() || lastKept < 0) {
+        // Nothing buffered yet that would be worth keeping
+        load(playlistUrl);
+        return;
+    }
+
+    LOG_STREAM("Timeshift: switching variant after segment" << lastKept);
+
+    if (m_playlistReply) {
+        QNetworkReply *reply = m_playlistReply;
+        m_playlistReply = nullptr;
+        reply->abort();
+    }
+
+    m_downloadQueue.clear();
+    m_lastQueuedSequence = lastKept;
+    m_restartSequence = restart ? lastKept + 1 : -1;
+    m_playlistFailures = 0;
+
+    m_playlistUrl = playlistUrl;
+    pollPlaylist();
+    m_pollTimer->start();
+}
+
+void TimeshiftPlayer::play()
+{
+    m_wantPlaying = true;
+
+    if (m_needsRestart) {
+        // Paused longer than the buffer reaches back - resume at the oldest
+        qint64 oldest = m_buffer.nextAvailable(m_buffer.firstSequence() + 1);
+        startAt(oldest >= 0 ? oldest : m_buffer.firstSequence());
+        return;
+    }
+
+    if (m_device) {
+        m_player->play();
+    }
+}
+
+void TimeshiftPlayer::pause()
+{
+    // Downloads keep running; that's what makes resume-where-paused work
+    m_wantPlaying = false;
+    m_player->pause();
+}
+
+void TimeshiftPlayer::stop()
+{
+    reset();
+
+    if (m_ringOpen) {
+        m_buffer.close();
+        m_ringOpen = false;
+    }
+}
+
+void TimeshiftPlayer::reset()
+{
+    m_wantPlaying = false;
+    m_pollTimer->stop();
+
+    if (m_playlistReply) {
+        QNetworkReply *reply = m_playlistReply;
+        m_playlistReply = nullptr;
+        reply->abort();
+    }
+    if (m_segmentReply) {
+        QNetworkReply *reply = m_segmentReply;
+        m_segmentReply = nullptr;
+        reply->abort();
+    }
+
+    releaseDevice();
+    m_buffer.clear();
+
+    m_playlistUrl.clear();
+    m_downloadQueue.clear();
+    m_lastQueuedSequence = -1;
+    m_restartSequence = -1;
+    m_startSequence = -1;
+    m_nextToFeed = -1;
+    m_needsRestart = false;
+    m_playlistFailures = 0;
+    setBuffering(false);
+
+    emit positionChanged();
+}
+
+void TimeshiftPlayer::rewind(int seconds)
+{
+    seekBehindLive(behindLiveMs() + qint64(seconds) * 1000);
+}
+
+void TimeshiftPlayer::seekBehindLive(qint64 behindMs)
+{
+    if (m_buffer.isEmpty()) {
+        return;
+    }
+
+    qint64 sequence = m_buffer.sequenceBehindLive(qMax<qint64>(0, behindMs));
+
+    // Stay one segment clear of the eviction edge
+    qint64 oldestSafe = m_buffer.nextAvailable(m_buffer.firstSequence() + 1);
+    if (oldestSafe >= 0 && sequence < oldestSafe) {
+        sequence = oldestSafe;
+    }
+
+    LOG_STREAM("Timeshift: seek to" << behindMs / 1000 << "s behind live, segment" << sequence);
+    startAt(sequence);
+}
+
+void TimeshiftPlayer::jumpToLive()
+{
+    if (m_buffer.isEmpty()) {
+        return;
+    }
+
+    qint64 sequence = m_buffer.nextAvailable(m_buffer.lastSequence() - LIVE_EDGE_SEGMENTS + 1);
+    startAt(sequence);
+}
+
+// ========================================
+// LIVE PLAYLIST / DOWNLOADS
+// ========================================
+
+void TimeshiftPlayer::pollPlaylist()
+{
+    if (m_playlistReply || m_playlistUrl.isEmpty()) {
+        return;
+    }
+
+    QNetworkRequest request{QUrl(m_playlistUrl)};
+    request.setTransferTimeout(LIVE_REQUEST_TIMEOUT_MS);
+
+    m_playlistReply = m_networkManager->get(request);
+    connect(m_playlistReply, &QNetworkReply::finished, this, &TimeshiftPlayer::onPlaylistReceived);
+}
+
+void TimeshiftPlayer::onPlaylistReceived()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    reply->deleteLater();
+    if (reply != m_playlistReply) {
+        return;
+    }
+    m_playlistReply = nullptr;
+
+    if (reply->error() != QNetworkReply::NoError) {
+        WARN_STREAM("Timeshift: playlist refresh failed:" << reply->errorString());
+        if (++m_playlistFailures >= MAX_PLAYLIST_FAILURES) {
+            m_pollTimer->stop();
+            emit error("Lost connection to live stream");
+        }
+        return;
+    }
+    m_playlistFailures = 0;
+
+    HlsMediaPlaylist playlist = HlsPlaylist::parseMedia(QString::fromUtf8(reply->readAll()), reply->url());
+
+    if (playlist.targetDurationMs > 0) {
+        m_pollTimer->setInterval(int(qBound<qint64>(1000, playlist.targetDurationMs / 2, 5000)));
+    }
+
+    bool firstLoad = m_lastQueuedSequence < 0;
+    int firstIndex = 0;
+    if (firstLoad) {
+        // Start near the live edge, not at the start of the window
+        firstIndex = qMax(0, playlist.segments.size() - LIVE_EDGE_SEGMENTS);
+    }
+
+    for (int i = firstIndex; i < playlist.segments.size(); i++) {
+        const HlsSegment &segment = playlist.segments[i];
+        if (segment.sequence > m_lastQueuedSequence) {
+            m_downloadQueue.enqueue(segment);
+            m_lastQueuedSequence = segment.sequence;
+        }
+    }
+
+    if (playlist.endList) {
+        LOG_STREAM("Timeshift: stream ended");
+        m_pollTimer->stop();
+    }
+
+    if (firstLoad && !m_downloadQueue.isEmpty()) {
+        startAt(m_downloadQueue.head().sequence);
+    }
+
+    downloadNext();
+}
+
+void TimeshiftPlayer::downloadNext()
+{
+    // One at a time: live segments arrive slower than they download
+    if (m_segmentReply || m_downloadQueue.isEmpty()) {
+        return;
+    }
+
+    HlsSegment segment = m_downloadQueue.dequeue();
+
+    QNetworkRequest request{QUrl(segment.url)};
+    request.setTransferTimeout(LIVE_REQUEST_TIMEOUT_MS);
+
+    m_segmentReply = m_networkManager->get(request);
+    m_segmentReply->setProperty("sequence", segment.sequence);
+    m_segmentReply->setProperty("durationMs", segment.durationMs);
+
+    connect(m_segmentReply, &QNetworkReply::finished, this, &TimeshiftPlayer::onSegmentReceived);
+}
+
+void TimeshiftPlayer::onSegmentReceived()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    reply->deleteLater();
+    if (reply != m_segmentReply) {
+        return;
+    }
+    m_segmentReply = nullptr;
+
+    if (reply->error() != QNetworkReply::NoError) {
+        WARN_STREAM("Timeshift: segment failed:" << reply->errorString());
+        downloadNext();
+        return;
+    }
+
+    // The player still reads the oldest segment and the next append would
+    // evict it - let go of the device, resume from the buffer later
+    if (!m_deviceSequences.isEmpty() && m_deviceSequences.head() <= m_buffer.firstSequence() &&
+        m_buffer.bufferedDurationMs() >= MAX_REWIND_MS) {
+        LOG_STREAM("Timeshift: playhead fell out of the buffer");
+        releaseDevice();
+        m_needsRestart = true;
+        if (m_wantPlaying) {
+            play();
+        }
+    }
+
+    qint64 sequence = reply->property("sequence").toLongLong();
+    m_buffer.append(sequence, reply->property("durationMs").toLongLong(), reply->readAll());
+
+    if (m_restartSequence >= 0 && sequence >= m_restartSequence) {
+        m_restartSequence = -1;
+        startAt(sequence);
+    }
+
+    feedDevice();
+    emit positionChanged();
+
+    downloadNext();
+}
+
+// ========================================
+// PLAYBACK
+// ========================================
+
+void TimeshiftPlayer::startAt(qint64 sequence)
+{
+    releaseDevice();
+    m_needsRestart = false;
+
+    m_device = new SegmentPlaybackDevice(this);
+    connect(m_device, &SegmentPlaybackDevice::segmentConsumed, this, &TimeshiftPlayer::onSegmentConsumed);
+
+    m_startSequence = sequence;
+    m_nextToFeed = sequence;
+
+    setBuffering(true);
+    m_player->setMedia(QMediaContent(), m_device);
+
+    feedDevice();
+    emit positionChanged();
+
+    if (m_wantPlaying) {
+        m_player->play();
+    }
+}
+
+void TimeshiftPlayer::feedDevice()
+{
+    if (!m_device) {
+        return;
+    }
+
+    while (m_device->bufferedBytes() < MAX_DEVICE_BUFFER_BYTES) {
+        // Skips over segments that failed to download
+        qint64 next = m_buffer.nextAvailable(m_nextToFeed);
+        if (next < 0) {
+            break;
+        }
+
+        m_device->appendSegment(m_buffer.data(next));
+        m_deviceSequences.enqueue(next);
+        m_nextToFeed = next + 1;
+    }
+
+    updateProtection();
+}
+
+void TimeshiftPlayer::onSegmentConsumed()
+{
+    if (!m_deviceSequences.isEmpty()) {
+        m_deviceSequences.dequeue();
+    }
+
+    feedDevice();
+}
+
+void TimeshiftPlayer::releaseDevice()
+{
+    m_player->stop();
+    m_player->setMedia(QMediaContent());
+
+    if (m_device) {
+        m_device->deleteLater();
+        m_device = nullptr;
+    }
+
+    m_deviceSequences.clear();
+    updateProtection();
+}
+
+void TimeshiftPlayer::updateProtection()
+{
+    // Device holds zero-copy views into the ring file
+    m_buffer.setProtectedSequence(m_deviceSequences.isEmpty() ? -1 : m_deviceSequences.head());
+}
+
+void TimeshiftPlayer::onPlayerStatusChanged(QMediaPlayer::MediaStatus status)
+{
+    switch (status) {
+    case QMediaPlayer::LoadingMedia:
+    case QMediaPlayer::StalledMedia:
+        setBuffering(true);
+        break;
+    case QMediaPlayer::LoadedMedia:
+    case QMediaPlayer::BufferedMedia:
+    case QMediaPlayer::EndOfMedia:
+        setBuffering(false);
+        break;
+    case QMediaPlayer::InvalidMedia:
+        setBuffering(false);
+        ERR_STREAM("Timeshift playback failed:" << m_player->errorString());
+        emit error("Timeshift playback failed");
+        break;
+    default:
+        break;
+    }
+}
+
+void TimeshiftPlayer::setBuffering(bool buffering)
+{
+    if (m_isBuffering != buffering) {
+        m_isBuffering = buffering;
+        emit bufferingChanged();
+    }
+}
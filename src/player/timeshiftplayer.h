@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TIMESHIFTPLAYER_H
+#define TIMESHIFTPLAYER_H
+
+#include <QObject>
+#include <QQueue>
+#include <QTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QMediaPlayer>
+#include "hlsplaylist.h"
+#include "timeshiftbuffer.h"
+
+class SegmentPlaybackDevice;
+
+/**
+ * TimeshiftPlayer - Live playback with pause, rewind and jump-to-live
+ *
+ * Purpose: QtMultimedia's HLS path has no history, so pausing a live
+ * stream either resumes somewhere random or stalls once the paused
+ * position falls out of the live playlist. TimeshiftPlayer follows the
+ * live media playlist itself, keeps recent segments in a TimeshiftBuffer
+ * and plays from a movable playhead inside that buffer.
+ *
+ * Features:
+ * - Segments are downloaded once and shared by live playback and rewind
+ * - Keeps recording while paused, so resume continues where it stopped
+ * - rewind()/jumpToLive() restart the playhead inside the buffer
+ * - switchVariant() changes quality without a rebuffer: the new variant's
+ *   segments continue the same sequence and buffer
+ * - Exposes mediaObject for QML VideoOutput { source: timeshiftPlayer }
+ */
+class TimeshiftPlayer : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QObject *mediaObject READ mediaObject CONSTANT)
+    Q_PROPERTY(bool isPlaying READ isPlaying NOTIFY playingChanged)
+    Q_PROPERTY(bool isBuffering READ isBuffering NOTIFY bufferingChanged)
+    Q_PROPERTY(qint64 behindLiveMs READ behindLiveMs NOTIFY positionChanged)
+    Q_PROPERTY(qint64 bufferedMs READ bufferedMs NOTIFY positionChanged)
+    Q_PROPERTY(bool isAtLive READ isAtLive NOTIFY positionChanged)
+
+public:
+    explicit TimeshiftPlayer(QObject *parent = nullptr);
+    ~TimeshiftPlayer();
+
+    QObject *mediaObject() const;
+    bool isPlaying() const;
+    bool isBuffering() const { return m_isBuffering; }
+    qint64 behindLiveMs() const;
+    qint64 bufferedMs() const { return m_buffer.bufferedDurationMs(); }
+    bool isAtLive() const { return behindLiveMs() <= LIVE_TOLERANCE_MS; }
+
+    // Start following a live media (variant) playlist at the live edge.
+    // For a new stream; quality switches go through switchVariant()
+    Q_INVOKABLE void load(const QString &playlistUrl);
+
+    // Follow another variant of the same stream. The buffer and playhead
+    // stay; new segments are spliced in at the next sequence. 'restart'
+    // moves the playhead to the first new segment, for switches the
+    // decoder can't follow in one stream (audio only <-> video).
+    Q_INVOKABLE void switchVariant(const QString &playlistUrl, bool restart = false);
+
+    Q_INVOKABLE void play();
+    Q_INVOKABLE void pause();
+    Q_INVOKABLE void stop();
+
+    // Move the playhead back by the given time (clamped to the buffer)
+    Q_INVOKABLE void rewind(int seconds);
+
+    // Move the playhead to a position relative to the live edge
+    Q_INVOKABLE void seekBehindLive(qint64 behindMs);
+
+    Q_INVOKABLE void jumpToLive();
+
+signals:
+    void playingChanged();
+    void bufferingChanged();
+    void positionChanged();
+    void error(const QString &message);
+
+private slots:
+    void pollPlaylist();
+    void onPlaylistReceived();
+    void onSegmentReceived();
+    void onSegmentConsumed();
+    void onPlayerStatusChanged(QMediaPlayer::MediaStatus status);
+
+private:
+    QNetworkAccessManager *m_networkManager;
+    QMediaPlayer *m_player;
+    SegmentPlaybackDevice *m_device;
+    QTimer *m_pollTimer;
+    QNetworkReply *m_playlistReply;
+    QNetworkReply *m_segmentReply;
+
+    TimeshiftBuffer m_buffer;
+    bool m_ringOpen;
+    QString m_playlistUrl;
+
+    // Download side
+    QQueue<HlsSegment> m_downloadQueue;
+    qint64 m_lastQueuedSequence;
+    qint64 m_restartSequence;     // switchVariant(restart): first new segment
+
+    // Playback side
+    qint64 m_startSequence;       // First segment fed to the current device
+    qint64 m_nextToFeed;
+    QQueue<qint64> m_deviceSequences; // Fed to the device, not yet consumed
+    bool m_wantPlaying;
+    bool m_needsRestart;          // Paused position fell out of the buffer
+    bool m_isBuffering;
+    int m_playlistFailures;
+
+    static const int LIVE_EDGE_SEGMENTS = 3;
+    static const int LIVE_TOLERANCE_MS = 10000;
+    static const int MAX_DEVICE_BUFFER_BYTES = 4 * 1024 * 1024;
+    static const int MAX_REWIND_MS = 5 * 60 * 1000;
+    static const int MEMORY_THRESHOLD_BYTES = 24 * 1024 * 1024;
+    static const qint64 RING_FILE_BYTES = 192LL * 1024 * 1024;
+    static const int MAX_PLAYLIST_FAILURES = 5;
+
+    void reset();
+    void startAt(qint64 sequence);
+    void feedDevice();
+    void downloadNext();
+    void releaseDevice();
+    void updateProtection();
+    void setBuffering(bool buffering);
+};
+
+#endif // TIMESHIFTPLAYER_H
@@ -0,0 +1,427 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vodplayer.h"
+#include "segmentplaybackdevice.h"
+#include "hlsplaylist.h"
+#include "../core/logging.h"
+#include <QNetworkRequest>
+#include <QMediaContent>
+#include <QUrl>
+
+const int VodPlayer::SEGMENTS_AHEAD;
+const int VodPlayer::SEGMENTS_BEHIND;
+const int VodPlayer::MAX_DEVICE_BUFFER_BYTES;
+const int VodPlayer::SEGMENT_CACHE_KB;
+const int VodPlayer::MAX_SEGMENT_RETRIES;
+const int VodPlayer::RETRY_BASE_DELAY_MS;
+
+static const int SEGMENT_TIMEOUT_MS = 15000;
+
+VodPlayer::VodPlayer(QObject *parent)
+    : QObject(parent)
+    , m_networkManager(new QNetworkAccessManager(this))
+    , m_player(new QMediaPlayer(this, QMediaPlayer::StreamPlayback))
+    , m_device(nullptr)
+    , m_playlistReply(nullptr)
+    , m_retryTimer(new QTimer(this))
+    , m_nextToFeed(0)
+    , m_positionBaseMs(0)
+    , m_pendingStartMs(0)
+    , m_wantPlaying(false)
+    , m_isBuffering(false)
+    , m_headRetries(0)
+{
+    m_segmentCache.setMaxCost(SEGMENT_CACHE_KB);
+
+    m_retryTimer->setSingleShot(true);
+    connect(m_retryTimer, &QTimer::timeout, this, &VodPlayer::retryHeadSegment);
+
+    connect(m_player, &QMediaPlayer::positionChanged, this, &VodPlayer::positionChanged);
+    connect(m_player, &QMediaPlayer::stateChanged, this, &VodPlayer::playingChanged);
+    connect(m_player, &QMediaPlayer::mediaStatusChanged, this, &VodPlayer::onPlayerStatusChanged);
+}
+
+VodPlayer::~VodPlayer()
+{
+    abortDownloads();
+}
+
+QObject *VodPlayer::mediaObject() const
+{
+    return m_player;
+}
+
+qint64 VodPlayer::position() const
+{
+    if (!m_device) {
+        return m_pendingStartMs;
+    }
+    return m_positionBaseMs + m_player->position();
+}
+
+bool VodPlayer::isPlaying() const
+{
+    return m_player->state() == QMediaPlayer::PlayingState;
+}
+
+// ========================================
+// PUBLIC API
+// ========================================
+
+void VodPlayer::load(const QString &playlistUrl, qint64 startMs)
+{
+    LOG_STREAM("Loading VOD playlist, start at" << startMs << "ms");
+
+    abortDownloads();
+    m_retryTimer->stop();
+    if (m_playlistReply) {
+        m_playlistReply->abort();
+    }
+
+    m_playlistUrl = playlistUrl;
+    m_pendingStartMs = startMs;
+    m_ready.clear();
+    // Variants are segmented differently, cached bytes are for the old one
+    m_segmentCache.clear();
+    setBuffering(true);
+
+    QNetworkRequest request{QUrl(playlistUrl)};
+    request.setTransferTimeout(SEGMENT_TIMEOUT_MS);
+
+    m_playlistReply = m_networkManager->get(request);
+    connect(m_playlistReply, &QNetworkReply::finished, this, &VodPlayer::onPlaylistReceived);
+}
+
+void VodPlayer::seek(qint64 positionMs)
+{
+    // m_index still belongs to the old variant during a quality switch
+    if (m_index.isEmpty() || m_playlistReply) {
+        // Playlist still loading - start there once it arrives
+        m_pendingStartMs = positionMs;
+        emit positionChanged();
+        return;
+    }
+
+    int index = m_index.indexForPosition(positionMs);
+    LOG_STREAM("VOD seek to" << positionMs << "ms -> segment" << index);
+    startAt(index);
+}
+
+void VodPlayer::play()
+{
+    m_wantPlaying = true;
+    if (m_device) {
+        m_player->play();
+    }
+}
+
+void VodPlayer::pause()
+{
+    m_wantPlaying = false;
+    m_player->pause();
+}
+
+void VodPlayer::stop()
+{
+    m_wantPlaying = false;
+
+    abortDownloads();
+    m_retryTimer->stop();
+    if (m_playlistReply) {
+        m_playlistReply->abort();
+    }
+
+    m_player->stop();
+    m_player->setMedia(QMediaContent());
+
+    if (m_device) {
+        m_device->deleteLater();
+        m_device = nullptr;
+    }
+
+    m_ready.clear();
+    m_segmentCache.clear();
+    m_index = VodSegmentIndex();
+    m_pendingStartMs = 0;
+    m_positionBaseMs = 0;
+    setBuffering(false);
+
+    emit durationChanged();
+    emit positionChanged();
+}
+
+// ========================================
+// PLAYLIST
+// ========================================
+
+void VodPlayer::onPlaylistReceived()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    reply->deleteLater();
+    if (reply != m_playlistReply) {
+        return;
+    }
+    m_playlistReply = nullptr;
+
+    if (reply->error() != QNetworkReply::NoError) {
+        if (reply->error() != QNetworkReply::OperationCanceledError) {
+            ERR_STREAM("Failed to load VOD playlist:" << reply->errorString());
+            setBuffering(false);
+            emit error("Failed to load VOD: " + reply->errorString());
+        }
+        return;
+    }
+
+    HlsMediaPlaylist playlist = HlsPlaylist::parseMedia(QString::fromUtf8(reply->readAll()), reply->url());
+    m_index = VodSegmentIndex(playlist);
+
+    if (m_index.isEmpty()) {
+        ERR_STREAM("VOD playlist has no segments");
+        setBuffering(false);
+        emit error("VOD has no playable segments");
+        return;
+    }
+
+    LOG_STREAM("VOD indexed:" << m_index.count() << "segments," << m_index.durationMs() / 1000 << "s");
+    emit durationChanged();
+
+    startAt(m_index.indexForPosition(m_pendingStartMs));
+}
+
+// ========================================
+// PLAYBACK WINDOW
+// ========================================
+
+void VodPlayer::startAt(int segmentIndex)
+{
+    abortDownloads();
+    m_retryTimer->stop();
+    m_headRetries = 0;
+    m_ready.clear();
+
+    // Drop the old device before handing the player a new one
+    m_player->stop();
+    m_player->setMedia(QMediaContent());
+    if (m_device) {
+        m_device->deleteLater();
+    }
+
+    m_device = new SegmentPlaybackDevice(this);
+    connect(m_device, &SegmentPlaybackDevice::segmentConsumed, this, &VodPlayer::onSegmentConsumed);
+
+    m_nextToFeed = segmentIndex;
+    m_positionBaseMs = m_index.startOf(segmentIndex);
+    m_pendingStartMs = m_positionBaseMs;
+    emit positionChanged();
+
+    setBuffering(true);
+
+    // The URL only tells the backend what the stream looks like
+    m_player->setMedia(QMediaContent(QUrl(m_index.segment(segmentIndex).url)), m_device);
+
+    fillWindow();
+
+    // Keep the segment before the target around for small backward seeks
+    for (int i = qMax(0, segmentIndex - SEGMENTS_BEHIND); i < segmentIndex; i++) {
+        if (!m_segmentCache.contains(i)) {
+            requestSegment(i, QNetworkRequest::LowPriority);
+        }
+    }
+
+    if (m_wantPlaying) {
+        m_player->play();
+    }
+}
+
+void VodPlayer::fillWindow()
+{
+    if (!m_device) {
+        return;
+    }
+
+    feedReadySegments();
+
+    // Old variant's index - nothing to request until the new one is in
+    if (m_playlistReply) {
+        return;
+    }
+
+    if (m_device->bufferedBytes() >= MAX_DEVICE_BUFFER_BYTES) {
+        return;
+    }
+
+    bool cacheHit = false;
+    int end = qMin(m_index.count(), m_nextToFeed + SEGMENTS_AHEAD);
+
+    for (int i = m_nextToFeed; i < end; i++) {
+        if (m_ready.contains(i) || m_inFlight.contains(i)) {
+            continue;
+        }
+
+        if (QByteArray *cached = m_segmentCache.object(i)) {
+            m_ready.insert(i, *cached);
+            cacheHit = true;
+            continue;
+        }
+
+        // Waiting out the backoff after a failure
+        if (i == m_nextToFeed && m_retryTimer->isActive()) {
+            continue;
+        }
+
+        // The segment the player is waiting on goes first
+        requestSegment(i, i == m_nextToFeed ? QNetworkRequest::HighPriority
+                                            : QNetworkRequest::NormalPriority);
+    }
+
+    if (cacheHit) {
+        feedReadySegments();
+    }
+}
+
+void VodPlayer::requestSegment(int index, QNetworkRequest::Priority priority)
+{
+    QNetworkRequest request{QUrl(m_index.segment(index).url)};
+    request.setPriority(priority);
+    request.setTransferTimeout(SEGMENT_TIMEOUT_MS);
+
+    QNetworkReply *reply = m_networkManager->get(request);
+    reply->setProperty("segmentIndex", index);
+    m_inFlight.insert(index, reply);
+
+    connect(reply, &QNetworkReply::finished, this, &VodPlayer::onSegmentReceived);
+}
+
+void VodPlayer::onSegmentReceived()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    reply->deleteLater();
+
+    int index = reply->property("segmentIndex").toInt();
+    if (m_inFlight.value(index) != reply) {
+        // Superseded by a seek
+        return;
+    }
+    m_inFlight.remove(index);
+
+    if (reply->error() != QNetworkReply::NoError) {
+        WARN_STREAM("VOD segment" << index << "failed:" << reply->errorString());
+        if (index != m_nextToFeed) {
+            return;     // requested again by the next fillWindow()
+        }
+
+        // Playback can't go on without this one
+        if (m_headRetries >= MAX_SEGMENT_RETRIES) {
+            setBuffering(false);
+            emit error("Failed to load VOD segment");
+            return;
+        }
+        int delay = RETRY_BASE_DELAY_MS << m_headRetries;
+        m_headRetries++;
+        LOG_STREAM("Retrying VOD segment" << index << "in" << delay << "ms");
+        m_retryTimer->start(delay);
+        return;
+    }
+
+    QByteArray data = reply->readAll();
+    if (index == m_nextToFeed) {
+        m_headRetries = 0;
+    }
+
+    if (index < m_nextToFeed) {
+        // Backward prefetch - only needed if the user seeks back
+        m_segmentCache.insert(index, new QByteArray(data), qMax(1, data.size() / 1024));
+        return;
+    }
+
+    m_ready.insert(index, data);
+    fillWindow();
+}
+
+void VodPlayer::feedReadySegments()
+{
+    while (m_device && m_ready.contains(m_nextToFeed)) {
+        QByteArray data = m_ready.take(m_nextToFeed);
+        m_device->appendSegment(data);
+        m_segmentCache.insert(m_nextToFeed, new QByteArray(data), qMax(1, data.size() / 1024));
+        m_nextToFeed++;
+    }
+
+    if (m_device && m_nextToFeed >= m_index.count()) {
+        m_device->finish();
+    }
+}
+
+void VodPlayer::onSegmentConsumed()
+{
+    fillWindow();
+}
+
+void VodPlayer::retryHeadSegment()
+{
+    if (!m_device || m_nextToFeed >= m_index.count() ||
+        m_ready.contains(m_nextToFeed) || m_inFlight.contains(m_nextToFeed)) {
+        return;
+    }
+
+    requestSegment(m_nextToFeed, QNetworkRequest::HighPriority);
+}
+
+void VodPlayer::abortDownloads()
+{
+    // abort() emits finished synchronously, so detach the map first
+    const QMap<int, QNetworkReply*> inFlight = m_inFlight;
+    m_inFlight.clear();
+
+    for (QNetworkReply *reply : inFlight) {
+        reply->abort();
+    }
+}
+
+void VodPlayer::onPlayerStatusChanged(QMediaPlayer::MediaStatus status)
+{
+    switch (status) {
+    case QMediaPlayer::LoadingMedia:
+    case QMediaPlayer::StalledMedia:
+        setBuffering(true);
+        break;
+    case QMediaPlayer::LoadedMedia:
+    case QMediaPlayer::BufferedMedia:
+    case QMediaPlayer::EndOfMedia:
+        setBuffering(false);
+        break;
+    case QMediaPlayer::InvalidMedia:
+        setBuffering(false);
+        ERR_STREAM("VOD playback failed:" << m_player->errorString());
+        emit error("VOD playback failed");
+        break;
+    default:
+        break;
+    }
+}
+
+void VodPlayer::setBuffering(bool buffering)
+{
+    if (m_isBuffering != buffering) {
+        m_isBuffering = buffering;
+        emit bufferingChanged();
+    }
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VODPLAYER_H
+#define VODPLAYER_H
+
+#include <QObject>
+#include <QMap>
+#include <QCache>
+#include <QByteArray>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QMediaPlayer>
+#include <QTimer>
+#include "vodsegmentindex.h"
+
+class SegmentPlaybackDevice;
+
+/**
+ * VodPlayer - Segment-addressed VOD playback with fast seeking
+ *
+ * Purpose: Seeking in a long VOD through QtMultimedia's own HLS handling
+ * downloads segments one after another from the start of the stream.
+ * VodPlayer indexes the media playlist instead, so a seek jumps straight
+ * to the segment containing the target and downloads it together with the
+ * next few segments in parallel.
+ *
+ * Features:
+ * - O(log n) time -> segment lookup (VodSegmentIndex)
+ * - Parallel download window ahead of the read position, refilled as the
+ *   player consumes segments
+ * - Segment before the seek target fetched at low priority and kept in a
+ *   small cache, so short backward seeks start instantly
+ * - The segment the player waits on is retried with backoff before the
+ *   VOD is given up
+ * - Exposes mediaObject for QML VideoOutput { source: vodPlayer }
+ */
+class VodPlayer : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QObject *mediaObject READ mediaObject CONSTANT)
+    Q_PROPERTY(qint64 position READ position NOTIFY positionChanged)
+    Q_PROPERTY(qint64 duration READ duration NOTIFY durationChanged)
+    Q_PROPERTY(bool isPlaying READ isPlaying NOTIFY playingChanged)
+    Q_PROPERTY(bool isBuffering READ isBuffering NOTIFY bufferingChanged)
+
+public:
+    explicit VodPlayer(QObject *parent = nullptr);
+    ~VodPlayer();
+
+    QObject *mediaObject() const;
+    qint64 position() const;
+    qint64 duration() const { return m_index.durationMs(); }
+    bool isPlaying() const;
+    bool isBuffering() const { return m_isBuffering; }
+
+    /**
+     * Load a VOD media playlist
+     *
+     * @param playlistUrl Media (variant) playlist URL from the usher master
+     * @param startMs Position to start from, e.g. to keep the position
+     *                across a quality switch
+     */
+    Q_INVOKABLE void load(const QString &playlistUrl, qint64 startMs = 0);
+
+    // Jump to a position; playback resumes at the containing segment
+    Q_INVOKABLE void seek(qint64 positionMs);
+
+    Q_INVOKABLE void play();
+    Q_INVOKABLE void pause();
+    Q_INVOKABLE void stop();
+
+signals:
+    void positionChanged();
+    void durationChanged();
+    void playingChanged();
+    void bufferingChanged();
+    void error(const QString &message);
+
+private slots:
+    void onPlaylistReceived();
+    void onSegmentReceived();
+    void onSegmentConsumed();
+    void retryHeadSegment();
+    void onPlayerStatusChanged(QMediaPlayer::MediaStatus status);
+
+private:
+    QNetworkAccessManager *m_networkManager;
+    QMediaPlayer *m_player;
+    SegmentPlaybackDevice *m_device;
+    QNetworkReply *m_playlistReply;
+    QTimer *m_retryTimer;
+
+    VodSegmentIndex m_index;
+    QString m_playlistUrl;
+
+    // Playback window
+    int m_nextToFeed;            // Next segment handed to the device
+    qint64 m_positionBaseMs;     // VOD time at which the device starts
+    qint64 m_pendingStartMs;     // Start position while the playlist loads
+    bool m_wantPlaying;
+    bool m_isBuffering;
+    int m_headRetries;           // Failed attempts at m_nextToFeed
+
+    QMap<int, QNetworkReply*> m_inFlight;
+    QMap<int, QByteArray> m_ready;         // Downloaded, waiting for their turn
+    QCache<int, QByteArray> m_segmentCache; // Recently played/prefetched, cost in KB
+
+    static const int SEGMENTS_AHEAD = 4;
+    static const int SEGMENTS_BEHIND = 1;
+    static const int MAX_DEVICE_BUFFER_BYTES = 16 * 1024 * 1024;
+    static const int SEGMENT_CACHE_KB = 24 * 1024;
+    static const int MAX_SEGMENT_RETRIES = 4;
+    static const int RETRY_BASE_DELAY_MS = 1000;
+
+    void startAt(int segmentIndex);
+    void fillWindow();
+    void requestSegment(int index, QNetworkRequest::Priority priority);
+    void feedReadySegments();
+    void abortDownloads();
+    void setBuffering(bool buffering);
+};
+
+#endif // VODPLAYER_H
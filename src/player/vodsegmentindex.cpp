@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "vodsegmentindex.h"
+#include <algorithm>
+
+VodSegmentIndex::VodSegmentIndex(const HlsMediaPlaylist &playlist)
+    : m_segments(playlist.segments)
+{
+    m_startMs.reserve(m_segments.size());
+
+    qint64 offset = 0;
+    for (const HlsSegment &segment : m_segments) {
+        m_startMs.append(offset);
+        offset += segment.durationMs;
+    }
+
+    m_durationMs = offset;
+}
+
+int VodSegmentIndex::indexForPosition(qint64 positionMs) const
+{
+    if (m_startMs.isEmpty()) {
+        return -1;
+    }
+
+    // First segment starting after the position, then step back one
+    auto it = std::upper_bound(m_startMs.constBegin(), m_startMs.constEnd(), positionMs);
+    int index = int(it - m_startMs.constBegin()) - 1;
+
+    return qBound(0, index, m_startMs.size() - 1);
+}
+
+qint64 VodSegmentIndex::startOf(int index) const
+{
+    if (index < 0 || index >= m_startMs.size()) {
+        return 0;
+    }
+    return m_startMs[index];
+}
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef VODSEGMENTINDEX_H
+#define VODSEGMENTINDEX_H
+
+#include <QVector>
+#include <QString>
+#include "hlsplaylist.h"
+
+/**
+ * Time -> segment lookup for a VOD media playlist
+ *
+ * Multi-hour VODs have thousands of segments; start offsets are
+ * precomputed once so a seek is a binary search instead of a walk.
+ */
+class VodSegmentIndex
+{
+public:
+    VodSegmentIndex() = default;
+    explicit VodSegmentIndex(const HlsMediaPlaylist &playlist);
+
+    bool isEmpty() const { return m_segments.isEmpty(); }
+    int count() const { return m_segments.size(); }
+    qint64 durationMs() const { return m_durationMs; }
+
+    /**
+     * Segment containing a playback position
+     *
+     * @param positionMs Position from the start of the VOD
+     * @return Segment index, clamped to the valid range (-1 if empty)
+     */
+    int indexForPosition(qint64 positionMs) const;
+
+    // Start offset of a segment from the start of the VOD
+    qint64 startOf(int index) const;
+
+    const HlsSegment &segment(int index) const { return m_segments[index]; }
+
+private:
+    QVector<HlsSegment> m_segments;
+    QVector<qint64> m_startMs;   // Parallel to m_segments
+    qint64 m_durationMs = 0;
+};
+
+#endif // VODSEGMENTINDEX_H
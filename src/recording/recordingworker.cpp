@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "recordingworker.h"
+#include "../core/logging.h"
+#include <QNetworkRequest>
+#include <QUrl>
+
+const int RecordingWorker::MAX_FAILURES;
+const int RecordingWorker::REQUEST_TIMEOUT_MS;
+
+RecordingWorker::RecordingWorker(QObject *parent)
+    : QObject(parent)
+    // Children move to the I/O thread together with the worker
+    , m_networkManager(new QNetworkAccessManager(this))
+    , m_pollTimer(new QTimer(this))
+    , m_playlistReply(nullptr)
+    , m_segmentReply(nullptr)
+    , m_lastQueuedSequence(-1)
+    , m_recordedMs(0)
+    , m_failures(0)
+    , m_streamEnded(false)
+{
+    m_pollTimer->setInterval(2000);
+    connect(m_pollTimer, &QTimer::timeout, this, &RecordingWorker::pollPlaylist);
+}
+
+RecordingWorker::~RecordingWorker()
+{
+    m_writer.close();
+}
+
+void RecordingWorker::start(const QString &playlistUrl, const QString &outputPath)
+{
+    if (m_writer.isOpen()) {
+        stop();
+    }
+
+    if (!m_writer.open(outputPath)) {
+        emit error("Cannot create recording file: " + m_writer.errorString());
+        return;
+    }
+
+    LOG_STREAM("Recording to" << outputPath);
+
+    m_playlistUrl = playlistUrl;
+    m_outputPath = outputPath;
+    m_downloadQueue.clear();
+    m_lastQueuedSequence = -1;
+    m_recordedMs = 0;
+    m_failures = 0;
+    m_streamEnded = false;
+
+    emit started(outputPath);
+
+    pollPlaylist();
+    m_pollTimer->start();
+}
+
+void RecordingWorker::stop()
+{
+    if (!m_writer.isOpen()) {
+        return;
+    }
+
+    m_pollTimer->stop();
+    m_downloadQueue.clear();
+
+    if (m_playlistReply) {
+        QNetworkReply *reply = m_playlistReply;
+        m_playlistReply = nullptr;
+        reply->abort();
+    }
+    if (m_segmentReply) {
+        QNetworkReply *reply = m_segmentReply;
+        m_segmentReply = nullptr;
+        reply->abort();
+    }
+
+    finish();
+}
+
+void RecordingWorker::finish()
+{
+    qint64 bytes = m_writer.bytesWritten();
+    m_writer.close();
+
+    LOG_STREAM("Recording finished:" << bytes / (1024 * 1024) << "MB," << m_recordedMs / 1000 << "s");
+    emit finished(m_outputPath, bytes);
+}
+
+// ========================================
+// PLAYLIST / SEGMENTS
+// ========================================
+
+void RecordingWorker::pollPlaylist()
+{
+    if (m_playlistReply) {
+        return;
+    }
+
+    QNetworkRequest request{QUrl(m_playlistUrl)};
+    request.setTransferTimeout(REQUEST_TIMEOUT_MS);
+
+    m_playlistReply = m_networkManager->get(request);
+    connect(m_playlistReply, &QNetworkReply::finished, this, &RecordingWorker::onPlaylistReceived);
+}
+
+void RecordingWorker::onPlaylistReceived()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    reply->deleteLater();
+    if (reply != m_playlistReply) {
+        return;
+    }
+    m_playlistReply = nullptr;
+
+    if (reply->error() != QNetworkReply::NoError) {
+        WARN_STREAM("Recorder: playlist refresh failed:" << reply->errorString());
+        if (++m_failures >= MAX_FAILURES) {
+            emit error("Recording stopped: lost connection to stream");
+            stop();
+        }
+        return;
+    }
+    m_failures = 0;
+
+    HlsMediaPlaylist playlist = HlsPlaylist::parseMedia(QString::fromUtf8(reply->readAll()), reply->url());
+
+    if (playlist.targetDurationMs > 0) {
+        m_pollTimer->setInterval(int(qBound<qint64>(1000, playlist.targetDurationMs / 2, 5000)));
+    }
+
+    for (const HlsSegment &segment : playlist.segments) {
+        if (segment.sequence > m_lastQueuedSequence) {
+            m_downloadQueue.enqueue(segment);
+            m_lastQueuedSequence = segment.sequence;
+        }
+    }
+
+    if (playlist.endList) {
+        m_streamEnded = true;
+        m_pollTimer->stop();
+    }
+
+    downloadNext();
+}
+
+void RecordingWorker::downloadNext()
+{
+    if (m_segmentReply) {
+        return;
+    }
+
+    if (m_downloadQueue.isEmpty()) {
+        if (m_streamEnded && m_writer.isOpen()) {
+            finish();
+        }
+        return;
+    }
+
+    HlsSegment segment = m_downloadQueue.dequeue();
+
+    QNetworkRequest request{QUrl(segment.url)};
+    request.setTransferTimeout(REQUEST_TIMEOUT_MS);
+
+    m_segmentReply = m_networkManager->get(request);
+    m_segmentReply->setProperty("durationMs", segment.durationMs);
+    connect(m_segmentReply, &QNetworkReply::finished, this, &RecordingWorker::onSegmentReceived);
+}
+
+void RecordingWorker::onSegmentReceived()
+{
+    QNetworkReply *reply = qobject_cast<QNetworkReply*>(sender());
+    if (!reply) return;
+
+    reply->deleteLater();
+    if (reply != m_segmentReply) {
+        return;
+    }
+    m_segmentReply = nullptr;
+
+    if (reply->error() != QNetworkReply::NoError) {
+        // A missing segment is a short skip in the file, not a failed recording
+        WARN_STREAM("Recorder: segment failed:" << reply->errorString());
+        downloadNext();
+        return;
+    }
+
+    if (!m_writer.append(reply->readAll())) {
+        emit error("Recording stopped: " + m_writer.errorString());
+        stop();
+        return;
+    }
+
+    m_recordedMs += reply->property("durationMs").toLongLong();
+    emit progress(m_writer.bytesWritten(), m_recordedMs);
+
+    downloadNext();
+}
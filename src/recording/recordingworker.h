@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RECORDINGWORKER_H
+#define RECORDINGWORKER_H
+
+#include <QObject>
+#include <QQueue>
+#include <QTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include "tsfilewriter.h"
+#include "../player/hlsplaylist.h"
+
+/**
+ * RecordingWorker - Follows a live media playlist and appends segments
+ *
+ * Lives on the recorder's I/O thread (see StreamRecorder). Network
+ * access and file writes both happen there, so nothing it does touches
+ * the GUI thread or the player's network manager.
+ */
+class RecordingWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RecordingWorker(QObject *parent = nullptr);
+    ~RecordingWorker();
+
+public slots:
+    void start(const QString &playlistUrl, const QString &outputPath);
+    void stop();
+
+signals:
+    void started(const QString &outputPath);
+    void progress(qint64 bytesWritten, qint64 recordedMs);
+    void finished(const QString &outputPath, qint64 bytesWritten);
+    void error(const QString &message);
+
+private slots:
+    void pollPlaylist();
+    void onPlaylistReceived();
+    void onSegmentReceived();
+
+private:
+    QNetworkAccessManager *m_networkManager;
+    QTimer *m_pollTimer;
+    QNetworkReply *m_playlistReply;
+    QNetworkReply *m_segmentReply;
+
+    TsFileWriter m_writer;
+    QString m_playlistUrl;
+    QString m_outputPath;
+
+    QQueue<HlsSegment> m_downloadQueue;
+    qint64 m_lastQueuedSequence;
+    qint64 m_recordedMs;
+    int m_failures;
+    bool m_streamEnded;
+
+    static const int MAX_FAILURES = 5;
+    static const int REQUEST_TIMEOUT_MS = 15000;
+
+    void downloadNext();
+    void finish();
+};
+
+#endif // RECORDINGWORKER_H
@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "streamrecorder.h"
+#include "recordingworker.h"
+#include "../../twitchstreamfetcher.h"
+#include "../core/logging.h"
+#include <QStandardPaths>
+#include <QDateTime>
+#include <QDir>
+#include <QCoreApplication>
+
+StreamRecorder::StreamRecorder(QObject *parent)
+    : QObject(parent)
+    , m_fetcher(nullptr)
+    , m_worker(new RecordingWorker())
+    , m_resolving(false)
+    , m_bytesWritten(0)
+    , m_recordedMs(0)
+{
+    m_ioThread.setObjectName("StreamRecorderIO");
+    m_worker->moveToThread(&m_ioThread);
+    connect(&m_ioThread, &QThread::finished, m_worker, &QObject::deleteLater);
+
+    // Cross-thread: all queued
+    connect(this, &StreamRecorder::startWorker, m_worker, &RecordingWorker::start);
+    connect(this, &StreamRecorder::stopWorker, m_worker, &RecordingWorker::stop);
+    connect(m_worker, &RecordingWorker::progress, this, &StreamRecorder::onWorkerProgress);
+    connect(m_worker, &RecordingWorker::finished, this, &StreamRecorder::onWorkerFinished);
+    connect(m_worker, &RecordingWorker::error, this, &StreamRecorder::onWorkerError);
+
+    m_ioThread.start(QThread::LowPriority);
+
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &StreamRecorder::shutdown);
+}
+
+StreamRecorder::~StreamRecorder()
+{
+    shutdown();
+}
+
+void StreamRecorder::shutdown()
+{
+    if (!m_ioThread.isRunning()) {
+        return;
+    }
+
+    // Make sure the file is flushed and truncated before exit
+    QMetaObject::invokeMethod(m_worker, "stop", Qt::BlockingQueuedConnection);
+    m_ioThread.quit();
+    m_ioThread.wait();
+}
+
+void StreamRecorder::setStreamFetcher(TwitchStreamFetcher *fetcher)
+{
+    m_fetcher = fetcher;
+    connect(m_fetcher, &TwitchStreamFetcher::streamUrlReady, this, &StreamRecorder::onStreamUrlReady);
+    connect(m_fetcher, &TwitchStreamFetcher::error, this, &StreamRecorder::onFetcherError);
+}
+
+void StreamRecorder::startRecording(const QString &channelName, const QString &quality)
+{
+    if (!m_fetcher || channelName.isEmpty()) {
+        return;
+    }
+
+    if (isRecording()) {
+        stopRecording();
+    }
+
+    LOG_STREAM("Starting recording of" << channelName);
+
+    m_channel = channelName;
+    m_resolving = true;
+    m_bytesWritten = 0;
+    m_recordedMs = 0;
+    emit recordingChanged();
+    emit progressChanged();
+
+    m_fetcher->fetchStreamUrl(channelName, quality);
+}
+
+void StreamRecorder::stopRecording()
+{
+    if (!isRecording()) {
+        return;
+    }
+
+    if (!m_resolving) {
+        emit stopWorker();
+    }
+    reset();
+}
+
+void StreamRecorder::reset()
+{
+    m_channel.clear();
+    m_resolving = false;
+    emit recordingChanged();
+}
+
+QString StreamRecorder::outputPathFor(const QString &channelName) const
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/recordings";
+    QDir().mkpath(dir);
+
+    QString stamp = QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss");
+    return QString("%1/%2-%3.ts").arg(dir, channelName, stamp);
+}
+
+// ========================================
+// FETCHER / WORKER EVENTS
+// ========================================
+
+void StreamRecorder::onStreamUrlReady(const QString &url, const QString &channelName)
+{
+    if (!m_resolving || channelName != m_channel) {
+        return;
+    }
+
+    m_resolving = false;
+    m_lastPath = outputPathFor(channelName);
+    emit recordingChanged();
+
+    emit startWorker(url, m_lastPath);
+}
+
+void StreamRecorder::onFetcherError(const QString &message)
+{
+    if (!m_resolving) {
+        return;
+    }
+
+    WARN_STREAM("Recorder: cannot resolve stream:" << message);
+    reset();
+    emit error(message);
+}
+
+void StreamRecorder::onWorkerProgress(qint64 bytesWritten, qint64 recordedMs)
+{
+    m_bytesWritten = bytesWritten;
+    m_recordedMs = recordedMs;
+    emit progressChanged();
+}
+
+void StreamRecorder::onWorkerFinished(const QString &outputPath, qint64 bytesWritten)
+{
+    m_bytesWritten = bytesWritten;
+    emit progressChanged();
+    emit recordingFinished(outputPath, bytesWritten);
+
+    // Stream ended on its own (not a stop we already handled)
+    if (isRecording() && !m_resolving && outputPath == m_lastPath) {
+        reset();
+    }
+}
+
+void StreamRecorder::onWorkerError(const QString &message)
+{
+    reset();
+    emit error(message);
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STREAMRECORDER_H
+#define STREAMRECORDER_H
+
+#include <QObject>
+#include <QString>
+#include <QThread>
+
+class TwitchStreamFetcher;
+class RecordingWorker;
+
+/**
+ * StreamRecorder - Records a live channel to a .ts file
+ *
+ * Purpose: Save a stream to disk as-is (no re-encoding) while the user
+ * keeps watching the same or another channel.
+ *
+ * Features:
+ * - Resolves the channel through its own TwitchStreamFetcher, so starting
+ *   a recording doesn't replace the player's quality list
+ * - Segment download and file writes run on a dedicated I/O thread
+ * - Recordings go to <AppData>/recordings/<channel>-<timestamp>.ts
+ */
+class StreamRecorder : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(bool isRecording READ isRecording NOTIFY recordingChanged)
+    Q_PROPERTY(QString recordingChannel READ recordingChannel NOTIFY recordingChanged)
+    Q_PROPERTY(qint64 bytesWritten READ bytesWritten NOTIFY progressChanged)
+    Q_PROPERTY(qint64 recordedMs READ recordedMs NOTIFY progressChanged)
+    Q_PROPERTY(QString lastRecordingPath READ lastRecordingPath NOTIFY recordingChanged)
+
+public:
+    explicit StreamRecorder(QObject *parent = nullptr);
+    ~StreamRecorder();
+
+    // Dedicated fetcher instance (called from main.cpp)
+    void setStreamFetcher(TwitchStreamFetcher *fetcher);
+
+    bool isRecording() const { return !m_channel.isEmpty(); }
+    QString recordingChannel() const { return m_channel; }
+    qint64 bytesWritten() const { return m_bytesWritten; }
+    qint64 recordedMs() const { return m_recordedMs; }
+    QString lastRecordingPath() const { return m_lastPath; }
+
+    Q_INVOKABLE void startRecording(const QString &channelName, const QString &quality = "best");
+    Q_INVOKABLE void stopRecording();
+
+signals:
+    void recordingChanged();
+    void progressChanged();
+    void recordingFinished(const QString &path, qint64 bytes);
+    void error(const QString &message);
+
+    // Internal: hand work to the I/O thread
+    void startWorker(const QString &playlistUrl, const QString &outputPath);
+    void stopWorker();
+
+private slots:
+    void onStreamUrlReady(const QString &url, const QString &channelName);
+    void onFetcherError(const QString &message);
+    void onWorkerProgress(qint64 bytesWritten, qint64 recordedMs);
+    void onWorkerFinished(const QString &outputPath, qint64 bytesWritten);
+    void onWorkerError(const QString &message);
+    void shutdown();
+
+private:
+    TwitchStreamFetcher *m_fetcher;
+    QThread m_ioThread;
+    RecordingWorker *m_worker;
+
+    QString m_channel;
+    bool m_resolving;
+    qint64 m_bytesWritten;
+    qint64 m_recordedMs;
+    QString m_lastPath;
+
+    QString outputPathFor(const QString &channelName) const;
+    void reset();
+};
+
+#endif // STREAMRECORDER_H
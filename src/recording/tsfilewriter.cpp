@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tsfilewriter.h"
+#include "../core/logging.h"
+#include <fcntl.h>
+#include <cstring>
+
+const int TsFileWriter::WRITE_BUFFER_BYTES;
+const qint64 TsFileWriter::EXTENT_BYTES;
+
+TsFileWriter::TsFileWriter()
+    : m_written(0)
+    , m_allocated(0)
+    , m_canPreallocate(true)
+{
+}
+
+TsFileWriter::~TsFileWriter()
+{
+    close();
+}
+
+bool TsFileWriter::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    // Unbuffered - we do our own (much larger) buffering
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        WARN_STREAM("Recorder: cannot open" << path << "-" << m_file.errorString());
+        return false;
+    }
+
+    m_buffer.reserve(WRITE_BUFFER_BYTES);
+    m_buffer.resize(0);
+    m_written = 0;
+    m_allocated = 0;
+    m_canPreallocate = true;
+
+    return true;
+}
+
+bool TsFileWriter::append(const QByteArray &data)
+{
+    if (!m_file.isOpen()) {
+        return false;
+    }
+
+    if (m_buffer.size() + data.size() > WRITE_BUFFER_BYTES) {
+        if (!flush()) {
+            return false;
+        }
+    }
+
+    // Oversized segment - skip the copy into the buffer
+    if (data.size() >= WRITE_BUFFER_BYTES) {
+        return writeOut(data.constData(), data.size());
+    }
+
+    m_buffer.append(data);
+    return true;
+}
+
+bool TsFileWriter::flush()
+{
+    if (m_buffer.isEmpty()) {
+        return true;
+    }
+
+    bool ok = writeOut(m_buffer.constData(), m_buffer.size());
+    // resize() keeps the reserved capacity, clear() would free it
+    m_buffer.resize(0);
+    return ok;
+}
+
+void TsFileWriter::close()
+{
+    if (!m_file.isOpen()) {
+        return;
+    }
+
+    flush();
+
+    // Drop the preallocated tail past the last written byte
+    if (m_allocated > m_written) {
+        m_file.resize(m_written);
+    }
+
+    m_file.close();
+    m_allocated = 0;
+}
+
+bool TsFileWriter::writeOut(const char *data, qint64 size)
+{
+    reserve(m_written + size);
+
+    qint64 done = 0;
+    while (done < size) {
+        qint64 n = m_file.write(data + done, size - done);
+        if (n <= 0) {
+            WARN_STREAM("Recorder: write failed -" << m_file.errorString());
+            return false;
+        }
+        done += n;
+    }
+
+    m_written += size;
+    return true;
+}
+
+void TsFileWriter::reserve(qint64 end)
+{
+    if (!m_canPreallocate || end <= m_allocated) {
+        return;
+    }
+
+    qint64 target = ((end + EXTENT_BYTES - 1) / EXTENT_BYTES) * EXTENT_BYTES;
+    int result = posix_fallocate(m_file.handle(), m_allocated, target - m_allocated);
+
+    if (result != 0) {
+        // Not supported on every filesystem - plain appends still work
+        WARN_STREAM("Recorder: preallocation unavailable -" << strerror(result));
+        m_canPreallocate = false;
+        return;
+    }
+
+    m_allocated = target;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TSFILEWRITER_H
+#define TSFILEWRITER_H
+
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+
+/**
+ * Append-only writer for MPEG-TS recordings
+ *
+ * Segments are collected in a 4 MB buffer and written in one go, so the
+ * disk sees a few large sequential writes instead of one per segment.
+ * File space is reserved ahead in 64 MB extents (posix_fallocate) to keep
+ * the recording contiguous; the unused tail is cut off on close().
+ */
+class TsFileWriter
+{
+public:
+    TsFileWriter();
+    ~TsFileWriter();
+
+    bool open(const QString &path);
+    bool append(const QByteArray &data);
+    bool flush();
+    void close();
+
+    bool isOpen() const { return m_file.isOpen(); }
+    qint64 bytesWritten() const { return m_written + m_buffer.size(); }
+    QString errorString() const { return m_file.errorString(); }
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;
+    qint64 m_written;       // Bytes on disk
+    qint64 m_allocated;     // Bytes reserved with posix_fallocate
+    bool m_canPreallocate;
+
+    static const int WRITE_BUFFER_BYTES = 4 * 1024 * 1024;
+    static const qint64 EXTENT_BYTES = 64LL * 1024 * 1024;
+
+    bool writeOut(const char *data, qint64 size);
+    void reserve(qint64 end);
+};
+
+#endif // TSFILEWRITER_H
@@ -0,0 +1,192 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include "../src/player/codecsupport.h"
+#include "../src/player/hlsplaylist.h"
+
+// Usher master playlist offering 720p60 in three codecs. Only 160p is
+// used where the pixel rate budget matters: it fits the AV1 budget even
+// on a single core, so results don't depend on the test machine.
+static const char *MASTER_PLAYLIST =
+    "#EXTM3U\n"
+    "#EXT-X-STREAM-INF:BANDWIDTH=6000000,RESOLUTION=1280x720,CODECS=\"avc1.4D401F,mp4a.40.2\",VIDEO=\"720p60\",FRAME-RATE=60.000\n"
+    "https://video.example/720p60-h264.m3u8\n"
+    "#EXT-X-STREAM-INF:BANDWIDTH=4000000,RESOLUTION=1280x720,CODECS=\"hvc1.1.2.L93.B0,mp4a.40.2\",VIDEO=\"720p60\",FRAME-RATE=60.000\n"
+    "https://video.example/720p60-hevc.m3u8\n"
+    "#EXT-X-STREAM-INF:BANDWIDTH=3000000,RESOLUTION=1280x720,CODECS=\"av01.0.08M.08,mp4a.40.2\",VIDEO=\"720p60\",FRAME-RATE=60.000\n"
+    "https://video.example/720p60-av1.m3u8\n"
+    "#EXT-X-STREAM-INF:BANDWIDTH=3000000,RESOLUTION=1280x720,CODECS=\"avc1.4D401F,mp4a.40.2\",VIDEO=\"720p30\",FRAME-RATE=30.000\n"
+    "https://video.example/720p30.m3u8\n"
+    "#EXT-X-STREAM-INF:BANDWIDTH=230000,RESOLUTION=284x160,CODECS=\"avc1.4D401F,mp4a.40.2\",VIDEO=\"160p30\",FRAME-RATE=30.000\n"
+    "https://video.example/160p30-h264.m3u8\n"
+    "#EXT-X-STREAM-INF:BANDWIDTH=160000,RESOLUTION=284x160,CODECS=\"av01.0.04M.08,mp4a.40.2\",VIDEO=\"160p30\",FRAME-RATE=30.000\n"
+    "https://video.example/160p30-av1.m3u8\n"
+    "#EXT-X-STREAM-INF:BANDWIDTH=160000,CODECS=\"mp4a.40.2\",VIDEO=\"audio_only\"\n"
+    "https://video.example/audio_only.m3u8\n";
+
+class TestCodecSupport : public QObject
+{
+    Q_OBJECT
+
+private:
+    static CodecSupport withCodecs(const char *codecs)
+    {
+        qputenv("TWITCHVIEWER_CODECS", codecs);
+        return CodecSupport::detect();
+    }
+
+    static HlsVariant variant(const QString &codecs, int width, int height, double frameRate = 30.0)
+    {
+        HlsVariant v;
+        v.groupId = QString("%1p").arg(height);
+        v.codecs = codecs;
+        v.width = width;
+        v.height = height;
+        v.frameRate = frameRate;
+        return v;
+    }
+
+    static QString chooseUrl(const CodecSupport &support, const QVector<HlsVariant> &variants,
+                             const QString &groupId)
+    {
+        const HlsVariant *chosen = support.choose(variants, groupId);
+        return chosen ? chosen->url : QString();
+    }
+
+private slots:
+    void cleanup()
+    {
+        qunsetenv("TWITCHVIEWER_CODECS");
+    }
+
+    void videoCodec_data()
+    {
+        QTest::addColumn<QString>("codecs");
+        QTest::addColumn<int>("expected");
+
+        QTest::newRow("none means h264") << "" << int(CodecSupport::H264);
+        QTest::newRow("avc1") << "avc1.64002A,mp4a.40.2" << int(CodecSupport::H264);
+        QTest::newRow("hvc1") << "mp4a.40.2,hvc1.1.2.L93.B0" << int(CodecSupport::HEVC);
+        QTest::newRow("hev1") << "hev1.1.6.L120.90" << int(CodecSupport::HEVC);
+        QTest::newRow("av01") << "AV01.0.08M.08" << int(CodecSupport::AV1);
+        QTest::newRow("audio only") << "mp4a.40.2" << int(CodecSupport::UnknownCodec);
+    }
+
+    void videoCodec()
+    {
+        QFETCH(QString, codecs);
+        QFETCH(int, expected);
+
+        HlsVariant v;
+        v.codecs = codecs;
+        QCOMPARE(int(CodecSupport::videoCodec(v)), expected);
+    }
+
+    void environmentOverride()
+    {
+        CodecSupport support = withCodecs("av1,h264");
+        QVERIFY(support.canDecode(CodecSupport::AV1));
+        QVERIFY(!support.canDecode(CodecSupport::HEVC));
+        QVERIFY(support.canDecode(CodecSupport::H264));
+        QCOMPARE(support.usherCodecList(), QString("av1,h264"));
+    }
+
+    void isBetterPrefersEfficientCodec()
+    {
+        CodecSupport support = withCodecs("av1,hevc,h264");
+        HlsVariant h264 = variant("avc1.4D401F", 284, 160);
+        HlsVariant hevc = variant("hvc1.1.2.L93.B0", 284, 160);
+        HlsVariant av1 = variant("av01.0.04M.08", 284, 160);
+
+        QVERIFY(support.isBetter(hevc, h264));
+        QVERIFY(support.isBetter(av1, hevc));
+        QVERIFY(support.isBetter(av1, h264));
+        QVERIFY(!support.isBetter(h264, av1));
+        QVERIFY(!support.isBetter(h264, h264));
+    }
+
+    void isBetterPrefersPlayable()
+    {
+        CodecSupport support = withCodecs("h264");
+        HlsVariant h264 = variant("avc1.4D401F", 1280, 720, 60);
+        HlsVariant av1 = variant("av01.0.08M.08", 1280, 720, 60);
+
+        QVERIFY(!support.isPlayable(av1));
+        QVERIFY(support.isBetter(h264, av1));
+        QVERIFY(!support.isBetter(av1, h264));
+    }
+
+    void isPlayable()
+    {
+        CodecSupport support = withCodecs("h264");
+        QVERIFY(support.isPlayable(variant("avc1.4D401F", 1920, 1080, 60)));
+        QVERIFY(!support.isPlayable(variant("hvc1.1.2.L93.B0", 284, 160)));
+
+        HlsVariant audio;
+        audio.groupId = "audio_only";
+        audio.codecs = "mp4a.40.2";
+        QVERIFY(support.isPlayable(audio));
+    }
+
+    void variantChoice()
+    {
+        QVector<HlsVariant> variants = HlsPlaylist::parseMaster(MASTER_PLAYLIST);
+        QCOMPARE(variants.size(), 7);
+
+        // Only H.264 decodes: the H.264 rendition of every slot
+        CodecSupport h264Only = withCodecs("h264");
+        QCOMPARE(chooseUrl(h264Only, variants, "720p60"), QString("https://video.example/720p60-h264.m3u8"));
+        QCOMPARE(chooseUrl(h264Only, variants, "160p30"), QString("https://video.example/160p30-h264.m3u8"));
+
+        // AV1 decodes and 160p fits the budget: AV1 wins the slot
+        CodecSupport av1 = withCodecs("av1,h264");
+        QCOMPARE(chooseUrl(av1, variants, "160p30"), QString("https://video.example/160p30-av1.m3u8"));
+        QCOMPARE(chooseUrl(av1, variants, "720p30"), QString("https://video.example/720p30.m3u8"));
+        QCOMPARE(chooseUrl(av1, variants, "audio_only"), QString("https://video.example/audio_only.m3u8"));
+    }
+
+    void chooseWithoutPlayableVariant()
+    {
+        CodecSupport h264Only = withCodecs("h264");
+        QVector<HlsVariant> variants{variant("av01.0.08M.08", 1280, 720, 60),
+                                     variant("hvc1.1.2.L93.B0", 1280, 720, 60)};
+        QVERIFY(!h264Only.choose(variants, "720p"));
+        QVERIFY(!h264Only.choose(variants, "1080p"));
+    }
+
+    void smallestCoveringKeepsFrameRates()
+    {
+        QVector<HlsVariant> variants = HlsPlaylist::parseMaster(MASTER_PLAYLIST);
+
+        // 720p30 and 720p60 are separate variants; the cheaper one covers
+        int index = HlsPlaylist::smallestCovering(variants, 1280, 720);
+        QVERIFY(index >= 0);
+        QCOMPARE(variants[index].groupId, QString("720p30"));
+
+        // A mini player surface is covered by 720p, not by 160p
+        index = HlsPlaylist::smallestCovering(variants, 640, 360);
+        QCOMPARE(variants[index].height, 720);
+        QCOMPARE(variants[index].frameRate, 30.0);
+
+        // Nothing covers 4K: the largest below, never audio only
+        index = HlsPlaylist::smallestCovering(variants, 3840, 2160);
+        QCOMPARE(variants[index].height, 720);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestCodecSupport)
+#include "tst_codecsupport.moc"
@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QWebSocket>
+#include <QWebSocketServer>
+#include "../src/api/eventsubclient.h"
+#include "../src/api/helixlookupaggregator.h"
+
+/**
+ * Local stand-in for the EventSub WebSocket and the Helix subscriptions
+ * endpoint. Messages come from a recorded session
+ * (data/eventsub_session.jsonl); the client is pointed here through
+ * TWITCHVIEWER_EVENTSUB_WS and TWITCHVIEWER_EVENTSUB_API.
+ */
+class EventSubStandIn : public QObject
+{
+    Q_OBJECT
+
+public:
+    QWebSocketServer ws{QStringLiteral("eventsub"), QWebSocketServer::NonSecureMode};
+    QTcpServer http;
+    QList<QWebSocket*> sockets;
+    QList<QJsonObject> subscriptions;
+    int subscriptionStatus = 202;
+
+    bool start()
+    {
+        if (!ws.listen(QHostAddress::LocalHost) || !http.listen(QHostAddress::LocalHost)) {
+            return false;
+        }
+        connect(&ws, &QWebSocketServer::newConnection, this, [this]() {
+            while (QWebSocket *socket = ws.nextPendingConnection()) {
+                sockets.append(socket);
+            }
+        });
+        connect(&http, &QTcpServer::newConnection, this, &EventSubStandIn::onHttpConnection);
+        return true;
+    }
+
+    QString wsUrl(const QString &path) const
+    {
+        return QString("ws://127.0.0.1:%1%2").arg(ws.serverPort()).arg(path);
+    }
+
+    QString apiUrl() const
+    {
+        return QString("http://127.0.0.1:%1/helix/eventsub/subscriptions").arg(http.serverPort());
+    }
+
+private slots:
+    void onHttpConnection()
+    {
+        while (QTcpSocket *socket = http.nextPendingConnection()) {
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+                QByteArray request = socket->property("buffer").toByteArray() + socket->readAll();
+                socket->setProperty("buffer", request);
+
+                int headerEnd = request.indexOf("\r\n\r\n");
+                if (headerEnd < 0) {
+                    return;
+                }
+                QByteArray headers = request.left(headerEnd).toLower();
+                int lengthAt = headers.indexOf("content-length:");
+                int length = lengthAt < 0 ? 0
+                    : headers.mid(lengthAt + 15, headers.indexOf("\r\n", lengthAt) - lengthAt - 15).trimmed().toInt();
+                if (request.size() < headerEnd + 4 + length) {
+                    return;
+                }
+
+                subscriptions.append(QJsonDocument::fromJson(request.mid(headerEnd + 4, length)).object());
+                QByteArray body = subscriptionStatus == 202 ? "{\"data\":[]}" : "{\"error\":\"Forbidden\"}";
+                socket->write(QString("HTTP/1.1 %1 %2\r\nContent-Type: application/json\r\n"
+                                      "Content-Length: %3\r\nConnection: close\r\n\r\n")
+                              .arg(subscriptionStatus)
+                              .arg(subscriptionStatus == 202 ? "Accepted" : "Forbidden")
+                              .arg(body.size()).toUtf8() + body);
+                socket->disconnectFromHost();
+            });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    }
+};
+
+class TestEventSubClient : public QObject
+{
+    Q_OBJECT
+
+private:
+    QHash<QString, QString> m_messages;
+
+    QString message(const QString &step, const EventSubStandIn &standIn) const
+    {
+        QString text = m_messages.value(step);
+        return text.replace("@RECONNECT_URL@", standIn.wsUrl("/reconnect"));
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QFile fixture(QFINDTESTDATA("data/eventsub_session.jsonl"));
+        QVERIFY(fixture.open(QIODevice::ReadOnly));
+        while (!fixture.atEnd()) {
+            QJsonObject line = QJsonDocument::fromJson(fixture.readLine()).object();
+            if (!line.isEmpty()) {
+                m_messages.insert(line["step"].toString(),
+                                  QJsonDocument(line["message"].toObject()).toJson(QJsonDocument::Compact));
+            }
+        }
+        QCOMPARE(m_messages.size(), 6);
+    }
+
+    void replayedSession()
+    {
+        EventSubStandIn standIn;
+        QVERIFY(standIn.start());
+        qputenv("TWITCHVIEWER_EVENTSUB_WS", standIn.wsUrl("/ws").toUtf8());
+        qputenv("TWITCHVIEWER_EVENTSUB_API", standIn.apiUrl().toUtf8());
+
+        HelixLookupAggregator lookup;
+        EventSubClient client(&lookup);
+        QSignalSpy offline(&client, &EventSubClient::wentOffline);
+        client.setAuthToken("token");
+        client.setChannels({"1337", "4242"});
+
+        // Welcome: session active, online + offline subscription per channel
+        QTRY_COMPARE(standIn.sockets.size(), 1);
+        standIn.sockets[0]->sendTextMessage(message("welcome", standIn));
+        QTRY_VERIFY(client.isActive());
+        QTRY_COMPARE(standIn.subscriptions.size(), 4);
+        for (const QJsonObject &subscription : qAsConst(standIn.subscriptions)) {
+            QCOMPARE(subscription["transport"].toObject()["session_id"].toString(),
+                     QString("AQoQILE98gtqShGmLD7AM6yJThAB"));
+        }
+        QCOMPARE(standIn.subscriptions[0]["type"].toString(), QString("stream.online"));
+        QCOMPARE(standIn.subscriptions[1]["type"].toString(), QString("stream.offline"));
+
+        // Keepalive, then the same notification delivered twice
+        standIn.sockets[0]->sendTextMessage(message("keepalive", standIn));
+        standIn.sockets[0]->sendTextMessage(message("offline", standIn));
+        standIn.sockets[0]->sendTextMessage(message("offline", standIn));
+        QTRY_COMPARE(offline.size(), 1);
+        QTest::qWait(100);
+        QCOMPARE(offline.size(), 1);
+        QCOMPARE(offline[0][0].toStringList(), QStringList{"1337"});
+        QVERIFY(client.isActive());
+
+        // session_reconnect: the new socket takes over once welcomed,
+        // subscriptions move with the session
+        standIn.sockets[0]->sendTextMessage(message("reconnect", standIn));
+        QTRY_COMPARE(standIn.sockets.size(), 2);
+        QVERIFY(client.isActive());
+        standIn.sockets[1]->sendTextMessage(message("welcome-reconnected", standIn));
+        QTRY_COMPARE(standIn.sockets[0]->state(), QAbstractSocket::UnconnectedState);
+        QVERIFY(client.isActive());
+
+        standIn.sockets[1]->sendTextMessage(message("offline-after-reconnect", standIn));
+        QTRY_COMPARE(offline.size(), 2);
+        QCOMPARE(offline[1][0].toStringList(), QStringList{"4242"});
+        QCOMPARE(standIn.subscriptions.size(), 4);
+    }
+
+    void unauthorizedSubscriptionsRetryWithNewToken()
+    {
+        EventSubStandIn standIn;
+        QVERIFY(standIn.start());
+        qputenv("TWITCHVIEWER_EVENTSUB_WS", standIn.wsUrl("/ws").toUtf8());
+        qputenv("TWITCHVIEWER_EVENTSUB_API", standIn.apiUrl().toUtf8());
+        standIn.subscriptionStatus = 403;
+
+        HelixLookupAggregator lookup;
+        EventSubClient client(&lookup);
+        client.setAuthToken("expired");
+        client.setChannels({"1337", "4242"});
+
+        QTRY_COMPARE(standIn.sockets.size(), 1);
+        standIn.sockets[0]->sendTextMessage(message("welcome", standIn));
+
+        // The first 403 stops the queue
+        QTRY_COMPARE(standIn.subscriptions.size(), 1);
+        QTest::qWait(200);
+        QCOMPARE(standIn.subscriptions.size(), 1);
+
+        // A new token subscribes every channel again, on the same session
+        standIn.subscriptionStatus = 202;
+        client.setAuthToken("refreshed");
+        QTRY_COMPARE(standIn.subscriptions.size(), 5);
+        QCOMPARE(standIn.sockets.size(), 1);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestEventSubClient)
+#include "tst_eventsubclient.moc"
@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2025  Dominic Bussemas
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * twitchviewer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QtTest>
+#include "../src/api/responseparser.h"
+#include "../src/core/parseworker.h"
+
+// GUI thread time per 100-stream response: parsed inline (the old way)
+// against handed to ParseWorker, where only the dispatch and done() are
+// left on the GUI thread. Run with -median to steady the numbers.
+class TestParseWorker : public QObject
+{
+    Q_OBJECT
+
+private:
+    static const int WORKER_ROUNDS = 50;
+
+    static QByteArray body(const QString &name)
+    {
+        QFile file(QFINDTESTDATA("data/" + name));
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    static StreamsResult parse(bool gql, const QByteArray &data)
+    {
+        return gql ? ResponseParser::gqlGameStreams(data) : ResponseParser::helixStreams(data);
+    }
+
+    static void addBodies()
+    {
+        QTest::addColumn<bool>("gql");
+        QTest::addColumn<QByteArray>("data");
+
+        QTest::newRow("helix /streams") << false << body("helix_streams_100.json");
+        QTest::newRow("gql GameStreams") << true << body("gql_game_streams_100.json");
+    }
+
+private slots:
+    void parseInline_data() { addBodies(); }
+
+    void parseInline()
+    {
+        QFETCH(bool, gql);
+        QFETCH(QByteArray, data);
+        QVERIFY(!data.isEmpty());
+
+        int rows = 0;
+        QBENCHMARK {
+            rows = parse(gql, data).streams.size();
+        }
+        QCOMPARE(rows, 100);
+    }
+
+    void parseOnWorker_data() { addBodies(); }
+
+    void parseOnWorker()
+    {
+        QFETCH(bool, gql);
+        QFETCH(QByteArray, data);
+        QVERIFY(!data.isEmpty());
+
+        qint64 guiNs = 0;
+        for (int round = 0; round < WORKER_ROUNDS; ++round) {
+            QEventLoop loop;
+            int rows = 0;
+            QElapsedTimer dispatch;
+            dispatch.start();
+            ParseWorker::run(this,
+                [gql, data]() { return parse(gql, data); },
+                [&](const StreamsResult &result) {
+                    QElapsedTimer done;
+                    done.start();
+                    rows = result.streams.size();
+                    guiNs += done.nsecsElapsed();
+                    loop.quit();
+                });
+            guiNs += dispatch.nsecsElapsed();
+
+            QTimer::singleShot(5000, &loop, &QEventLoop::quit);
+            loop.exec();
+            QCOMPARE(rows, 100);
+        }
+
+        QTest::setBenchmarkResult(guiNs / WORKER_ROUNDS / 1000000.0, QTest::WalltimeMilliseconds);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestParseWorker)
+#include "tst_parseworker.moc"
@@ -23,15 +23,15 @@
  #include <QUrl>
   #include <QStandardPaths>
  #include <QDir>
+#include <QSharedPointer>
  #include "src/network/networkmanager.h" 
+#include "src/api/gqloperations.h"
  
  // Twitch API Constants
  const QString TwitchStreamFetcher::TWITCH_GQL_URL = "https://gql.twitch.tv/gql";
  const QString TwitchStreamFetcher::TWITCH_INTEGRITY_URL = "https://gql.twitch.tv/integrity";
  const QString TwitchStreamFetcher::TWITCH_USHER_URL = "https://usher.ttvnw.net/api/channel/hls/%1.m3u8";
- const QString TwitchStreamFetcher::PERSISTED_QUERY_HASH = "0828119ded1c13477966434e15800ff57ddacf13ba1911c129dc2200705b0712";
- const QString TwitchStreamFetcher::PERSISTED_QUERY_HASH_USER = "3cff634f43c5c78830907a662b315b1847cfc0dce32e6a9752e7f5d70b37f8c0";
- const QString TwitchStreamFetcher::PERSISTED_QUERY_HASH_CATEGORIES = "2f67f71ba89f3c0ed26a141ec00da1defecb2303595f5cda4298169549783d9e";
+const QString TwitchStreamFetcher::TWITCH_USHER_VOD_URL = "https://usher.ttvnw.net/vod/%1.m3u8";
  
  TwitchStreamFetcher::TwitchStreamFetcher(QObject *parent)
      : QObject(parent)
@@ -39,6 +39,7 @@
      , m_networkManager(new QNetworkAccessManager(this))
      , m_authManager(nullptr)
      , m_isValidatingToken(false)
+     , m_codecsDetected(false)
      , m_debugShowAds("N/A")
      , m_debugHideAds("N/A")
      , m_debugPrivileged("N/A")
@@ -159,6 +160,7 @@ void TwitchStreamFetcher::clearGraphQLToken()
  {
       
      m_currentChannel = channelName;
+     m_currentVodId.clear();
      m_requestedQuality = quality;
      m_isValidatingToken = false;
      
@@ -167,6 +169,19 @@ void TwitchStreamFetcher::clearGraphQLToken()
      // Try without client-integrity first
      requestPlaybackToken(channelName, false);
  }
+
+void TwitchStreamFetcher::fetchVodUrl(const QString &vodId, const QString &quality)
+{
+    // Same token -> usher flow as live, keyed by video ID instead of login
+    m_currentChannel.clear();
+    m_currentVodId = vodId;
+    m_requestedQuality = quality;
+    m_isValidatingToken = false;
+
+    emit statusUpdate("Connecting to Twitch...");
+
+    requestPlaybackToken(QString(), false);
+}
  
  void TwitchStreamFetcher::requestPlaybackToken(const QString &channelName, bool withIntegrity)
  {
@@ -197,27 +212,14 @@ void TwitchStreamFetcher::clearGraphQLToken()
      }
      
      // Build GraphQL query
-     QJsonObject variables;
-     variables["isLive"] = true;
-     variables["login"] = channelName;
-     variables["isVod"] = false;
-     variables["vodID"] = "";
-     variables["playerType"] = "site";
-     
-     QJsonObject persistedQuery;
-     persistedQuery["version"] = 1;
-     persistedQuery["sha256Hash"] = PERSISTED_QUERY_HASH;
-     
-     QJsonObject extensions;
-     extensions["persistedQuery"] = persistedQuery;
-     
-     QJsonObject payload;
-     payload["operationName"] = "PlaybackAccessToken";
-     payload["variables"] = variables;
-     payload["extensions"] = extensions;
-     
-     QJsonDocument doc(payload);
-     QByteArray data = doc.toJson(QJsonDocument::Compact);
+     bool isVod = !m_currentVodId.isEmpty();
+
+     QByteArray data = GqlOperations::payload(GqlOperations::PlaybackAccessToken, {
+         GqlOperations::boolean(!isVod),
+         GqlOperations::string(isVod ? QString() : channelName),
+         GqlOperations::boolean(isVod),
+         GqlOperations::string(isVod ? m_currentVodId : QString())
+     });
      
         
      QNetworkReply *reply = m_networkManager->post(request, data);
@@ -394,10 +396,15 @@ void TwitchStreamFetcher::clearGraphQLToken()
      
      // Extract token and signature
      QJsonObject data = root["data"].toObject();
-     QJsonObject streamPlaybackAccessToken = data["streamPlaybackAccessToken"].toObject();
+     bool isVod = !m_currentVodId.isEmpty();
+     QJsonObject streamPlaybackAccessToken = data[isVod ? "videoPlaybackAccessToken" : "streamPlaybackAccessToken"].toObject();
      
      if (streamPlaybackAccessToken.isEmpty()) {
-         emit error("Channel not found or not live: " + m_currentChannel);
+         if (isVod) {
+             emit error("Video not found or not available: " + m_currentVodId);
+         } else {
+             emit error("Channel not found or not live: " + m_currentChannel);
+         }
          return;
      }
      
@@ -575,7 +582,8 @@ void TwitchStreamFetcher::parseDebugInfo(const QString &tokenValue)
  void TwitchStreamFetcher::requestPlaylist(const QString &token, const QString &signature, const QString &channelName)
  {
      // Build usher URL
-     QString usherUrl = TWITCH_USHER_URL.arg(channelName);
+     QString usherUrl = m_currentVodId.isEmpty() ? TWITCH_USHER_URL.arg(channelName)
+                                                 : TWITCH_USHER_VOD_URL.arg(m_currentVodId);
      
      QUrlQuery query;
      query.addQueryItem("client_id", Config::TWITCH_PUBLIC_CLIENT_ID);
@@ -588,6 +596,13 @@ void TwitchStreamFetcher::parseDebugInfo(const QString &tokenValue)
      query.addQueryItem("playlist_include_framerate", "true");
      query.addQueryItem("fast_bread", "true");
      
+     // Advertise what we can decode so usher also offers HEVC/AV1 variants
+     if (!m_codecsDetected) {
+         m_codecSupport = CodecSupport::detect();
+         m_codecsDetected = true;
+     }
+     query.addQueryItem("supported_codecs", m_codecSupport.usherCodecList());
+     
      QUrl url(usherUrl);
      url.setQuery(query);
      
@@ -627,51 +642,51 @@ void TwitchStreamFetcher::parseDebugInfo(const QString &tokenValue)
      }
 
      emit statusUpdate("Stream ready!");
+     if (!m_currentVodId.isEmpty()) {
+         emit vodUrlReady(streamUrl, m_currentVodId);
+         return;
+     }
     emit streamUrlReady(streamUrl, m_currentChannel);
  }
 
 QString TwitchStreamFetcher::parseM3U8Playlist(const QString &m3u8Content, const QString &quality)
 {
-    QStringList lines = m3u8Content.split('\n');
+    QVector<HlsVariant> variants;
+    QStringList groups;
+    for (const HlsVariant &variant : HlsPlaylist::parseMaster(m3u8Content)) {
+        if (!variant.url.startsWith("http")) {
+            continue;
+        }
+        variants.append(variant);
+        if (!groups.contains(variant.groupId)) {
+            groups.append(variant.groupId);
+        }
+    }
     
     // Clear previous cache
     m_qualityUrls.clear();
+    m_qualityVariants.clear();
     m_availableQualities.clear();
     
-    // Parse ALL qualities from playlist
-    for (int i = 0; i < lines.size(); i++) {
-        QString line = lines[i].trimmed();
+    // Same quality offered in several codecs - keep the most efficient
+    // one we can decode within budget
+    for (const QString &group : groups) {
+        const HlsVariant *variant = m_codecSupport.choose(variants, group);
+        if (!variant) {
+            qDebug() << "  Skipping undecodable quality:" << group;
+            continue;
+        }
         
-        if (line.startsWith("#EXT-X-STREAM-INF")) {
-            // Extract quality name from line
-            QString qualityName = "unknown";
-            
-            // Try to extract resolution
-            if (line.contains("RESOLUTION=1920x1080")) {
-                qualityName = "1080p (Source)";
-            } else if (line.contains("RESOLUTION=1280x720")) {
-                qualityName = "720p (High)";
-            } else if (line.contains("RESOLUTION=852x480") || line.contains("RESOLUTION=640x480")) {
-                qualityName = "480p (Medium)";
-            } else if (line.contains("RESOLUTION=640x360")) {
-                qualityName = "360p (Low)";
-            } else if (line.contains("RESOLUTION=284x160") || line.contains("RESOLUTION=160x")) {
-                qualityName = "160p (Mobile)";
-            } else if (line.contains("audio_only")) {
-                qualityName = "Audio Only";
-            }
-            
-            // Next line should be the URL
-            if (i + 1 < lines.size()) {
-                QString nextLine = lines[i + 1].trimmed();
-                if (nextLine.startsWith("http")) {
-                    m_qualityUrls[qualityName] = nextLine;
-                    m_availableQualities.append(qualityName);
-                    
-                    qDebug() << "  Found quality:" << qualityName;
-                }
-            }
+        QString qualityName = TwitchStreamFetcher::qualityName(*variant);
+        if (m_qualityVariants.contains(qualityName)) {
+            continue;
         }
+        
+        m_qualityUrls[qualityName] = variant->url;
+        m_qualityVariants[qualityName] = *variant;
+        m_availableQualities.append(qualityName);
+        
+        qDebug() << "  Found quality:" << qualityName << variant->codecs;
     }
     
     // Emit signal that qualities are available
@@ -706,6 +721,30 @@ QString TwitchStreamFetcher::parseM3U8Playlist(const QString &m3u8Content, const
     return QString();
 }
 
+QString TwitchStreamFetcher::qualityName(const HlsVariant &variant)
+{
+    if (variant.isAudioOnly()) {
+        return "Audio Only";
+    }
+    
+    // Frame rate is part of the name: 720p60 and 720p30 are different
+    // variants and getQualityForSize() has to tell them apart
+    QString name = QString("%1p").arg(variant.height);
+    int fps = qRound(variant.frameRate);
+    if (fps > 0) {
+        name += QString::number(fps);
+    }
+    
+    switch (variant.height) {
+    case 1080: return name + " (Source)";
+    case 720:  return name + " (High)";
+    case 480:  return name + " (Medium)";
+    case 360:  return name + " (Low)";
+    case 160:  return name + " (Mobile)";
+    default:   return name;
+    }
+}
+
 QString TwitchStreamFetcher::getQualityUrl(const QString &quality) const
 {
     // Try direct match first
@@ -713,7 +752,7 @@ QString TwitchStreamFetcher::getQualityUrl(const QString &quality) const
         return m_qualityUrls[quality];
     }
     
-    // Try fuzzy match (e.g. "720p" matches "720p (High)")
+    // Try fuzzy match (e.g. "720p" matches "720p60 (High)")
     for (const QString &key : m_qualityUrls.keys()) {
         if (key.contains(quality, Qt::CaseInsensitive)) {
             return m_qualityUrls[key];
@@ -723,6 +762,22 @@ QString TwitchStreamFetcher::getQualityUrl(const QString &quality) const
     return QString();
 }
 
+QString TwitchStreamFetcher::getQualityForSize(int width, int height) const
+{
+    QStringList names = m_qualityVariants.keys();
+    QVector<HlsVariant> variants;
+    for (const QString &name : names) {
+        variants.append(m_qualityVariants.value(name));
+    }
+    
+    int index = HlsPlaylist::smallestCovering(variants, width, height);
+    if (index < 0) {
+        return QString();
+    }
+    
+    return names[index];
+}
+
 // ========================================
 // Top Categories (GraphQL - Anonymous)
 // ========================================
@@ -739,46 +794,37 @@ void TwitchStreamFetcher::fetchTopCategoriesGraphQL(int limit)
 
 void TwitchStreamFetcher::requestTopCategories(int limit)
 {
-    QUrl url(TWITCH_GQL_URL);
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
-    
     // CRITICAL: Use public Client-ID, NO auth token (anonymous)
-    request.setRawHeader("Client-ID", Config::TWITCH_PUBLIC_CLIENT_ID.toUtf8());
+    QNetworkRequest request = GqlOperations::anonymousRequest();
     
     // Build GraphQL query for BrowsePage_AllDirectories
-    QJsonObject options;
-    
-    QJsonObject recommendationsContext;
-    recommendationsContext["platform"] = "web";
-    options["recommendationsContext"] = recommendationsContext;
-    
-    options["requestID"] = "JIRA-VXP-2397";
-    options["sort"] = "RELEVANCE";
-    options["tags"] = QJsonArray();
-    
-    QJsonObject variables;
-    variables["limit"] = limit;
-    variables["options"] = options;
-    
-    QJsonObject persistedQuery;
-    persistedQuery["version"] = 1;
-    persistedQuery["sha256Hash"] = PERSISTED_QUERY_HASH_CATEGORIES;
-    
-    QJsonObject extensions;
-    extensions["persistedQuery"] = persistedQuery;
-    
-    QJsonObject payload;
-    payload["operationName"] = "BrowsePage_AllDirectories";
-    payload["variables"] = variables;
-    payload["extensions"] = extensions;
-    
-    QJsonDocument doc(payload);
-    QByteArray data = doc.toJson(QJsonDocument::Compact);
+    QByteArray data = GqlOperations::payload(GqlOperations::BrowsePageAllDirectories,
+                                             {GqlOperations::number(limit)});
     
     
     QNetworkReply *reply = m_networkManager->post(request, data);
     setupRequestTimeout(reply);
+
+    // Categories are decoded from data.directoriesWithTags.edges[] as they arrive
+    StreamingArrayReader::attach(reply, {"data", "directoriesWithTags", "edges"},
+        [this](const QVector<QByteArray> &elements, const QByteArray &skeleton, bool last)
+                -> std::function<void()> {
+            QVector<CategoryInfo> categories = ResponseParser::gqlDirectoryEdges(elements);
+            QString failure = last ? ResponseParser::gqlDirectoriesSkeletonError(skeleton) : QString();
+
+            return [this, categories, failure, last]() {
+                if (!failure.isEmpty()) {
+                    WARN_STREAM(failure);
+                    emit error(failure);
+                    return;
+                }
+                if (last && m_netStatusManager) {
+                    m_netStatusManager->reportSuccess();
+                }
+                emit topCategoriesReceived(categories, last);
+            };
+        }, this);
+
     connect(reply, &QNetworkReply::finished, this, &TwitchStreamFetcher::onTopCategoriesReceived);
 }
 
@@ -790,6 +836,9 @@ void TwitchStreamFetcher::onTopCategoriesReceived()
     reply->deleteLater();
     
     if (reply->error() != QNetworkReply::NoError) {
+        if (StreamingArrayReader *reader = StreamingArrayReader::of(reply)) {
+            reader->abort();
+        }
         if (m_netStatusManager) {
             NetworkManager::ErrorType errorType = m_netStatusManager->classifyError(reply);
             QString errorMsg = m_netStatusManager->getErrorMessage(reply);
@@ -819,133 +868,81 @@ void TwitchStreamFetcher::onTopCategoriesReceived()
         return;
     }
     
-    QByteArray responseData = reply->readAll();
-    
-    QJsonDocument doc = QJsonDocument::fromJson(responseData);
-    
-    if (doc.isNull() || !doc.isObject()) {
-        emit error("Invalid JSON response for categories");
-        return;
+    // Rows were decoded while the body arrived, flush the rest
+    if (StreamingArrayReader *reader = StreamingArrayReader::of(reply)) {
+        reader->finish();
     }
-    
-    QJsonObject root = doc.object();
-    
-    // Check for errors
-    if (root.contains("errors")) {
-        QJsonArray errors = root["errors"].toArray();
-        if (!errors.isEmpty()) {
-            QString errorMsg = errors[0].toObject()["message"].toString();
-            WARN_STREAM("GraphQL error:" << errorMsg);
-            emit error("Categories error: " + errorMsg);
-            return;
-        }
-    }
-    
-    // Parse response: data.directoriesWithTags.edges[].node
-    QJsonObject data = root["data"].toObject();
-    QJsonObject directoriesWithTags = data["directoriesWithTags"].toObject();
-    QJsonArray edges = directoriesWithTags["edges"].toArray();
-    
-    if (edges.isEmpty()) {
-        emit topCategoriesReceived(QJsonArray());
-        return;
-    }
-    
-    // Extract node objects (the actual categories)
-    QJsonArray categories;
-    for (const QJsonValue &edgeValue : edges) {
-        QJsonObject edge = edgeValue.toObject();
-        QJsonObject node = edge["node"].toObject();
-        
-        if (!node.isEmpty()) {
-            // Transform to simpler format for QML
-            QJsonObject category;
-            category["id"] = node["id"];
-            category["name"] = node["displayName"];
-            category["boxArtUrl"] = node["avatarURL"];
-            category["viewersCount"] = node["viewersCount"];
-            
-            // Extract tags (optional)
-            QJsonArray tagsArray = node["tags"].toArray();
-            QJsonArray tagNames;
-            for (const QJsonValue &tagValue : tagsArray) {
-                QJsonObject tag = tagValue.toObject();
-                if (!tag["isLanguageTag"].toBool()) {
-                    tagNames.append(tag["localizedName"]);
-                }
-            }
-            category["tags"] = tagNames;
-            
-            categories.append(category);
-        }
-    }
-
-    // Report successful network request
-    if (m_netStatusManager) {
-        m_netStatusManager->reportSuccess();
-    }
-
-    emit topCategoriesReceived(categories);
 }
 
 // ========================================
 // Streams for Game (GraphQL - Anonymous)
 // ========================================
 
-void TwitchStreamFetcher::fetchStreamsForGameGraphQL(const QString &gameId, int limit)
+void TwitchStreamFetcher::fetchStreamsForGameGraphQL(const QString &gameId, int limit, int generation)
 {
 
     // Clamp limit
     if (limit > 100) limit = 100;
     if (limit < 1) limit = 1;
 
-    requestStreamsForGame(gameId, limit);
+    requestStreamsForGame(gameId, limit, QString(), generation);
 }
 
-void TwitchStreamFetcher::requestStreamsForGame(const QString &gameId, int limit)
+void TwitchStreamFetcher::fetchStreamsForGameGraphQLWithCursor(const QString &gameId, int limit,
+                                                               const QString &cursor, int generation)
 {
-    QUrl url(TWITCH_GQL_URL);
-    QNetworkRequest request(url);
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
+    // Clamp limit
+    if (limit > 100) limit = 100;
+    if (limit < 1) limit = 1;
 
-    // CRITICAL: Use public Client-ID, NO auth token (anonymous)
-    request.setRawHeader("Client-ID", Config::TWITCH_PUBLIC_CLIENT_ID.toUtf8());
+    requestStreamsForGame(gameId, limit, cursor, generation);
+}
 
-    // Build GraphQL query for streams by game ID
-    // Using a direct query since we don't have the persisted query hash
-    QString query = QString(
-        "query { "
-        "  game(id: \"%1\") { "
-        "    id "
-        "    name "
-        "    streams(first: %2) { "
-        "      edges { "
-        "        node { "
-        "          id "
-        "          title "
-        "          viewersCount "
-        "          previewImageURL(width: 440, height: 248) "
-        "          broadcaster { "
-        "            id "
-        "            login "
-        "            displayName "
-        "          } "
-        "        } "
-        "      } "
-        "    } "
-        "  } "
-        "}"
-    ).arg(gameId).arg(limit);
-
-    QJsonObject payload;
-    payload["query"] = query;
-
-    QJsonDocument doc(payload);
-    QByteArray data = doc.toJson(QJsonDocument::Compact);
+void TwitchStreamFetcher::requestStreamsForGame(const QString &gameId, int limit, const QString &cursor,
+                                                int generation)
+{
+    // CRITICAL: Use public Client-ID, NO auth token (anonymous)
+    QNetworkRequest request = GqlOperations::anonymousRequest();
+
+    // Build GraphQL query for streams by game ID (constant document,
+    // the id, limit and cursor go in as variables)
+    QByteArray data = GqlOperations::payload(GqlOperations::GameStreams, {
+        GqlOperations::string(gameId),
+        GqlOperations::number(limit),
+        GqlOperations::optionalString(cursor)
+    });
 
 
     QNetworkReply *reply = m_networkManager->post(request, data);
     setupRequestTimeout(reply);
+
+    // Streams are decoded from data.game.streams.edges[] as they arrive.
+    // Batches decode one after another, so the last edge cursor can be
+    // carried over between them.
+    QSharedPointer<QString> edgeCursor = QSharedPointer<QString>::create();
+
+    StreamingArrayReader::attach(reply, {"data", "game", "streams", "edges"},
+        [this, edgeCursor, gameId, generation](const QVector<QByteArray> &elements,
+                                               const QByteArray &skeleton, bool last)
+                -> std::function<void()> {
+            QVector<StreamInfo> streams = ResponseParser::gqlStreamEdges(elements, edgeCursor.data());
+            QString failure = last ? ResponseParser::gqlGameStreamsSkeletonError(skeleton) : QString();
+            QString cursor = last && ResponseParser::gqlGameStreamsHasNextPage(skeleton)
+                             ? *edgeCursor : QString();
+
+            return [this, streams, cursor, failure, last, gameId, generation]() {
+                if (!failure.isEmpty()) {
+                    WARN_STREAM(failure);
+                    emit error(failure);
+                    return;
+                }
+                if (last && m_netStatusManager) {
+                    m_netStatusManager->reportSuccess();
+                }
+                emit streamsForGameReceived(streams, cursor, last, gameId, generation);
+            };
+        }, this);
+
     connect(reply, &QNetworkReply::finished, this, &TwitchStreamFetcher::onStreamsForGameReceived);
 }
 
@@ -957,6 +954,9 @@ void TwitchStreamFetcher::onStreamsForGameReceived()
     reply->deleteLater();
 
     if (reply->error() != QNetworkReply::NoError) {
+        if (StreamingArrayReader *reader = StreamingArrayReader::of(reply)) {
+            reader->abort();
+        }
         if (m_netStatusManager) {
             NetworkManager::ErrorType errorType = m_netStatusManager->classifyError(reply);
             QString errorMsg = m_netStatusManager->getErrorMessage(reply);
@@ -986,67 +986,10 @@ void TwitchStreamFetcher::onStreamsForGameReceived()
         return;
     }
 
-    QByteArray responseData = reply->readAll();
-
-    QJsonDocument doc = QJsonDocument::fromJson(responseData);
-
-    if (doc.isNull() || !doc.isObject()) {
-        emit error("Invalid JSON response for streams");
-        return;
+    // Rows were decoded while the body arrived, flush the rest
+    if (StreamingArrayReader *reader = StreamingArrayReader::of(reply)) {
+        reader->finish();
     }
-
-    QJsonObject root = doc.object();
-
-    // Check for errors
-    if (root.contains("errors")) {
-        QJsonArray errors = root["errors"].toArray();
-        if (!errors.isEmpty()) {
-            QString errorMsg = errors[0].toObject()["message"].toString();
-            WARN_STREAM("GraphQL error:" << errorMsg);
-            emit error("Failed to fetch streams: " + errorMsg);
-            return;
-        }
-    }
-
-    // Navigate to game -> streams -> edges
-    QJsonObject data = root["data"].toObject();
-    QJsonObject game = data["game"].toObject();
-
-    if (game.isEmpty()) {
-        WARN_STREAM("Game not found or has no data");
-        emit error("Game not found");
-        return;
-    }
-
-    QJsonObject streams = game["streams"].toObject();
-    QJsonArray edges = streams["edges"].toArray();
-
-    // Report successful network request
-    if (m_netStatusManager) {
-        m_netStatusManager->reportSuccess();
-    }
-
-    // Transform edges to simpler format compatible with Helix API format
-    QJsonArray streamsList;
-    for (const QJsonValue &edgeValue : edges) {
-        QJsonObject edge = edgeValue.toObject();
-        QJsonObject node = edge["node"].toObject();
-        QJsonObject broadcaster = node["broadcaster"].toObject();
-
-        // Create stream object in Helix-compatible format
-        QJsonObject stream;
-        stream["id"] = node["id"];
-        stream["user_id"] = broadcaster["id"];
-        stream["user_login"] = broadcaster["login"];
-        stream["user_name"] = broadcaster["displayName"];
-        stream["title"] = node["title"];
-        stream["viewer_count"] = node["viewersCount"];
-        stream["thumbnail_url"] = node["previewImageURL"];
-
-        streamsList.append(stream);
-    }
-
-    emit streamsForGameReceived(streamsList);
 }
 
 // ========================================
@@ -1077,20 +1020,7 @@ void TwitchStreamFetcher::requestUserInfo()
     request.setRawHeader("Authorization", QString("OAuth %1").arg(m_graphQLToken).toUtf8());
     
     // Build GraphQL query for UserMenuCurrentUser (just to get ID)
-    QJsonObject persistedQuery;
-    persistedQuery["version"] = 1;
-    persistedQuery["sha256Hash"] = PERSISTED_QUERY_HASH_USER;
-    
-    QJsonObject extensions;
-    extensions["persistedQuery"] = persistedQuery;
-    
-    QJsonObject payload;
-    payload["operationName"] = "UserMenuCurrentUser";
-    payload["variables"] = QJsonObject();
-    payload["extensions"] = extensions;
-    
-    QJsonDocument doc(payload);
-    QByteArray data = doc.toJson(QJsonDocument::Compact);
+    QByteArray data = GqlOperations::payload(GqlOperations::UserMenuCurrentUser);
     
     
     QNetworkReply *reply = m_networkManager->post(request, data);
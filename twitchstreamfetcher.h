@@ -30,6 +30,9 @@
  #include <QSettings>
  #include <QTimer>
  #include <QMap>
+ #include "src/player/hlsplaylist.h"
+ #include "src/player/codecsupport.h"
+ #include "src/models/streaminfo.h"
  
  // Forward declaration
  class TwitchAuthManager;
@@ -68,11 +71,18 @@
  
      // Main method to fetch stream URL
      Q_INVOKABLE void fetchStreamUrl(const QString &channelName, const QString &quality = "best");
+
+     // Resolve a VOD (past broadcast) to a variant playlist URL
+     Q_INVOKABLE void fetchVodUrl(const QString &vodId, const QString &quality = "best");
  
      // Get available qualities from last fetched playlist
      Q_INVOKABLE QStringList getAvailableQualities() const { return m_availableQualities; }
      Q_INVOKABLE QString getQualityUrl(const QString &quality) const;
 
+     // Smallest quality that still covers a surface of the given pixel size
+     // (used by the mini player to stop downloading more than it can show)
+     Q_INVOKABLE QString getQualityForSize(int width, int height) const;
+
      // GraphQL Token Management
      Q_INVOKABLE void setGraphQLToken(const QString &token);
      Q_INVOKABLE void clearGraphQLToken();
@@ -86,7 +96,11 @@
      Q_INVOKABLE void fetchTopCategoriesGraphQL(int limit = 30);
 
      // Fetch streams for a specific game/category using GraphQL (anonymous, no auth required)
-     Q_INVOKABLE void fetchStreamsForGameGraphQL(const QString &gameId, int limit = 20);
+     Q_INVOKABLE void fetchStreamsForGameGraphQL(const QString &gameId, int limit = 20, int generation = 0);
+
+     // Next page of the above; 'cursor' from streamsForGameReceived
+     Q_INVOKABLE void fetchStreamsForGameGraphQLWithCursor(const QString &gameId, int limit, const QString &cursor,
+                                                           int generation = 0);
 
      // User Info property getters
      QString currentUserId() const { return m_currentUserId; }
@@ -113,6 +127,9 @@
  signals:
      // Emitted when stream URL is ready
      void streamUrlReady(const QString &url, const QString &channelName);
+
+     // Emitted when a VOD variant playlist URL is ready
+     void vodUrlReady(const QString &url, const QString &vodId);
      
      // Emitted when available qualities are ready
      void availableQualitiesChanged(const QStringList &qualities);
@@ -139,11 +156,16 @@
      void tokenValidationSuccess(const QString &message);
      void tokenValidationFailed(const QString &message);
  
-     // Emitted when top categories are received (GraphQL)
-     void topCategoriesReceived(const QJsonArray &categories);
+     // Emitted per batch while top categories arrive (GraphQL);
+     // 'complete' marks the last batch
+     void topCategoriesReceived(const QVector<CategoryInfo> &categories, bool complete);
 
-     // Emitted when streams for a game are received (GraphQL)
-     void streamsForGameReceived(const QJsonArray &streams);
+     // Emitted per batch while streams for a game arrive (GraphQL). Same
+     // contract as TwitchHelixAPI::streamsPaginationReceived: 'cursor' is
+     // set on the last batch if there is a next page, gameId and
+     // generation are passed back from the request
+     void streamsForGameReceived(const QVector<StreamInfo> &streams, const QString &cursor, bool complete,
+                                 const QString &gameId, int generation);
  
  private slots:
      // Handle GraphQL response
@@ -186,12 +208,18 @@
 
      // Current request data
      QString m_currentChannel;
+     QString m_currentVodId;   // Set while resolving a VOD instead of a live channel
      QString m_requestedQuality;
      bool m_isValidatingToken;
      
      // Quality caching (from last M3U8 playlist)
      QMap<QString, QString> m_qualityUrls;  // quality name -> URL
      QStringList m_availableQualities;      // ordered list
+     QMap<QString, HlsVariant> m_qualityVariants; // quality name -> resolution/bandwidth
+     
+     // Decoder capabilities (probed on first playlist request)
+     CodecSupport m_codecSupport;
+     bool m_codecsDetected;
      
      // Current user info
      QString m_currentUserId;
@@ -220,9 +248,7 @@
      static const QString TWITCH_GQL_URL;
      static const QString TWITCH_INTEGRITY_URL;
      static const QString TWITCH_USHER_URL;
-     static const QString PERSISTED_QUERY_HASH;
-     static const QString PERSISTED_QUERY_HASH_USER;
-     static const QString PERSISTED_QUERY_HASH_CATEGORIES;
+     static const QString TWITCH_USHER_VOD_URL;
      
      // Helper methods
      void requestPlaybackToken(const QString &channelName, bool withIntegrity = false);
@@ -231,8 +257,9 @@
      void requestUserInfo();
      void requestUserDetails(const QString &userId);
      void requestTopCategories(int limit);
-     void requestStreamsForGame(const QString &gameId, int limit);
+     void requestStreamsForGame(const QString &gameId, int limit, const QString &cursor, int generation);
      QString parseM3U8Playlist(const QString &m3u8Content, const QString &quality);
+     static QString qualityName(const HlsVariant &variant);
      void parseDebugInfo(const QString &tokenValue);
      
      // Client-Integrity helpers